@@ -18,6 +18,8 @@
 #include "USB_Receive.h"
 #include "USB_Transmit.h"
 #include "rgb_led_driver.h"
+#include "lz4_stream.h"
+#include "delta_stream.h"
 
 extern RTC_HandleTypeDef hrtc;
 
@@ -25,7 +27,35 @@ extern RTC_HandleTypeDef hrtc;
  * Flash / Memory Configuration
  * ========================================================= */
 
+/*
+ * Bank swap boot (isteğe bağlı): uygulama her zaman SLOT_A adresine linklenir.
+ * Güncelleme diğer bankta aynı offset'e (SLOT_B) yazılır; commit ve geri dönüş
+ * FLASH_OPTR.SWAP_BANK'ı değiştirir, reset sonrası yeni imaj SLOT_A adresinde
+ * görünür. Bootloader ve metadata iki bankta da aynı offset'te tutulur, bu
+ * yüzden slotlar metadata alanının önünde biter.
+ */
+#ifndef BL_BANK_SWAP_BOOT
+#define BL_BANK_SWAP_BOOT		 0
+#endif
+
+#define BL_BOOTLOADER_SIZE		 (0x00040000UL)		// Her bankın ilk 256 KB'ı
+#define BL_FLASH_BANK_SIZE		 (0x00200000UL)
+
 #define BL_APP_BASE_ADDRESS      (0x08040000UL)
+
+#if (BL_BANK_SWAP_BOOT == 1)
+
+#define BL_APP_SLOT2_ADDRESS     (BL_APP_BASE_ADDRESS + BL_FLASH_BANK_SIZE)
+#define BL_APP_MAX_SIZE			 1572864
+
+#define SLOT_A_BASE_ADDR     	 0x08040000UL
+#define SLOT_A_END_ADDR      	 0x081BFFFFUL
+
+#define SLOT_B_BASE_ADDR     	 0x08240000UL
+#define SLOT_B_END_ADDR      	 0x083BFFFFUL
+
+#else
+
 #define BL_APP_SLOT2_ADDRESS     (0x08200000UL)
 #define BL_APP_MAX_SIZE			 1792000
 
@@ -35,6 +65,10 @@ extern RTC_HandleTypeDef hrtc;
 #define SLOT_B_BASE_ADDR     	 0x08200000UL
 #define SLOT_B_END_ADDR      	 0x083BFFFFUL
 
+#endif
+
+#define BL_SLOT_SIZE			 (SLOT_A_END_ADDR - SLOT_A_BASE_ADDR + 1UL)
+
 #define _FLASH_PAGE_SIZE      	 (8 * 1024UL)   // 8 KB
 
 #define BL_SRAM_BASE             (0x20000000UL)
@@ -44,10 +78,49 @@ extern RTC_HandleTypeDef hrtc;
 /* Boot decision window (ms) */
 #define BL_BOOT_WINDOW_MS        (3000U)
 
-#define BL_PACKET_SIZE			 (1036U)
+/* SEND_PACKET verisi: adres (4) + uzunluk (4) + blok + CRC32 (4) */
+#define BL_PACKET_OVERHEAD		 (12U)
+#define BL_PACKET_SIZE			 (BL_UPDATE_CHUNK_SIZE_MAX + BL_PACKET_OVERHEAD)
+
+/* Uzunluk alanındaki bayraklardan biri set ise blok veri taşımaz, N byte'lık bir aralığı tarif eder:
+ *   SPARSE: adresten itibaren N byte 0xFF
+ *   COPY  : aktif slottaki aynı offset'ten N byte (değişmemiş sayfalar)
+ * Paket yalnızca adres (4) + uzunluk (4) + CRC32 (4, ilk 8 byte üzerinden) içerir */
+#define BL_PACKET_SPARSE_FLAG	 (0x80000000UL)
+#define BL_PACKET_COPY_FLAG		 (0x40000000UL)
+#define BL_PACKET_RUN_FLAGS		 (BL_PACKET_SPARSE_FLAG | BL_PACKET_COPY_FLAG)
+
+/* PAGE_MANIFEST cevabı: ilk sayfa (2) + adet (1) + adet x CRC32 (4), tek mesaja sığan sayfa sayısı */
+#define BL_MANIFEST_PAGES_PER_MSG (8U)
 
 #define BL_FLASH_WRITE_RETRY_COUNT (3U)
 
+/* Transfer block size: host proposes one in PACKET_INFO, bootloader clamps it */
+#define BL_UPDATE_CHUNK_SIZE		(1024U)						// Host blok boyutu önermezse
+#define BL_UPDATE_CHUNK_SIZE_MIN	(256U)
+#define BL_UPDATE_CHUNK_SIZE_MAX	(_FLASH_PAGE_SIZE)
+#define BL_UPDATE_CHUNK_ALIGN		(16U)						// Flash quad-word programlama birimi
+
+/* Sliding-window transfer: number of GET_PACKET requests kept in flight */
+#define BL_UPDATE_WINDOW_MAX		(8U)
+#define BL_UPDATE_WINDOW_TIMEOUT_MS	(500U)
+#define BL_UPDATE_REQUEST_RETRY_MAX	(4U)
+
+/* PACKET_INFO pencere byte'ında set ise push modu: host blokları GET_PACKET beklemeden
+ * sırayla gönderir, bootloader yalnızca bozuk blokları NAK'lar ve ilerlemeyi bildirir */
+#define BL_UPDATE_WINDOW_PUSH_FLAG	(0x80U)
+
+/* Kesintiye dayanıklı güncelleme: bu kadar byte yazıldıkça ilerleme metadata'ya kaydedilir */
+#define BL_RESUME_CHECKPOINT_BYTES	(64UL * 1024UL)
+
+/* Tembel silme: boşta kalınan turlarda yazma noktasının bu kadar sayfa ilerisi önceden silinir */
+#define BL_ERASE_AHEAD_PAGES		(2U)
+
+/* 1: programlanan her blok flash'tan geri okunup kaynak tamponla karşılaştırılır (imaj CRC'sinden ayrı kontrol) */
+#ifndef BL_READBACK_VERIFY
+#define BL_READBACK_VERIFY			0
+#endif
+
 #define USB_MSG_BL_SLOT_NONE   	(0x00)
 #define USB_MSG_BL_SLOT_A     	(0x01)
 #define USB_MSG_BL_SLOT_B      	(0x02)
@@ -109,13 +182,16 @@ typedef enum
     BL_ERR_FLASH_WRITE,
 	BL_ERR_APP_CRC,
     BL_ERR_TIMEOUT,
+    BL_ERR_DECOMPRESS,
     BL_ERR_UNKNOWN
 } bl_error_t;
 
 typedef enum
 {
     BL_FW_FORMAT_BIN = 0,
-    BL_FW_FORMAT_HEX = 1
+    BL_FW_FORMAT_HEX = 1,
+    BL_FW_FORMAT_LZ4 = 2,		/* Tek LZ4 block olarak sıkıştırılmış BIN, yazarken açılır */
+    BL_FW_FORMAT_DELTA = 3		/* Aktif slot imajına karşı patch akışı (delta_stream.h) */
 } bl_fw_format_t;
 
 /* =========================================================
@@ -130,10 +206,14 @@ typedef struct
 
 typedef struct
 {
-    uint32_t 			fw_size_bytes;     // Toplam firmware boyutu
-    uint32_t 			fw_crc32;          // Tüm dosyanın CRC32
-    bl_fw_format_t  	fw_format;         // 0=BIN, 1=HEX
+    uint32_t 			fw_size_bytes;     // Transfer edilen toplam boyut (LZ4'te sıkıştırılmış)
+    uint32_t 			fw_crc32;          // Flash'a yazılan imajın CRC32
+    bl_fw_format_t  	fw_format;         // 0=BIN, 1=HEX, 2=LZ4, 3=DELTA
+    uint32_t			image_size_bytes;  // Flash'a yazılan imaj boyutu (BIN'de fw_size_bytes)
+    uint32_t			base_crc32;        // DELTA: patch'in üretildiği aktif slot imajının CRC32'si
     bl_fw_version_t		fw_version;        // opsiyonel
+    uint32_t			chunk_size;        // Host ile anlaşılan transfer blok boyutu
+    bool				push_mode;         // Host blokları talep beklemeden gönderir
 } bl_update_info_t;
 
 typedef struct
@@ -144,24 +224,131 @@ typedef struct
 	uint32_t			remainingDataLength;
 }bl_update_request_packet_info_t;
 
+typedef enum
+{
+	BL_PACKET_KIND_DATA = 0,		// Veri bloğu
+	BL_PACKET_KIND_ERASED,			// N byte 0xFF, hedef slot zaten silinmiş
+	BL_PACKET_KIND_COPY				// N byte aktif slottaki aynı offset'ten kopyalanır
+}bl_packet_kind_t;
+
 typedef struct
 {
-	uint8_t 			packetBuff[BL_PACKET_SIZE];
+	const uint8_t 		*packetData;		// RX frame buffer içindeki veri (kopyasız görünüm)
 	uint32_t			packetAddr;
 	uint16_t			packetLen;
 	uint32_t			packetCRC;
+	bl_packet_kind_t	packetKind;
+	uint32_t			runLen;				// ERASED/COPY: aralığın henüz yazılmamış byte sayısı
 
 	crc_status_t		crcStatus;
 	uint8_t				requestCounter;
 }bl_update_packet_t;
 
+typedef enum
+{
+	BL_WINDOW_SLOT_FREE = 0,		// Slot boş, yeni bir offset talep edilebilir
+	BL_WINDOW_SLOT_REQUESTED,		// GET_PACKET gönderildi, veri bekleniyor
+	BL_WINDOW_SLOT_RECEIVED			// Veri alındı ve CRC doğrulandı, flash'a yazılmayı bekliyor
+}bl_window_slot_state_t;
+
+typedef struct
+{
+	bl_window_slot_state_t	state;
+	uint32_t				offset;
+	uint32_t				length;
+	uint32_t				requestTick;
+	bl_update_packet_t		packet;
+	USBRxFrameView_t		frame;			// Flash'a yazılana kadar tutulan RX frame
+}bl_window_slot_t;
+
+typedef struct
+{
+	uint8_t					depth;					// Aynı anda bekleyen paket talebi sayısı (1 = stop-and-wait)
+	uint8_t					activeSlot;				// RECEIVE_DATA -> VERIFY arasında işlenen slot
+	uint32_t				nextRequestOffset;		// Henüz talep edilmemiş ilk offset
+	uint32_t				commitOffset;			// Bu offset'e kadar olan veri flash'a yazıldı (ya da programlanıyor)
+	bool					programPending;			// Flash motoru tampondaki sayfayı programlıyor
+	uint32_t				reportedOffset;			// Push modunda host'a en son bildirilen commitOffset
+	bool					finalCrcBusy;			// FINISH: imaj CRC'si CRC biriminde (DMA) hesaplanıyor
+	uint32_t				finalCrcStartTick;		// FINISH: imaj CRC kontrolünün başladığı an
+	bool					verifyPending;			// VERIFY cevabı TX kuyruğuna sığmadı, sonraki turda tekrar
+	uint8_t					verifyReplyLen;
+	uint8_t					verifyReply[5];			// CRC durumu | offset (4, BE)
+	bl_update_state_t		verifyNextState;		// Cevap gönderilince geçilecek durum
+	bl_window_slot_t		slot[BL_UPDATE_WINDOW_MAX];
+}bl_update_window_t;
+
+/*
+ * Transfer ölçümleri: protokol değişikliklerinin etkisi debugger / canlı izleme
+ * ile donanım üzerinde ölçülebilsin diye tutulur. CHECK_INFO'da sıfırlanır.
+ */
+typedef struct
+{
+	uint32_t				infoTick;				// PACKET_INFO kabul edildiği an
+	uint32_t				firstPacketTick;		// İlk SEND_PACKET alındığı an
+	uint32_t				lastCommitTick;			// Son bloğun flash'a yazıldığı an
+	uint32_t				requestsSent;			// Gönderilen GET_PACKET sayısı (tekrarlar dahil)
+	uint32_t				retransmits;			// Zaman aşımı sonrası tekrar talepleri
+	uint32_t				packetsReceived;		// Bir slotla eşleşen SEND_PACKET sayısı
+	uint32_t				crcErrors;				// CRC32 tutmayan paket sayısı
+	uint32_t				bytesCommitted;			// Flash'a yazılan toplam transfer byte'ı
+	uint32_t				flashWriteMs;			// WRITE_FLASH içinde geçen toplam süre
+	uint32_t				finalCrcMs;				// FINISH'teki imaj CRC kontrolünün süresi
+}bl_update_stats_t;
+
+/*
+ * Yarım kalan BIN transferinin devam bilgisi. ERASE_TARGET'ta metadata'dan yüklenir,
+ * transfer sırasında periyodik olarak metadata'ya yazılır (progress_bytes / progress_crc32).
+ */
+typedef struct
+{
+	uint32_t				offset;					// Host'a bildirilen devam offset'i (sayfa hizalı), 0 = baştan
+	uint32_t				fwSize;					// Yarım kalan imajın boyutu
+	uint32_t				fwCrc;					// Yarım kalan imajın CRC32'si
+	uint32_t				checkpointOffset;		// Metadata'ya en son yazılan ilerleme
+	uint32_t				checkpointCrc;			// Hedef slotun [0, checkpointOffset) CRC32'si
+	bool					enabled;				// Bu transferde checkpoint alınıyor mu (yalnızca BIN)
+}bl_update_resume_t;
+
+/*
+ * Hedef slota verilen imajın CRC32'si, veri flash'a verildikçe imaj sırasıyla ilerletilir
+ * (BIN: paket CRC'leri birleştirilir, LZ4/DELTA: açılan sayfalar, COPY/ERASED: kopyalanan / 0xFF).
+ * FINISH yalnızca karşılaştırma yapar; sıra bozulursa imaj flash'tan hesaplanır.
+ */
+typedef struct
+{
+	uint32_t				crc;					// İmajın [0, offset) CRC32'si
+	uint32_t				offset;					// Digest'e eklenen imaj byte sayısı
+	bool					valid;					// false: FINISH'te imaj flash'tan geri okunur
+	crc32_combine_t			chunkShift;				// chunk_size byte'lık CRC birleştirme operatörü
+}bl_image_digest_t;
+
 typedef struct
 {
 	bl_slot_t g_target_slot;
 	uint32_t  g_target_base_addr;
 	uint32_t  g_target_end_addr;
+	uint32_t  erasedOffset;			// Bu güncellemede [0, erasedOffset) sayfaları silindi
+	uint32_t  writeOffset;			// En son programlanan byte'ın sonu (ileri silme referansı)
+	const uint8_t *verifyData;		// BL_READBACK_VERIFY: kesmeyle programlanan, henüz geri okunmamış blok
+	uint32_t  verifyOffset;
+	uint32_t  verifyLength;
 }bl_target_info_t;
 
+/*
+ * BIN yazma tamponu: bloklar boyutlarından bağımsız olarak sayfa içindeki
+ * yerlerine birleştirilir; sayfa dolunca ya da imaj / aralık başlayınca
+ * tampondaki kısım tek seferde (burst) programlanır. İki tampon: bir blok
+ * sayfa sınırını geçerse biri programlanırken diğeri doldurulur.
+ */
+typedef struct
+{
+	uint32_t				bufOffset;				// Doldurulan tampondaki ilk byte'ın slot offset'i (quad-word hizalı)
+	uint32_t				bufFill;				// Doldurulan tampondaki geçerli byte sayısı
+	uint8_t					fillIndex;				// Doldurulan tampon; diğeri flash motorunda programlanıyor olabilir
+	uint8_t					page[2][_FLASH_PAGE_SIZE] __attribute__((aligned(16)));
+}bl_bin_stream_t;
+
 typedef struct
 {
     /* --- Core state --- */
@@ -172,10 +359,15 @@ typedef struct
 
     uint32_t     					tick_start;
     uint32_t     					boot_elapsed_ms;
+    uint32_t     					jump_tick;				// BL_STATE_JUMP'a girilen an (0: henüz girilmedi)
+    bool         					jump_notify_pending;	// JUMPING_APPLICATION henüz TX kuyruğuna verilmedi
 
     /* --- Update flags --- */
     bool         					update_requested;
     bool         					update_in_progress;
+    bool         					bank_swap_pending;		// BL_STATE_JUMP'ta atlamak yerine SWAP_BANK değiştirilir
+    bool         					manifest_pending;		// PAGE_MANIFEST cevabı TX kuyruğuna sığmadı, tekrar denenecek
+    uint8_t      					manifest_request[3];	// Bekleyen PAGE_MANIFEST isteği: ilk sayfa (2, BE) | adet (1)
 
     /* --- Application info --- */
     uint32_t     					app_base;
@@ -184,8 +376,17 @@ typedef struct
     /* --- Firmware transfer  --- */
     bl_update_info_t 				update_info;
     bl_update_request_packet_info_t	update_packet_info;
-    bl_update_packet_t				update_packet;
+    bl_update_window_t				update_window;
+    bl_update_stats_t				update_stats;
+    bl_update_resume_t				update_resume;
+    bl_image_digest_t				image_digest;
     bl_target_info_t				update_target_info;
+    union
+    {
+    	lz4_stream_t				lz4;
+    	delta_stream_t				delta;
+    	bl_bin_stream_t				bin;
+    }								update_stream;			// LZ4/DELTA açma durumu / BIN yazma tamponu
 
     /* --- Debug / diagnostics --- */
     uint32_t     					last_event;
@@ -16,7 +16,7 @@
 /* =========================================================
  * Global Variables
  * ========================================================= */
-USBCommParameters_t usbCommParameters;
+USBRxFrameView_t	usbRxFrame;
 
 /* =========================================================
  * External Variables
@@ -36,7 +36,6 @@ typedef void (*pFunction)(void);
 /* =========================================================
  * Local Function Prototypes
  * ========================================================= */
-extern volatile USB_RxDebug_t g_usb_rx_debug;
 /**
  * @brief Validate application vector table sanity
  *
@@ -46,6 +45,16 @@ extern volatile USB_RxDebug_t g_usb_rx_debug;
  */
 static bool BL_IsVectorTableSane(uint32_t appBase);
 
+/**
+ * @brief Check the application image against the CRC32 recorded in metadata
+ *
+ * @param[in] ctx      Bootloader context pointer
+ * @param[in] appBase  Application flash base address
+ * @return true  CRC matches, or the slot has no size / CRC record
+ * @return false Image CRC mismatch
+ */
+static bool BL_IsImageCrcValid(const BootloaderCtx_t *ctx, uint32_t appBase);
+
 /**
  * @brief Perform low-level jump to application
  *
@@ -62,6 +71,483 @@ static void BL_Jump(uint32_t appBase);
  */
 static bool BL_CheckUpdateRequest(BootloaderCtx_t *ctx);
 
+/**
+ * @brief Check whether an unprocessed RX frame must be kept for RECEIVE_DATA
+ *
+ * @param[in] ctx  Bootloader context pointer
+ * @return true  Frame is kept (RECEIVE_DATA and the transfer states that hand over to it)
+ * @return false Frame can be released
+ */
+static bool BL_IsRxFramePending(const BootloaderCtx_t *ctx);
+
+/**
+ * @brief Clamp the block size proposed by the host to what the bootloader accepts
+ *
+ * @param[in] requested  Block size from PACKET_INFO (0 = not proposed)
+ * @return Agreed block size in bytes
+ */
+static uint32_t BL_NegotiateChunkSize(uint32_t requested);
+
+/**
+ * @brief Reset sliding-window transfer bookkeeping
+ *
+ * @param[out] window  Window structure
+ * @param[in]  depth   Requested number of outstanding packets (0 treated as 1)
+ */
+static void BL_Window_Reset(bl_update_window_t *window, uint8_t depth);
+
+/**
+ * @brief Issue GET_PACKET requests for free and timed-out window slots
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true  Requests issued (or nothing to request)
+ * @return false A slot exceeded its retry limit
+ */
+static bool BL_Window_RequestPackets(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Find the window slot holding a given offset in a given state
+ *
+ * @param[in] window  Window structure
+ * @param[in] offset  Image offset
+ * @param[in] state   Required slot state
+ * @return Slot pointer or NULL
+ */
+static bl_window_slot_t *BL_Window_FindSlot(bl_update_window_t *window,
+                                            uint32_t offset,
+                                            bl_window_slot_state_t state);
+
+/**
+ * @brief Match a received SEND_PACKET payload against outstanding requests
+ *
+ * @param[in] window     Window structure
+ * @param[in] rx         Received payload (addr, len, data, crc)
+ * @param[in] rxLen      Received payload length
+ * @param[in] sparseEnd  Image end a sparse run may reach (0 = sparse not allowed)
+ * @param[in] copyEnd    Image end a copy run may reach (0 = copy not allowed)
+ * @return Slot index, or -1 when the packet does not match a request or its
+ *         length does not equal the length field plus BL_PACKET_OVERHEAD
+ */
+static int8_t BL_Window_MatchPacket(bl_update_window_t *window,
+                                    const uint8_t *rx,
+                                    uint16_t rxLen,
+                                    uint32_t sparseEnd,
+                                    uint32_t copyEnd);
+
+/**
+ * @brief Drop the window requests an accepted run makes obsolete
+ *
+ * @param[in,out] window  Window structure
+ * @param[in]     keep    Slot that owns the run (left untouched)
+ * @param[in]     start   Start of the run
+ * @param[in]     end     End of the run (exclusive)
+ */
+static void BL_Window_SkipRange(bl_update_window_t *window,
+                                const bl_window_slot_t *keep,
+                                uint32_t start,
+                                uint32_t end);
+
+/**
+ * @brief Base address of the slot unchanged pages can be copied from
+ *
+ * @param[in] ctx  Bootloader context pointer
+ * @return Active slot base address, or 0 when it holds no usable image
+ */
+static uint32_t BL_GetSourceBase(const BootloaderCtx_t *ctx);
+
+/**
+ * @brief Answer a PAGE_MANIFEST request with CRC32s of active slot pages
+ *
+ * @param[in] ctx    Bootloader context pointer
+ * @param[in] rx     Request payload: first page (2, BE) | count (1)
+ * @param[in] rxLen  Request payload length
+ * @return true  Reply queued (or request too short to answer)
+ * @return false TX queue full, reply not queued
+ */
+static bool BL_SendPageManifest(const BootloaderCtx_t *ctx, const uint8_t *rx, uint16_t rxLen);
+
+/**
+ * @brief Check whether any outstanding request has timed out
+ *
+ * @param[in] window  Window structure
+ * @return true  At least one request needs to be re-sent
+ */
+static bool BL_Window_IsTimedOut(const bl_update_window_t *window);
+
+/**
+ * @brief Push mode: report the committed offset to the host about twice per window
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Window_ReportProgress(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Program a block to flash, retrying up to BL_FLASH_WRITE_RETRY_COUNT times
+ *
+ * @param[in] address  Flash address (16-byte aligned)
+ * @param[in] data     Source data
+ * @param[in] length   Number of bytes
+ * @return true on success
+ */
+static bool BL_Flash_WriteRetry(uint32_t address, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Erase a page-aligned range of the target slot
+ *
+ * @param[in] ctx     Bootloader context pointer
+ * @param[in] offset  Slot offset of the first page
+ * @param[in] length  Number of bytes (rounded up to whole pages)
+ * @return true on success
+ */
+static bool BL_EraseTargetRange(const BootloaderCtx_t *ctx, uint32_t offset, uint32_t length);
+
+/**
+ * @brief Erase target slot pages up to (and including) the page holding endOffset - 1
+ *
+ * @param[in,out] ctx        Bootloader context pointer
+ * @param[in]     endOffset  Slot offset the next write ends at (exclusive)
+ * @return true on success
+ */
+static bool BL_Target_EnsureErased(BootloaderCtx_t *ctx, uint32_t endOffset);
+
+/**
+ * @brief Program a block into the target slot, erasing its pages first if needed
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Slot offset (16-byte aligned)
+ * @param[in]     data    Source data
+ * @param[in]     length  Number of bytes
+ * @return true on success
+ */
+static bool BL_Target_Write(BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Idle work: erase one page ahead of the write pointer
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Target_EraseAhead(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Queue the erase of target slot pages up to the page holding endOffset - 1
+ *
+ * @param[in,out] ctx        Bootloader context pointer
+ * @param[in]     endOffset  Slot offset the next write ends at (exclusive)
+ * @return true if queued (or nothing to erase)
+ */
+static bool BL_Target_QueueErase(BootloaderCtx_t *ctx, uint32_t endOffset);
+
+/**
+ * @brief Queue a block for interrupt-driven programming into the target slot
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Slot offset (16-byte aligned)
+ * @param[in]     data    Source data, valid until the flash engine is idle
+ * @param[in]     length  Number of bytes
+ * @return true if queued
+ */
+static bool BL_Target_WriteAsync(BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Wait for queued flash jobs before a blocking target access
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return false if a queued erase / program failed (or its readback mismatched)
+ */
+static bool BL_Target_Sync(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Compare a programmed target block with its source buffer
+ *
+ * @param[in] ctx     Bootloader context pointer
+ * @param[in] offset  Slot offset
+ * @param[in] data    Source data
+ * @param[in] length  Number of bytes
+ * @return true if flash holds the source data
+ */
+static bool BL_Target_Readback(const BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Start the running image CRC for a new transfer
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Digest_Reset(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Add image bytes handed to flash to the running image CRC
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Image offset of data (must continue the digest)
+ * @param[in]     data    Image bytes, NULL for an erased (0xFF) run
+ * @param[in]     length  Number of bytes
+ */
+static void BL_Digest_Update(BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length);
+
+/**
+ * @brief Add a verified BIN block to the running image CRC by its packet CRC
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Image offset of the block (must continue the digest)
+ * @param[in]     crc     CRC32 of the block
+ * @param[in]     length  Block length in bytes
+ */
+static void BL_Digest_Append(BootloaderCtx_t *ctx, uint32_t offset, uint32_t crc, uint32_t length);
+
+/**
+ * @brief Load the checkpoint of an interrupted transfer into the target slot
+ *
+ * The checkpoint is used only if the metadata is IN_PROGRESS for the same
+ * target slot and the programmed prefix still matches its CRC32.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return Page-aligned offset the transfer can resume from, 0 to start over
+ */
+static uint32_t BL_Resume_Load(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Start checkpointing for an accepted PACKET_INFO, continuing an interrupted transfer if it matches
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Resume_Begin(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Record the committed offset in metadata once BL_RESUME_CHECKPOINT_BYTES more are written
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Resume_Checkpoint(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Write the checkpoint fields to metadata
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true on success
+ */
+static bool BL_Resume_Save(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Prepare the image decoder for the announced firmware format
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return false when the update cannot be applied (e.g. delta base mismatch)
+ */
+static bool BL_Stream_Init(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Write a committed packet to the target slot according to the firmware format
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Stream_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet);
+
+/**
+ * @brief Complete the image once every packet is committed
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Stream_Finish(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Merge a committed BIN block into the page buffer, programming each page it completes
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Bin_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet);
+
+/**
+ * @brief Queue the buffered part of the current page for programming
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true if queued (or buffer empty)
+ */
+static bool BL_Bin_Flush(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Decompress a committed LZ4 block and program every page it fills
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Lz4_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet);
+
+/**
+ * @brief Check that the LZ4 stream ended cleanly and program the last partial page
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Lz4_Finish(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Check that the active slot holds the image the patch was built against
+ *
+ * @param[in]  ctx         Bootloader context pointer
+ * @param[out] sourceSize  Active image size in bytes
+ * @return Active slot base address, or 0 when the patch cannot be applied
+ */
+static uint32_t BL_Delta_CheckBase(const BootloaderCtx_t *ctx, uint32_t *sourceSize);
+
+/**
+ * @brief Apply a committed patch block and program every page it fills
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Delta_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet);
+
+/**
+ * @brief Check that the patch ended cleanly and program the last partial page
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Delta_Finish(BootloaderCtx_t *ctx);
+
+#if (BL_BANK_SWAP_BOOT == 1)
+/**
+ * @brief Make sure the other bank starts with this bootloader before swapping banks
+ *
+ * @return true if both banks hold the same bootloader
+ */
+static bool BL_BankSwap_MirrorBootloader(void);
+
+/**
+ * @brief Prepare a SWAP_BANK toggle: write the metadata that is valid after the swap
+ *
+ * @param[in,out] ctx        Bootloader context pointer
+ * @param[in,out] meta       Current metadata, turned into the post-swap record
+ * @param[in]     newActive  Image that will appear at SLOT_A after the swap
+ * @return true on success
+ */
+static bool BL_BankSwap_Prepare(BootloaderCtx_t *ctx, meta_record_t *meta, const meta_slot_info_t *newActive);
+#endif
+
+/**
+ * @brief EXIT_BOOTLOADER command (no action defined yet)
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_ExitBootloader(BootloaderCtx_t *ctx);
+
+/**
+ * @brief SHUTDOWN_DEVICE command
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_Shutdown(BootloaderCtx_t *ctx);
+
+/**
+ * @brief GO_APPLICATION command: jump if an application exists, shut down otherwise
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_GoApplication(BootloaderCtx_t *ctx);
+
+/**
+ * @brief RESET_DEVICE command
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_ResetDevice(BootloaderCtx_t *ctx);
+
+/**
+ * @brief UPDATE_STATS command: report the counters of the last transfer
+ *
+ * @param[in] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_ReportStats(BootloaderCtx_t *ctx);
+
+/**
+ * @brief STATUS_REQ command: the host is present, start announcing READY
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_StatusRequest(BootloaderCtx_t *ctx);
+
+/**
+ * @brief PACKET_INFO command: store the image description and check it next
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_PacketInfo(BootloaderCtx_t *ctx);
+
+/**
+ * @brief FLASH_ERASE command: erase both slots and record that no application exists
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_FlashErase(BootloaderCtx_t *ctx);
+
+/**
+ * @brief PAGE_MANIFEST command: reply with the page CRC32s of the active slot
+ *
+ * @param[in] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_PageManifest(BootloaderCtx_t *ctx);
+
+/**
+ * @brief SEND_PACKET command: hand a data packet that matches a request to VERIFY
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_SendPacket(BootloaderCtx_t *ctx);
+
+/**
+ * @brief Run the update command in usbRxFrame if the current update state allows it
+ *
+ * The frame is released afterwards unless the handler kept it.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true  A handler ran
+ * @return false No frame, unknown command or not allowed in this state
+ */
+static bool BL_Update_Dispatch(BootloaderCtx_t *ctx);
+
+/*
+ * Update durumundan bağımsız işlenen firmware update komutları (komut ID -> handler).
+ * Yeni komut için handler buraya kaydedilir; USB_Receive.c komut tablosunda da
+ * USB_RX_CMD_FLAG_FORWARD ile tanımlı olmalıdır.
+ */
+static void (* const blCommandHandlers[USB_RX_COMMAND_ID_COUNT])(BootloaderCtx_t *ctx) =
+{
+	[USB_FIRMWARE_CMD_EXIT_BOOTLOADER]	= BL_Cmd_ExitBootloader,
+	[USB_FIRMWARE_CMD_SHUTDOWN_DEVICE]	= BL_Cmd_Shutdown,
+	[USB_FIRMWARE_CMD_GO_APPLICATION]	= BL_Cmd_GoApplication,
+	[USB_FIRMWARE_CMD_RESET_DEVICE]		= BL_Cmd_ResetDevice,
+	[USB_FIRMWARE_UPDATE_STATS]			= BL_Cmd_ReportStats,
+};
+
+#define BL_UPDATE_STATE_BIT(state)		(1UL << (uint32_t)(state))
+
+typedef struct
+{
+	void 		(*handler)(BootloaderCtx_t *ctx);
+	uint32_t 	allowedStates;						// BL_UPDATE_STATE_BIT maskesi
+}bl_update_command_t;
+
+/*
+ * Update akışının komutları (komut ID -> handler, kabul edildiği update durumları).
+ * BL_UPDATE_IDLE, REQUEST_UPDATE_INFO ve RECEIVE_DATA gelen frame'i BL_Update_Dispatch
+ * ile işler; izin verilmeyen durumda gelen komut yok sayılır.
+ */
+static const bl_update_command_t blUpdateCommands[USB_RX_COMMAND_ID_COUNT] =
+{
+	[USB_FIRMWARE_UPDATE_STATUS_REQ]	= { BL_Cmd_StatusRequest, BL_UPDATE_STATE_BIT(BL_UPDATE_IDLE) },
+	[USB_FIRMWARE_UPDATE_PACKET_INFO]	= { BL_Cmd_PacketInfo,	  BL_UPDATE_STATE_BIT(BL_UPDATE_REQUEST_UPDATE_INFO) },
+	[USB_FIRMWARE_FLASH_ERASE]			= { BL_Cmd_FlashErase,	  BL_UPDATE_STATE_BIT(BL_UPDATE_REQUEST_UPDATE_INFO) },
+	[USB_FIRMWARE_UPDATE_PAGE_MANIFEST]	= { BL_Cmd_PageManifest,  BL_UPDATE_STATE_BIT(BL_UPDATE_REQUEST_UPDATE_INFO) },
+	[USB_FIRMWARE_UPDATE_SEND_PACKET]	= { BL_Cmd_SendPacket,	  BL_UPDATE_STATE_BIT(BL_UPDATE_RECEIVE_DATA) },
+};
+
 /* =========================================================
  * Public Functions
  * ========================================================= */
@@ -78,6 +564,16 @@ void Bootloader_Init(BootloaderCtx_t *ctx)
         return;
     }
 
+    /* =====================================================
+     * FLASH ENGINE INIT
+     * ===================================================== */
+    Flash_Async_Init();
+
+    /* =====================================================
+     * CRC ENGINE INIT
+     * ===================================================== */
+    CRC32_HW_Init();
+
     /* =====================================================
      * META DATA INIT
      * ===================================================== */
@@ -91,9 +587,13 @@ void Bootloader_Init(BootloaderCtx_t *ctx)
 
     ctx->tick_start         			= HAL_GetTick();
     ctx->boot_elapsed_ms    			= 0U;
+    ctx->jump_tick          			= 0U;
+    ctx->jump_notify_pending			= false;
+    ctx->manifest_pending				= false;
 
     ctx->update_requested   			= false;
     ctx->update_in_progress 			= false;
+    ctx->bank_swap_pending  			= false;
 
     //ctx->app_base           			= BL_APP_BASE_ADDRESS;
     if(ctx->meta.active_slot == META_SLOT_B)
@@ -134,41 +634,35 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
     static uint32_t updateInfoTime = 0;
     ctx->boot_elapsed_ms = HAL_GetTick() - ctx->tick_start;
 
-    System_USB_Communication_Receive_Function(&usbCommParameters);
+    /*
+     * Önceki turda işlenmeyen frame havuza geri verilir. Paket talebi / doğrulama /
+     * flash yazma sırasında gelen frame'ler RECEIVE_DATA'ya kadar bekletilir.
+     */
+    if ((usbRxFrame.valid) && (BL_IsRxFramePending(ctx) == false))
+    {
+    	USB_Rx_Release_Frame(&usbRxFrame);
+    }
+
+    if (usbRxFrame.valid == 0)
+    {
+    	System_USB_Communication_Receive_Function(&usbRxFrame);
+    }
+
+    /* USB meşgul olduğu için bekleyen TX mesajları varsa gönderilir */
+    USB_Transmit_Process();
 
     {
     	/*
     	 * USB COMMAND MESSAGE DIRECTION
+    	 * Durumdan bağımsız komutlar: komut ID'si ile tek indeksli tablo araması
     	 */
-    	if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_FIRMWARE_UPDATE &&
-    			usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id == USB_FIRMWARE_CMD_EXIT_BOOTLOADER)
-    	{
-    		// Bootloader dan çıkar...
-    	}
-
-    	if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_FIRMWARE_UPDATE &&
-    			usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id == USB_FIRMWARE_CMD_SHUTDOWN_DEVICE)
-    	{
-    		ctx->state = BL_STATE_SHUTDOWN;
-    	}
-
-    	if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_FIRMWARE_UPDATE &&
-    			usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id == USB_FIRMWARE_CMD_GO_APPLICATION)
+    	if ((usbRxFrame.valid) &&
+    		(usbRxFrame.packet_type == USB_PACKET_FIRMWARE_UPDATE) &&
+    		((uint32_t)usbRxFrame.command_id < USB_RX_COMMAND_ID_COUNT) &&
+    		(blCommandHandlers[usbRxFrame.command_id] != NULL))
     	{
-    		// VARSA Application koduna atlar yoksa cihaz kapanır...
-    		if(ctx->meta.active_slot != META_SLOT_NONE)
-    			ctx->state = BL_STATE_JUMP;
-    		else
-    			ctx->state = BL_STATE_SHUTDOWN;
+    		blCommandHandlers[usbRxFrame.command_id](ctx);
     	}
-
-    	if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_FIRMWARE_UPDATE &&
-    			usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id == USB_FIRMWARE_CMD_RESET_DEVICE)
-    	{
-    		// Cihaza reset atar...
-    		HAL_NVIC_SystemReset();
-    	}
-
     }
 
 	if(abs(ctx->boot_elapsed_ms - updateInfoTime) >= 30000)
@@ -205,15 +699,41 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
         {
             if (ctx->boot_elapsed_ms >= BL_BOOT_WINDOW_MS)
             {
+#if (BL_BANK_SWAP_BOOT == 1)
+                /*
+                 * Aktif bankta geçerli imaj yok, diğer bankta var (Meta_Init slotları değiştirdi):
+                 * SLOT_B adresindeki imaj oradan çalışamaz, geri dönüş tek bir bank swap'tir
+                 */
+                if (ctx->meta.active_slot == META_SLOT_B)
+                {
+                    meta_record_t    meta   = ctx->meta;
+                    meta_slot_info_t backup = ctx->meta.slotB;
+
+                    if (BL_BankSwap_Prepare(ctx, &meta, &backup) == true)
+                    {
+                        ctx->state = BL_STATE_JUMP;
+                        break;
+                    }
+                }
+#endif
                 ctx->app_valid = BL_IsVectorTableSane(ctx->app_base);
 
+                if ((ctx->app_valid == true) && (BL_IsImageCrcValid(ctx, ctx->app_base) != true))
+                {
+                    ctx->app_valid 		= false;
+                    ctx->error 			= BL_ERR_APP_CRC;
+                }
+                else if (ctx->app_valid != true)
+                {
+                    ctx->error 			= BL_ERR_INVALID_VECTOR;
+                }
+
                 if (ctx->app_valid == true)
                 {
                     ctx->state = BL_STATE_JUMP;
                 }
                 else
                 {
-                    ctx->error 			= BL_ERR_INVALID_VECTOR;
                     ctx->state 			= BL_STATE_SELECT_TARGET;
                     ctx->updateState	= BL_UPDATE_IDLE;
             		updateInfoTime 		= HAL_GetTick();
@@ -261,31 +781,16 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
 
         case BL_STATE_ERASE_TARGET:
         {
-            FLASH_EraseInitTypeDef erase_cfg;
-            uint32_t page_error = 0;
-
             uint32_t base_addr = ctx->update_target_info.g_target_base_addr;
-            uint32_t end_addr  = ctx->update_target_info.g_target_end_addr;
-
-            uint32_t start_page = (base_addr - FLASH_BASE) / _FLASH_PAGE_SIZE;
-            uint32_t end_page   = (end_addr  - FLASH_BASE) / _FLASH_PAGE_SIZE;
-
-            erase_cfg.TypeErase = FLASH_TYPEERASE_PAGES;
-            erase_cfg.Banks     = FLASH_BANK_1;   /* Slot A/B bank ayırımı sende zaten var */
-            erase_cfg.Page      = start_page;
-            erase_cfg.NbPages   = (end_page - start_page) + 1U;
-
-            HAL_FLASH_Unlock();
-
-            if (HAL_FLASHEx_Erase(&erase_cfg, &page_error) != HAL_OK)
-            {
-                HAL_FLASH_Lock();
-                ctx->error = BL_ERR_FLASH_WRITE;
-                ctx->state = BL_STATE_ERROR;
-                break;
-            }
 
-            HAL_FLASH_Lock();
+            /*
+             * Slot burada silinmez: imaj boyutu henüz bilinmiyor. Sayfalar yazma noktasının
+             * hemen önünde tek tek silinir (BL_Target_Write / BL_Target_EraseAhead).
+             * Yarım kalan transfer varsa checkpoint'ten önceki sayfalar korunur.
+             */
+            ctx->update_target_info.erasedOffset = BL_Resume_Load(ctx);
+            ctx->update_target_info.writeOffset  = ctx->update_target_info.erasedOffset;
+            ctx->update_target_info.verifyLength = 0U;
 
             /* Yazma adreslerini target’a göre ayarla */
             ctx->update_packet_info.startAddress   = base_addr;
@@ -330,29 +835,16 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
         		 */
 
 
-        		if(usbCommParameters.USB_rx_parameters.usbRxFlag)
+        		/* STATUS_REQ (blUpdateCommands) */
+        		if (BL_Update_Dispatch(ctx) == true)
         		{
-    				usbCommParameters.USB_rx_parameters.usbRxFlag = 0;
-
-        			if(usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type 								== USB_PACKET_FIRMWARE_UPDATE &&
-        				usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id 	== USB_FIRMWARE_UPDATE_STATUS_REQ)
-        			{
-                        ctx->updateState	= BL_UPDATE_READY;
-
-                		updateInfoTime = HAL_GetTick();
-        			}
-
-        			memset(&usbCommParameters, 0, sizeof(usbCommParameters));
+            		updateInfoTime = HAL_GetTick();
         		}
 
         		break;
 
         	case BL_UPDATE_READY:
 
-        		g_usb_rx_debug.rx_callback_count 	= 0;
-        		g_usb_rx_debug.frame_completed 		= 0;
-        	    g_usb_rx_debug.total_received_bytes = 0;
-
         		/*
         		 * Her 1 saniye de 1 masaüstü uygulamasına mesaj gönderilir.
         		 */
@@ -360,7 +852,7 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
         		{
             		updateInfoTime = HAL_GetTick();
 
-            		uint8_t payload[2];
+            		uint8_t payload[15];
 
             		/*
             		 * MCU - > PC : Send BL Update Ready Info
@@ -382,208 +874,52 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
                         default:          payload[1] = USB_MSG_BL_SLOT_NONE; break;
                     }
 
-                    usbCommParameters.USB_tx_parameters =
-                        *USB_Prepare_Transmit_Buffer(
+                    /* Yetenekler: desteklenen en büyük blok boyutu ve pencere derinliği */
+                    payload[2] = (uint8_t)(BL_UPDATE_CHUNK_SIZE_MAX);
+                    payload[3] = (uint8_t)(BL_UPDATE_CHUNK_SIZE_MAX >> 8);
+                    payload[4] = (uint8_t)(BL_UPDATE_CHUNK_SIZE_MAX >> 16);
+                    payload[5] = (uint8_t)(BL_UPDATE_CHUNK_SIZE_MAX >> 24);
+                    payload[6] = (uint8_t)(BL_UPDATE_WINDOW_MAX);
+
+                    /* Yarım kalan transfer: devam offset'i ve ait olduğu imajın CRC32'si (yoksa 0) */
+                    payload[7]  = (uint8_t)(ctx->update_resume.offset);
+                    payload[8]  = (uint8_t)(ctx->update_resume.offset >> 8);
+                    payload[9]  = (uint8_t)(ctx->update_resume.offset >> 16);
+                    payload[10] = (uint8_t)(ctx->update_resume.offset >> 24);
+                    payload[11] = (uint8_t)(ctx->update_resume.fwCrc);
+                    payload[12] = (uint8_t)(ctx->update_resume.fwCrc >> 8);
+                    payload[13] = (uint8_t)(ctx->update_resume.fwCrc >> 16);
+                    payload[14] = (uint8_t)(ctx->update_resume.fwCrc >> 24);
+
+                    /* Kuyruk doluysa READY'de kalınır, sonraki turda tekrar gönderilir */
+                    if (USB_Transmit_Message(
                             USB_PACKET_FIRMWARE_UPDATE,
                             USB_FIRMWARE_UPDATE_READY,
                             0,
                             sizeof(payload),
                             payload
-                        );
-
-                    uint8_t transmitStatus = USB_Transmit(
-                        usbCommParameters.USB_tx_parameters.usbTxBuf,
-                        usbCommParameters.USB_tx_parameters.usbTxBufLen
-                    );
-
-            		if(transmitStatus != USBD_OK)
-            		{
-            			(void)USB_Transmit(usbCommParameters.USB_tx_parameters.usbTxBuf,
-		 	 	 	 	 	 	  usbCommParameters.USB_tx_parameters.usbTxBufLen);
-            		}
-
-        			memset(&usbCommParameters, 0, sizeof(usbCommParameters));
-
-                    ctx->updateState	= BL_UPDATE_REQUEST_UPDATE_INFO;
+                        ) == USBD_OK)
+                    {
+                        ctx->updateState	= BL_UPDATE_REQUEST_UPDATE_INFO;
+                    }
         		}
 
         		break;
 
         	case BL_UPDATE_REQUEST_UPDATE_INFO:
 
-        		g_usb_rx_debug.rx_callback_count 	= 0;
-        		g_usb_rx_debug.frame_completed 		= 0;
-        	    g_usb_rx_debug.total_received_bytes = 0;
+        		/* Kuyruğa sığmayan PAGE_MANIFEST cevabı; bu sırada gelen frame'ler bekletilir */
+        		if (ctx->manifest_pending == true)
+        		{
+        			ctx->manifest_pending = (BL_SendPageManifest(ctx, ctx->manifest_request,
+        														 sizeof(ctx->manifest_request)) != true);
+        			break;
+        		}
 
-        		if (usbCommParameters.USB_rx_parameters.usbRxFlag)
+        		/* PACKET_INFO, FLASH_ERASE, PAGE_MANIFEST (blUpdateCommands) */
+        		if (BL_Update_Dispatch(ctx) == true)
         		{
-        		    usbCommParameters.USB_rx_parameters.usbRxFlag = 0;
             		updateInfoTime = HAL_GetTick();
-
-        		    if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type ==
-        		            USB_PACKET_FIRMWARE_UPDATE &&
-        		        usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command
-        		            .USB_firmware_update_command_id ==
-        		            USB_FIRMWARE_UPDATE_PACKET_INFO)
-        		    {
-        		        uint8_t *rx;
-
-        		        /* RX data pointer */
-        		        rx = usbCommParameters.USB_rx_parameters.USB_rx_packet_info.data;
-
-        		        /* Güvenlik: uzunluk kontrolü */
-        		        if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.data_len >= 13U)
-        		        {
-        		            bl_update_info_t *info = &ctx->update_info;
-
-        		            /* fw_size_bytes */
-        		            info->fw_size_bytes =
-        		                  ((uint32_t)rx[0])
-        		                | ((uint32_t)rx[1] << 8)
-        		                | ((uint32_t)rx[2] << 16)
-        		                | ((uint32_t)rx[3] << 24);
-
-        		            /* fw_crc32 */
-        		            info->fw_crc32 =
-        		                  ((uint32_t)rx[4])
-        		                | ((uint32_t)rx[5] << 8)
-        		                | ((uint32_t)rx[6] << 16)
-        		                | ((uint32_t)rx[7] << 24);
-
-        		            /* fw_format */
-        		            info->fw_format = (bl_fw_format_t)rx[8];
-
-        		            /* fw_version */
-        		            info->fw_version.major = rx[11];
-        		            info->fw_version.minor = rx[10];
-        		            info->fw_version.patch = rx[9];
-
-        		            ctx->update_info.fw_version = info->fw_version;
-
-        		            /* State ilerlet */
-        		            ctx->updateState = BL_UPDATE_CHECK_INFO;
-        		        }
-        		        else
-        		        {
-        		            /* Paket eksik / hatalı */
-        		            ctx->updateState = BL_UPDATE_ERROR;
-        		        }
-        		    }
-        		    else if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type ==
-        		                USB_PACKET_FIRMWARE_UPDATE &&
-        		             usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command
-        		                .USB_firmware_update_command_id == USB_FIRMWARE_FLASH_ERASE)
-        		    {
-        		        FLASH_EraseInitTypeDef erase_cfg;
-        		        uint32_t page_error = 0;
-
-        		        /* -------------------------------------------------
-        		         * SLOT A ERASE
-        		         * ------------------------------------------------- */
-        		        {
-        		            const uint32_t base_addr = SLOT_A_BASE_ADDR;
-        		            const uint32_t end_addr  = SLOT_A_END_ADDR;
-
-        		            const uint32_t start_page = (base_addr - FLASH_BASE) / _FLASH_PAGE_SIZE;
-        		            const uint32_t end_page   = (end_addr  - FLASH_BASE) / _FLASH_PAGE_SIZE;
-
-        		            erase_cfg.TypeErase = FLASH_TYPEERASE_PAGES;
-
-        		            /* Slot A için bank seçimi: */
-        		            erase_cfg.Banks   = FLASH_BANK_1;
-        		            erase_cfg.Page    = start_page;
-        		            erase_cfg.NbPages = (end_page - start_page) + 1U;
-
-        		            HAL_FLASH_Unlock();
-
-        		            if (HAL_FLASHEx_Erase(&erase_cfg, &page_error) != HAL_OK)
-        		            {
-        		                HAL_FLASH_Lock();
-        		                ctx->error = BL_ERR_FLASH_WRITE;
-        		                //ctx->state = BL_STATE_ERROR;
-        		                return;
-        		            }
-
-        		            HAL_FLASH_Lock();
-        		        }
-
-        		        /* -------------------------------------------------
-        		         * SLOT B ERASE
-        		         * ------------------------------------------------- */
-        		        {
-        		            const uint32_t base_addr = SLOT_B_BASE_ADDR;
-        		            const uint32_t end_addr  = SLOT_B_END_ADDR;
-
-        		            const uint32_t start_page = (base_addr - FLASH_BASE) / _FLASH_PAGE_SIZE;
-        		            const uint32_t end_page   = (end_addr  - FLASH_BASE) / _FLASH_PAGE_SIZE;
-
-        		            erase_cfg.TypeErase = FLASH_TYPEERASE_PAGES;
-
-        		            /* Slot B için bank seçimi: */
-        		            erase_cfg.Banks   = FLASH_BANK_1;
-        		            erase_cfg.Page    = start_page;
-        		            erase_cfg.NbPages = (end_page - start_page) + 1U;
-
-        		            HAL_FLASH_Unlock();
-
-        		            if (HAL_FLASHEx_Erase(&erase_cfg, &page_error) != HAL_OK)
-        		            {
-        		                HAL_FLASH_Lock();
-        		                ctx->error = BL_ERR_FLASH_WRITE;
-        		                //ctx->state = BL_STATE_ERROR;
-        		                return;
-        		            }
-
-        		            HAL_FLASH_Lock();
-        		        }
-
-        		        /* -------------------------------------------------
-        		         * 2) Metadata temizle + güncelle (iki slot da boş)
-        		         *    - Meta flash alanını erase et
-        		         *    - Tutarlı bir meta record yaz (CRC dahil)
-        		         * ------------------------------------------------- */
-        		        {
-        		            meta_record_t m;
-        		            memset(&m, 0, sizeof(m));
-
-        		            /* "Temiz + boş" meta kaydı oluştur */
-        		            m.magic        = META_MAGIC;
-        		            m.seq          = (ctx->meta.seq == 0xFFFFFFFFu || ctx->meta.seq == 0u) ? 1u : (ctx->meta.seq + 1u);
-
-        		            /* Her iki slot boş: valid=0 */
-        		            m.slotA.valid  = 0u;
-        		            m.slotB.valid  = 0u;
-        		            m.progress_bytes = 0u;
-
-        		            /* Sanity check’lerden geçsin diye A/B set ediyoruz,
-        		               ama state NO_APP ile “geçerli app yok” bilgisini veriyoruz. */
-        		            m.active_slot  = META_SLOT_A;
-        		            m.target_slot  = META_SLOT_B;
-        		            m.update_state = META_UPDATE_NO_APP;
-
-        		            /* Meta_Write zaten erase + crc + write yapıyor.
-        		               Ama önce meta flash’ı tamamen temizlemek istedin, o yüzden ayrıca erase de atıyoruz. */
-        		            (void)Flash_Erase(META_FLASH_ADDR);
-
-        		            if (Meta_Write(&m) != true)
-        		            {
-        		                ctx->error = BL_ERR_FLASH_WRITE;
-        		                ctx->state = BL_STATE_ERROR;
-        		                return;
-        		            }
-
-        		            /* RAM'deki meta’yı da senkronla */
-        		            ctx->meta = m;
-        		        }
-
-        		        /* -------------------------------------------------
-        		         * 3) Hedef slotu SLOT A olarak işaretle
-        		         * ------------------------------------------------- */
-        		        ctx->update_target_info.g_target_slot      = BL_SLOT_A;
-        		        ctx->update_target_info.g_target_base_addr = SLOT_A_BASE_ADDR;
-        		        ctx->update_target_info.g_target_end_addr  = SLOT_A_END_ADDR;
-
-        		    }
         		}
 
         		break;
@@ -591,17 +927,28 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
         	case BL_UPDATE_CHECK_INFO:
 
         		updateInfoTime = HAL_GetTick();
-        		g_usb_rx_debug.rx_callback_count 	= 0;
-        		g_usb_rx_debug.frame_completed 		= 0;
-        	    g_usb_rx_debug.total_received_bytes = 0;
 
-        		if(ctx->update_info.fw_size_bytes <= BL_APP_MAX_SIZE)
+        		if ((ctx->update_info.fw_size_bytes <= BL_APP_MAX_SIZE) &&
+        			(ctx->update_info.image_size_bytes != 0U) &&
+        			(ctx->update_info.image_size_bytes <= BL_APP_MAX_SIZE) &&
+        			(BL_Stream_Init(ctx) == true))
         		{
         			ctx->updateState 		= BL_UPDATE_REQUEST_PACKET;
         			ctx->update_requested 	= true;
 
         			ctx->update_packet_info.startAddress 		= 0x00000000;
         			ctx->update_packet_info.remainingDataLength = ctx->update_info.fw_size_bytes;
+
+        			BL_Window_Reset(&ctx->update_window, ctx->update_window.depth);
+
+        			/* İmaj CRC'si veri flash'a verildikçe hesaplanır, sonda flash geri okunmaz */
+        			BL_Digest_Reset(ctx);
+        			ctx->update_target_info.verifyLength = 0U;
+
+        			memset(&ctx->update_stats, 0, sizeof(bl_update_stats_t));
+        			ctx->update_stats.infoTick = updateInfoTime;
+
+        			BL_Resume_Begin(ctx);
         		}
         		else
         		{
@@ -615,192 +962,338 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
         		updateInfoTime = HAL_GetTick();
         		requestedTime = ctx->boot_elapsed_ms;
 
-        		if(ctx->update_requested && ctx->update_in_progress == false)
+        		/*
+        		 * Pencere içindeki boş slotlar için sıradaki offsetleri talep et,
+        		 * zaman aşımına uğrayan talepleri tekrar gönder
+        		 */
+        		if (BL_Window_RequestPackets(ctx) != true)
         		{
-        			ctx->update_requested 	= false;
-        			ctx->update_in_progress	= true;
-
-        			/*
-        			 * Belirli bir adresten itibaren belirli uzunlukta veri talep et
-        			 */
-        			if(ctx->update_packet_info.remainingDataLength >= 1024)
-        			{
-        				ctx->update_packet_info.requestedDataLength = 1024;
-        			}
-        			else
-        			{
-        				ctx->update_packet_info.requestedDataLength = ctx->update_packet_info.remainingDataLength;
-        			}
-
-        			uint8_t packet[8] 	= {0};
-        			uint16_t dataLength = 8;
-
-        			packet[0] = (uint8_t)( ctx->update_packet_info.startAddress >> 24 & 0xFF);
-        			packet[1] = (uint8_t)( ctx->update_packet_info.startAddress >> 16 & 0xFF);
-        			packet[2] = (uint8_t)( ctx->update_packet_info.startAddress >> 8  & 0xFF);
-        			packet[3] = (uint8_t)( ctx->update_packet_info.startAddress >> 0  & 0xFF);
-        			packet[4] = (uint8_t)( ctx->update_packet_info.requestedDataLength >> 24 & 0xFF);
-        			packet[5] = (uint8_t)( ctx->update_packet_info.requestedDataLength >> 16 & 0xFF);
-        			packet[6] = (uint8_t)( ctx->update_packet_info.requestedDataLength >> 8  & 0xFF);
-        			packet[7] = (uint8_t)( ctx->update_packet_info.requestedDataLength >> 0  & 0xFF);
-
-
-            		usbCommParameters.USB_tx_parameters = *USB_Prepare_Transmit_Buffer(USB_PACKET_FIRMWARE_UPDATE,
-																					   USB_FIRMWARE_UPDATE_GET_PACKET,
-																					   0,
-																					   dataLength,
-																					   packet);
-            		uint8_t transmitStatus = USB_Transmit(usbCommParameters.USB_tx_parameters.usbTxBuf,
-            					 	 	 	 	 	 	  usbCommParameters.USB_tx_parameters.usbTxBufLen);
-
-            		if(transmitStatus != USBD_OK)
-            		{
-            			(void)USB_Transmit(usbCommParameters.USB_tx_parameters.usbTxBuf,
-		 	 	 	 	 	 	  usbCommParameters.USB_tx_parameters.usbTxBufLen);
-            		}
+        			ctx->updateState = BL_UPDATE_ERROR;
+        			ctx->state		 = BL_STATE_ERROR;
+        			break;
+        		}
 
-        			memset(&usbCommParameters, 0, sizeof(usbCommParameters));
+        		ctx->update_requested 	= false;
+        		ctx->update_in_progress	= true;
 
-        			ctx->updateState = BL_UPDATE_RECEIVE_DATA;
-        		}
+        		ctx->updateState = BL_UPDATE_RECEIVE_DATA;
 
         		break;
 
         	case BL_UPDATE_RECEIVE_DATA:
 
-        		if (usbCommParameters.USB_rx_parameters.usbRxFlag)
+        		if (usbRxFrame.valid)
         		{
-            		updateInfoTime = HAL_GetTick();
-        		    usbCommParameters.USB_rx_parameters.usbRxFlag = 0;
-
-        		    if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.packet_type ==
-        		            USB_PACKET_FIRMWARE_UPDATE &&
-        		        usbCommParameters.USB_rx_parameters.USB_rx_packet_info.command
-        		            .USB_firmware_update_command_id ==
-        		            		USB_FIRMWARE_UPDATE_SEND_PACKET)
-        		    {
-        		        uint8_t *rx;
-
-        		        /* RX data pointer */
-        		        rx = usbCommParameters.USB_rx_parameters.USB_rx_packet_info.data;
-
-        		        /* Güvenlik: uzunluk kontrolü */
-        		        if (usbCommParameters.USB_rx_parameters.USB_rx_packet_info.data_len >= ctx->update_packet_info.requestedDataLength)
-        		        {
-        		        	/*
-        		        	 * Gelen data içerisinden ilk ctx->update_packet_info.requestedDataLength kadarı veriyi
-        		        	 * ondan sonraki 4 byte ise CRC32 yi içermektedir. İlk olarak crc32 kontorlünün yapılması gerekir.
-        		        	 */
-
-        		        	Bootloader_Packet_Parser(&ctx->update_packet,
-        		        							 rx,
-        		        							 usbCommParameters.USB_rx_parameters.USB_rx_packet_info.data_len);
-
-                			ctx->updateState = BL_UPDATE_VERIFY;
-        		        }
-
-        		    }
+        			/* SEND_PACKET (blUpdateCommands) */
+        			if (BL_Update_Dispatch(ctx) == true)
+        			{
+                		updateInfoTime = HAL_GetTick();
+        			}
+        		}
+        		else if ((ctx->update_window.programPending == true) &&
+        				 (Flash_Async_Status() != FLASH_ASYNC_BUSY))
+        		{
+        			/* Blok programlandı: slot bırakılır, bekleyen paketler yazılır */
+        			ctx->updateState = BL_UPDATE_WRITE_FLASH;
+        		}
+        		else if (BL_Window_IsTimedOut(&ctx->update_window) == true)
+        		{
+        			/* Cevapsız kalan talepleri tekrar gönder */
+        			ctx->updateState = BL_UPDATE_REQUEST_PACKET;
+        		}
+        		else
+        		{
+        			/* Veri beklerken sıradaki sayfa önceden silinir */
+        			BL_Target_EraseAhead(ctx);
         		}
 
         		break;
 
         	case BL_UPDATE_VERIFY:
+        	{
+        		bl_update_window_t *window = &ctx->update_window;
+        		bl_window_slot_t   *slot   = &window->slot[window->activeSlot];
+
+        		/* Önceki turda TX kuyruğu doluydu: paket doğrulandı, yalnızca cevap tekrar gönderilir */
+        		if (window->verifyPending == true)
+        		{
+        			if (USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_VERIFY_PACKET, 0,
+        									 window->verifyReplyLen, window->verifyReply) == USBD_OK)
+        			{
+        				window->verifyPending = false;
+        				ctx->updateState 	  = window->verifyNextState;
+        			}
+
+        			break;
+        		}
 
-        		if(CRC32_Verify(ctx->update_packet.packetBuff, ctx->update_packet.packetLen, ctx->update_packet.packetCRC))
+        		if(CRC32_Verify(slot->packet.packetData, slot->packet.packetLen, slot->packet.packetCRC))
         		{
         			/*
-        			 * CRC OK Gönder ve devam et
+        			 * CRC OK Gönder ve devam et (push modunda gönderilmez, ilerleme toplu bildirilir)
         			 */
 
-        			ctx->update_packet.requestCounter	= 0;
-        			ctx->update_packet.crcStatus 		= USB_CRC_OK;
-        			ctx->updateState 					= BL_UPDATE_WRITE_FLASH;
+        			slot->packet.requestCounter	= 0;
+        			slot->packet.crcStatus 		= USB_CRC_OK;
+        			slot->state					= BL_WINDOW_SLOT_RECEIVED;
+        			window->verifyNextState 	= BL_UPDATE_WRITE_FLASH;
+
+        			if (slot->packet.packetKind != BL_PACKET_KIND_DATA)
+        			{
+        				/*
+        				 * Birden fazla bloğu kapsayan aralık: aradaki ve sonraki talepler hemen
+        				 * düşürülür ki host'un aralık sonundan gönderdiği bloklar eşleşsin
+        				 */
+        				BL_Window_SkipRange(window, slot, slot->offset, slot->offset + slot->packet.runLen);
+        			}
         		}
         		else
         		{
         			/*
-        			 * CRC NOK Gönder ve paketi tekrar iste
+        			 * CRC NOK Gönder ve sadece bu paketi tekrar iste
         			 */
 
-        			ctx->update_packet.crcStatus 		= USB_CRC_NOK;
-        			ctx->update_packet.requestCounter	+= 1;
+        			slot->packet.crcStatus 		= USB_CRC_NOK;
+        			ctx->update_stats.crcErrors += 1U;
+
+        			/* Bozuk paketin frame'i havuza geri verilir */
+        			USB_Rx_Release_Frame(&slot->frame);
+
+        			/*
+        			 * Talep zamanını geri çek ki REQUEST_PACKET bu slotu hemen tekrar istesin.
+        			 * Deneme sayısı ve limit kontrolü orada yapılır.
+        			 * Push modunda NAK'ın kendisi tekrar gönderim talebidir; cevap gelmezse
+        			 * zaman aşımında GET_PACKET ile istenir.
+        			 */
+        			slot->requestTick = HAL_GetTick();
 
-        			if(ctx->update_packet.requestCounter >= 4)
+        			if (ctx->update_info.push_mode == false)
         			{
-        				// ERROR
-        				ctx->updateState = BL_UPDATE_ERROR;
-        				ctx->state		 = BL_STATE_ERROR;
+        				slot->requestTick -= BL_UPDATE_WINDOW_TIMEOUT_MS;
         			}
-        		}
-
-    			uint8_t usbPacket[1] 	 = {0};
-    			uint16_t usbPacketLength = 1;
 
-     			usbPacket[0]   = ctx->update_packet.crcStatus;
+        			window->verifyNextState = BL_UPDATE_REQUEST_PACKET;
+        		}
 
-        		usbCommParameters.USB_tx_parameters = *USB_Prepare_Transmit_Buffer(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_VERIFY_PACKET, 0, usbPacketLength, usbPacket);
-        		uint8_t transmitStatus = USB_Transmit(usbCommParameters.USB_tx_parameters.usbTxBuf, usbCommParameters.USB_tx_parameters.usbTxBufLen);
+        		ctx->updateState = window->verifyNextState;
 
-        		if(transmitStatus != USBD_OK)
+        		if ((ctx->update_info.push_mode == true) && (slot->packet.crcStatus == USB_CRC_OK))
         		{
-        			(void)USB_Transmit(usbCommParameters.USB_tx_parameters.usbTxBuf,
-	 	 	 	 	 	 	  usbCommParameters.USB_tx_parameters.usbTxBufLen);
+        			break;
         		}
 
-    			memset(&usbCommParameters, 0, sizeof(usbCommParameters));
+        		window->verifyReply[0] = slot->packet.crcStatus;
+        		window->verifyReplyLen = 1U;
+
+     			/* Pencereli / push modda hangi paketin onaylandığı offset ile bildirilir */
+     			if ((window->depth > 1U) || (ctx->update_info.push_mode == true))
+     			{
+     				window->verifyReply[1] = (uint8_t)(slot->offset >> 24 & 0xFF);
+     				window->verifyReply[2] = (uint8_t)(slot->offset >> 16 & 0xFF);
+     				window->verifyReply[3] = (uint8_t)(slot->offset >> 8  & 0xFF);
+     				window->verifyReply[4] = (uint8_t)(slot->offset >> 0  & 0xFF);
+     				window->verifyReplyLen = 5U;
+     			}
+
+     			/*
+     			 * Kuyruk doluysa (pencere başına GET_PACKET + VERIFY) cevap kaybolmasın: durum
+     			 * VERIFY'da kalır, sonraki turlarda yalnızca cevap gönderilir
+     			 */
+        		if (USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_VERIFY_PACKET, 0,
+        								 window->verifyReplyLen, window->verifyReply) != USBD_OK)
+        		{
+        			window->verifyPending = true;
+        			ctx->updateState 	  = BL_UPDATE_VERIFY;
+        		}
 
         		break;
+        	}
 
         	case BL_UPDATE_WRITE_FLASH:
+        	{
+        		bl_window_slot_t *slot;
+        		uint32_t		  writeStart = HAL_GetTick();
+
+        		/*
+        		 * Flash motoru önceki bloğu programlarken sıradaki paketler alınıp
+        		 * doğrulanır; yazma motor boşalınca devam eder
+        		 */
+        		if (Flash_Async_Status() == FLASH_ASYNC_BUSY)
+        		{
+        			ctx->updateState = BL_UPDATE_REQUEST_PACKET;
+        			break;
+        		}
 
-        	    bool flash_status	= 0;
-        	    uint8_t retry_cnt = 0U;
+        		/* Önceki turda kuyruğa verilen sayfa tamamlandı mı */
+        		ctx->update_window.programPending = false;
 
-        	    uint32_t targetAddress = ctx->update_target_info.g_target_base_addr + ctx->update_packet.packetAddr;
+        		if (BL_Target_Sync(ctx) != true)
+        		{
+        			ctx->error = BL_ERR_FLASH_WRITE;
+        			ctx->state = BL_STATE_ERROR;
+        			break;
+        		}
 
         	    /* -------------------------------------------------
-        	     * Write data to flash (with retry)
+        	     * Sıradaki offset'ten başlayarak ardışık alınmış
+        	     * tüm paketleri flash'a yaz (sırasız gelenler bekler)
         	     * ------------------------------------------------- */
-        	    while ((flash_status == false) && (retry_cnt < BL_FLASH_WRITE_RETRY_COUNT))
-        	    {
-        	        flash_status = Flash_Write(
-        	        					targetAddress,
-        	                            ctx->update_packet.packetBuff,
-        	                            ctx->update_packet.packetLen
-        	                        );
+        		while ((slot = BL_Window_FindSlot(&ctx->update_window,
+        										  ctx->update_window.commitOffset,
+        										  BL_WINDOW_SLOT_RECEIVED)) != NULL)
+        		{
+            	    bl_error_t write_status = BL_ERR_NONE;
+            	    uint32_t   committed;
 
-        	        retry_cnt++;
-        	    }
+            	    /* -------------------------------------------------
+            	     * Write data to flash (with retry)
+            	     * BIN: sayfa tamponunda birleştirilerek, LZ4/DELTA: açılarak sayfa sayfa,
+            	     * COPY: aktif slottan flash'tan flash'a, ERASED: yalnızca sayfa silme,
+            	     * her ikisi de turda en fazla bir sayfa
+            	     * ------------------------------------------------- */
+            	    if ((slot->packet.packetKind != BL_PACKET_KIND_DATA) && (BL_Bin_Flush(ctx) != true))
+            	    {
+            	        /* Aralıktan önce tampondaki yarım sayfa yazılır */
+            	        committed	 = 0U;
+            	        write_status = BL_ERR_FLASH_WRITE;
+            	    }
+            	    else if (slot->packet.packetKind == BL_PACKET_KIND_COPY)
+            	    {
+            	        uint32_t source = BL_GetSourceBase(ctx);
+
+            	        committed = (slot->packet.runLen > _FLASH_PAGE_SIZE) ? _FLASH_PAGE_SIZE : slot->packet.runLen;
+
+            	        if ((source == 0U) ||
+            	            (BL_Target_Write(ctx,
+            	                             slot->offset,
+            	                             (const uint8_t *)(source + slot->offset),
+            	                             committed) != true))
+            	        {
+            	            write_status = BL_ERR_FLASH_WRITE;
+            	        }
+            	        else
+            	        {
+            	            BL_Digest_Update(ctx, slot->offset, (const uint8_t *)(source + slot->offset), committed);
+            	        }
+            	    }
+            	    else if (slot->packet.packetKind == BL_PACKET_KIND_ERASED)
+            	    {
+            	        committed = (slot->packet.runLen > _FLASH_PAGE_SIZE) ? _FLASH_PAGE_SIZE : slot->packet.runLen;
+
+            	        if (BL_Target_EnsureErased(ctx, slot->offset + committed) != true)
+            	        {
+            	            write_status = BL_ERR_FLASH_WRITE;
+            	        }
+            	        else
+            	        {
+            	            BL_Digest_Update(ctx, slot->offset, NULL, committed);
+            	        }
+            	    }
+            	    else
+            	    {
+            	        write_status = BL_Stream_WritePacket(ctx, &slot->packet);
+            	        committed	 = slot->packet.packetLen;
+            	    }
+
+            	    /* -------------------------------------------------
+            	     * Flash write / decompression failed
+            	     * ------------------------------------------------- */
+            	    if (write_status != BL_ERR_NONE)
+            	    {
+            	        ctx->error = write_status;
+            	        ctx->state = BL_STATE_ERROR;
+            	        break;
+            	    }
+
+            	    /* -------------------------------------------------
+            	     * Update progress
+            	     * ------------------------------------------------- */
+            	    ctx->update_window.commitOffset				+= committed;
+            	    ctx->update_stats.bytesCommitted			+= committed;
+            	    ctx->update_stats.lastCommitTick			 = HAL_GetTick();
+            	    ctx->update_packet_info.remainingDataLength -= committed;
+            	    ctx->update_packet_info.startAddress 		= ctx->update_window.commitOffset;
+
+            	    if (slot->packet.packetKind == BL_PACKET_KIND_DATA)
+            	    {
+            	        if (ctx->update_info.fw_format == BL_FW_FORMAT_BIN)
+            	        {
+            	            /* BIN: doğrulanmış paket CRC'si imaj CRC'sine eklenir (LZ4/DELTA açılan sayfalarla ilerler) */
+            	            BL_Digest_Append(ctx, slot->offset, slot->packet.packetCRC, slot->packet.packetLen);
+            	        }
+            	    }
+            	    else
+            	    {
+            	        slot->packet.runLen -= committed;
+            	    }
+
+            	    if (slot->packet.runLen != 0U)
+            	    {
+            	        /* Aralık sürüyor: slot kalan kısmıyla sırada kalır, döngü diğer işlere döner */
+            	        slot->offset = ctx->update_window.commitOffset;
+            	        break;
+            	    }
+
+            	    USB_Rx_Release_Frame(&slot->frame);
+            	    slot->state = BL_WINDOW_SLOT_FREE;
+
+            	    if (Flash_Async_Status() != FLASH_ASYNC_IDLE)
+            	    {
+            	        /* Dolan sayfa kesmeyle programlanıyor: sıradaki bloklar bu sürede alınır */
+            	        ctx->update_window.programPending = true;
+            	        break;
+            	    }
+        		}
 
         	    /* -------------------------------------------------
         	     * Update flags
         	     * ------------------------------------------------- */
         	    ctx->update_requested						= true;
         	    ctx->update_in_progress						= false;
+        	    ctx->update_stats.flashWriteMs				+= HAL_GetTick() - writeStart;
 
-        	    /* -------------------------------------------------
-        	     * Flash write failed after retries
-        	     * ------------------------------------------------- */
-        	    if (flash_status != true)
+        	    if (ctx->state == BL_STATE_ERROR)
         	    {
-        	        ctx->error = BL_ERR_FLASH_WRITE;
-        	        ctx->state = BL_STATE_ERROR;
-        	        break;
+        	    	break;
         	    }
 
-        	    /* -------------------------------------------------
-        	     * Update progress
-        	     * ------------------------------------------------- */
-        	    ctx->update_packet_info.remainingDataLength -= ctx->update_packet.packetLen;
-        	    ctx->update_packet_info.startAddress 		= ctx->update_packet.packetAddr + ctx->update_packet.packetLen;
+        	    if (ctx->update_info.push_mode == true)
+        	    {
+        	    	BL_Window_ReportProgress(ctx);
+        	    }
+
+        	    if (ctx->update_window.programPending == true)
+        	    {
+        	    	/* Checkpoint ve bitiş programlama tamamlandıktan sonra */
+        	    	ctx->updateState = BL_UPDATE_REQUEST_PACKET;
+        	    	break;
+        	    }
+
+        	    BL_Resume_Checkpoint(ctx);
 
-        	    if(ctx->update_packet_info.remainingDataLength <= 0)
+        	    if(ctx->update_window.commitOffset >= ctx->update_info.fw_size_bytes)
         	    {
+        	    	bl_error_t finish_status = BL_Stream_Finish(ctx);
+
+        	    	if (finish_status != BL_ERR_NONE)
+        	    	{
+        	    		ctx->error = finish_status;
+        	    		ctx->state = BL_STATE_ERROR;
+        	    		break;
+        	    	}
+
             	    /* -------------------------------------------------
             	     * Finish packet
             	     * ------------------------------------------------- */
             	    ctx->updateState = BL_UPDATE_FINISH;
         	    }
+        	    else if (BL_Window_FindSlot(&ctx->update_window,
+        	    							ctx->update_window.commitOffset,
+        	    							BL_WINDOW_SLOT_RECEIVED) != NULL)
+        	    {
+        	    	/* Kopya / silme aralığı yarıda: sonraki turda kaldığı yerden devam */
+        	    	ctx->updateState = BL_UPDATE_WRITE_FLASH;
+        	    }
         	    else
         	    {
             	    /* -------------------------------------------------
@@ -809,8 +1302,8 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
             	    ctx->updateState = BL_UPDATE_REQUEST_PACKET;
         	    }
 
-
         		break;
+        	}
 
         	case BL_UPDATE_ERROR:
 
@@ -828,10 +1321,55 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
 
         		expected_crc 			= ctx->update_info.fw_crc32;
 
-        		calculated_crc = CRC32_Calculate(
-												 (uint8_t *)ctx->update_target_info.g_target_base_addr,
-												 ctx->update_info.fw_size_bytes
-												);
+        		if ((ctx->image_digest.valid == true) &&
+        			(ctx->image_digest.offset == ctx->update_info.image_size_bytes))
+        		{
+        			/* Transfer sırasında tutulan imaj CRC'si: flash tekrar okunmaz */
+        			ctx->update_stats.finalCrcMs = 0U;
+        			calculated_crc = ctx->image_digest.crc;
+        		}
+        		else if (ctx->update_window.finalCrcBusy == false)
+        		{
+        			/* Süre istatistiği yalnızca CRC bitince yazılır; başlangıç pencerede tutulur */
+        			ctx->update_window.finalCrcStartTick = HAL_GetTick();
+
+        			/* CRC birimi imajı DMA ile okur, bu sırada ana döngü USB'ye bakmaya devam eder */
+        			if (CRC32_HW_Start(ctx->update_target_info.g_target_base_addr,
+        							   ctx->update_info.image_size_bytes) == true)
+        			{
+        				ctx->update_window.finalCrcBusy = true;
+        				break;
+        			}
+
+        			calculated_crc = CRC32_Calculate(
+													 (uint8_t *)ctx->update_target_info.g_target_base_addr,
+													 ctx->update_info.image_size_bytes
+													);
+
+        			ctx->update_stats.finalCrcMs = HAL_GetTick() - ctx->update_window.finalCrcStartTick;
+        		}
+        		else
+        		{
+        			crc32_hw_status_t crcStatus = CRC32_HW_Poll(&calculated_crc);
+
+        			if (crcStatus == CRC32_HW_BUSY)
+        			{
+        				break;
+        			}
+
+        			ctx->update_window.finalCrcBusy = false;
+
+        			if (crcStatus != CRC32_HW_DONE)
+        			{
+        				/* DMA hatası: yazılım CRC'sine dön */
+        				calculated_crc = CRC32_Calculate(
+														 (uint8_t *)ctx->update_target_info.g_target_base_addr,
+														 ctx->update_info.image_size_bytes
+														);
+        			}
+
+        			ctx->update_stats.finalCrcMs = HAL_GetTick() - ctx->update_window.finalCrcStartTick;
+        		}
 
         		if (calculated_crc != expected_crc)
         		{
@@ -867,52 +1405,59 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
             }
 
             /* -------------------------------------------------
-             * 2) Metadata geçerli mi?  (CRC self-field hariç)
+             * 2) Target slot kontrolü
+             * ------------------------------------------------- */
+            /*
+             * Yeni slot, imajın yazıldığı slottur. Kayıttaki hedefe güvenilmez: metadata
+             * boş bir cihazda SELECT_TARGET slot A'yı seçer, yukarıdaki yeniden kurulum
+             * ise A dolu olduğu için hedefi B yapar.
+             */
+            meta_slot_t new_slot = (ctx->update_target_info.g_target_slot == BL_SLOT_B) ? META_SLOT_B : META_SLOT_A;
+
+#if (BL_BANK_SWAP_BOOT == 1)
+            /* -------------------------------------------------
+             * 3) Bank swap: yeni imaj diğer bankta (SLOT_B).
+             *    Swap sonrası geçerli kayıt yazılır, BL_STATE_JUMP
+             *    SWAP_BANK'ı değiştirip cihazı reset'ler.
              * ------------------------------------------------- */
             {
-                meta_record_t tmp = meta;
-                tmp.crc = 0U;
+                meta_slot_info_t image;
 
-                uint32_t calc_crc = CRC32_Calculate(
-                    ((uint8_t *)&tmp) + sizeof(uint32_t),      /* magic hariç */
-                    sizeof(meta_record_t) - sizeof(uint32_t)   /* crc dahil struct boyutu */
-                );
+                image.fw.size_bytes    = ctx->update_info.image_size_bytes;
+                image.fw.crc32         = ctx->update_info.fw_crc32;
+                image.fw.version_major = ctx->update_info.fw_version.major;
+                image.fw.version_minor = ctx->update_info.fw_version.minor;
+                image.fw.version_patch = ctx->update_info.fw_version.patch;
+                image.valid            = 1U;
 
-                if ((meta.magic != META_MAGIC) || (calc_crc != meta.crc))
+                /* Swap modunda hedef her zaman diğer bank */
+                write_ok = (new_slot == META_SLOT_B) && (BL_BankSwap_Prepare(ctx, &meta, &image) == true);
+
+                if (write_ok != true)
                 {
-                    /* Bozuk metadata → slotlara bakarak yeniden oluştur */
-                    Meta_Init_FromSlots(&meta);
+                    ctx->error = BL_ERR_FLASH_WRITE;
+                    ctx->state = BL_STATE_ERROR;
+                    break;
                 }
             }
-
-            /* -------------------------------------------------
-             * 3) Target slot kontrolü
-             * ------------------------------------------------- */
-            meta_slot_t new_slot = meta.target_slot;
-
-            if (new_slot == META_SLOT_NONE)
-            {
-                ctx->error = BL_ERR_INVALID_VECTOR;
-                ctx->state = BL_STATE_ERROR;
-                break;
-            }
-
+#else
             /* -------------------------------------------------
-             * 4) Metadata güncelle
+             * 3) Metadata güncelle
              * ------------------------------------------------- */
             meta.active_slot    = new_slot;
             meta.target_slot    = (new_slot == META_SLOT_A) ? META_SLOT_B : META_SLOT_A;
             meta.update_state   = META_UPDATE_IDLE;
             meta.seq++;
             meta.progress_bytes = 0U;
+            meta.progress_crc32 = 0U;
 
             meta_slot_info_t *slot =
                 (new_slot == META_SLOT_A) ? &meta.slotA : &meta.slotB;
 
             /* -------------------------------------------------
-             * 4.1) Slot firmware bilgilerini YAPIYA UYUMLU yaz
+             * 3.1) Slot firmware bilgilerini YAPIYA UYUMLU yaz
              * ------------------------------------------------- */
-            slot->fw.size_bytes    = ctx->update_info.fw_size_bytes;
+            slot->fw.size_bytes    = ctx->update_info.image_size_bytes;
             slot->fw.crc32         = ctx->update_info.fw_crc32;
             slot->fw.version_major = ctx->update_info.fw_version.major;
             slot->fw.version_minor = ctx->update_info.fw_version.minor;
@@ -920,7 +1465,7 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
             slot->valid            = 1U;
 
             /* -------------------------------------------------
-             * 5) CRC yeniden hesapla (KRİTİK: önce 0'la)
+             * 4) CRC yeniden hesapla (KRİTİK: önce 0'la)
              * ------------------------------------------------- */
 /*
             meta.crc = 0U;
@@ -930,7 +1475,7 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
             );
 */
             /* -------------------------------------------------
-             * 6) Metadata yaz
+             * 5) Metadata yaz
              * ------------------------------------------------- */
             write_ok = Meta_Write(&meta);
             if (write_ok != true)
@@ -941,12 +1486,13 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
             }
 
             /* -------------------------------------------------
-             * 6.1) Active slota göre app_base ayarla
+             * 5.1) Active slota göre app_base ayarla
              * ------------------------------------------------- */
             if (meta.active_slot == META_SLOT_B)
                 ctx->app_base = BL_APP_SLOT2_ADDRESS;
             else
                 ctx->app_base = BL_APP_BASE_ADDRESS;
+#endif
 
             uint8_t data[3] = {0};
 
@@ -959,30 +1505,11 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
 							  data,
 							  3);
 
-            usbCommParameters.USB_tx_parameters =
-                *USB_Prepare_Transmit_Buffer(
-                    USB_PACKET_FIRMWARE_UPDATE,
-					USB_FIRMWARE_JUMPING_APPLICATION,
-                    0,
-                    0,
-                    NULL
-                );
-
-            uint8_t transmitStatus = USB_Transmit(
-                usbCommParameters.USB_tx_parameters.usbTxBuf,
-                usbCommParameters.USB_tx_parameters.usbTxBufLen
-            );
-
-    		if(transmitStatus != USBD_OK)
-    		{
-    			(void)USB_Transmit(usbCommParameters.USB_tx_parameters.usbTxBuf,
- 	 	 	 	 	 	  usbCommParameters.USB_tx_parameters.usbTxBufLen);
-    		}
-
-			memset(&usbCommParameters, 0, sizeof(usbCommParameters));
+            /* JUMPING_APPLICATION BL_STATE_JUMP'taki bekleme süresince kuyruğa verilir */
+            ctx->jump_notify_pending = true;
 
             /* -------------------------------------------------
-             * 7) Güncelleme tamam → uygulamaya geç
+             * 6) Güncelleme tamam → uygulamaya geç
              * ------------------------------------------------- */
             ctx->state = BL_STATE_JUMP;
             break;
@@ -990,7 +1517,37 @@ void Bootloader_Task(BootloaderCtx_t *ctx)
 
         case BL_STATE_JUMP:
         {
-        	HAL_Delay(1000);
+        	/*
+        	 * Atlamadan önce 1 s beklenir: kuyruktaki mesajlar (JUMPING_APPLICATION) gönderilir,
+        	 * host bu sürede son komutları (ör. UPDATE_STATS) gönderebilir
+        	 */
+        	if (ctx->jump_tick == 0U)
+        	{
+        		ctx->jump_tick = HAL_GetTick();
+        	}
+
+        	/* TX kuyruğu doluysa bekleme boyunca her turda tekrar denenir */
+        	if ((ctx->jump_notify_pending == true) &&
+        		(USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_JUMPING_APPLICATION, 0, 0, NULL) == USBD_OK))
+        	{
+        		ctx->jump_notify_pending = false;
+        	}
+
+        	if ((HAL_GetTick() - ctx->jump_tick) < 1000U)
+        	{
+        		break;
+        	}
+
+#if (BL_BANK_SWAP_BOOT == 1)
+        	if (ctx->bank_swap_pending == true)
+        	{
+        		/* Option byte yüklemesi cihazı reset'ler; dönerse swap yapılamadı */
+        		(void)Flash_SetBankSwap(Flash_IsBankSwapped() == false);
+        		ctx->error = BL_ERR_FLASH_WRITE;
+        		ctx->state = BL_STATE_ERROR;
+        		break;
+        	}
+#endif
 
             (void)Bootloader_JumpToApplication(ctx);
             ctx->state = BL_STATE_ERROR;
@@ -1046,16 +1603,28 @@ void Bootloader_Packet_Parser(bl_update_packet_t *ctxPacket, uint8_t *buff, uint
         ((uint32_t)buff[3]);
 
     /* Data length */
-    ctxPacket->packetLen =
+    uint32_t dataLen =
         ((uint32_t)buff[4] << 24) |
         ((uint32_t)buff[5] << 16) |
         ((uint32_t)buff[6] << 8)  |
         ((uint32_t)buff[7]);
 
-    /* Data copy */
-    for (uint32_t i = 0; i < ctxPacket->packetLen; i++)
+    if ((dataLen & BL_PACKET_RUN_FLAGS) != 0U)
     {
-        ctxPacket->packetBuff[i] = buff[8 + i];
+        /* 0xFF / kopya aralığı: CRC adres + uzunluk alanlarını korur */
+        ctxPacket->packetKind = ((dataLen & BL_PACKET_SPARSE_FLAG) != 0U) ? BL_PACKET_KIND_ERASED :
+                                                                            BL_PACKET_KIND_COPY;
+        ctxPacket->runLen     = dataLen & ~BL_PACKET_RUN_FLAGS;
+        ctxPacket->packetLen  = 8U;
+        ctxPacket->packetData = &buff[0];
+    }
+    else
+    {
+        /* Data: RX frame içindeki yerine işaret edilir (kopya yok) */
+        ctxPacket->packetKind = BL_PACKET_KIND_DATA;
+        ctxPacket->runLen     = 0U;
+        ctxPacket->packetLen  = (uint16_t)dataLen;
+        ctxPacket->packetData = &buff[8];
     }
 
     /* CRC32 */
@@ -1070,53 +1639,2002 @@ void Bootloader_Packet_Parser(bl_update_packet_t *ctxPacket, uint8_t *buff, uint
  * Local Helper Functions
  * ========================================================= */
 
+#if (BL_BANK_SWAP_BOOT == 1)
 /**
- * @brief Check application vector table integrity
+ * @brief Make sure the other bank starts with this bootloader before swapping banks
  *
- * @param[in] appBase  Application flash base address
- * @return true  Vector table valid
- * @return false Vector table invalid
+ * After the swap the device boots from the other bank, so its first
+ * BL_BOOTLOADER_SIZE bytes must hold an identical bootloader. The copy is
+ * programmed only when it differs.
+ *
+ * @return true if both banks hold the same bootloader
  */
-static bool BL_IsVectorTableSane(uint32_t appBase)
+static bool BL_BankSwap_MirrorBootloader(void)
 {
-    uint32_t msp;
-    uint32_t rst;
+    const uint8_t *self   = (const uint8_t *)FLASH_BASE;
+    uint32_t       mirror = FLASH_BASE + BL_FLASH_BANK_SIZE;
 
-    msp = *(volatile uint32_t *)(appBase);
-    rst = *(volatile uint32_t *)(appBase + 4U);
+    if (memcmp(self, (const uint8_t *)mirror, BL_BOOTLOADER_SIZE) == 0)
+    {
+        return true;
+    }
 
-    if ((msp < BL_SRAM_BASE) || (msp > BL_SRAM_END))
+    if ((Flash_EraseRange(mirror, BL_BOOTLOADER_SIZE) != true) ||
+        (Flash_Write(mirror, self, BL_BOOTLOADER_SIZE) != true))
     {
         return false;
     }
 
-    if ((rst < appBase) || (rst > (appBase + 0x200000UL)))
+    return (memcmp(self, (const uint8_t *)mirror, BL_BOOTLOADER_SIZE) == 0);
+}
+
+/**
+ * @brief Prepare a SWAP_BANK toggle: write the metadata that is valid after the swap
+ *
+ * The swap exchanges the banks in the address map, so after reset SLOT_A
+ * holds newActive and SLOT_B the image that runs now (kept for rollback).
+ * The record is written to the other bank's metadata area, which becomes
+ * META_FLASH_ADDR after the swap. The toggle itself is done in
+ * BL_STATE_JUMP once the last USB message is sent.
+ *
+ * @param[in,out] ctx        Bootloader context pointer
+ * @param[in,out] meta       Current metadata, turned into the post-swap record
+ * @param[in]     newActive  Image that will appear at SLOT_A after the swap
+ * @return true on success
+ */
+static bool BL_BankSwap_Prepare(BootloaderCtx_t *ctx, meta_record_t *meta, const meta_slot_info_t *newActive)
+{
+    meta_slot_info_t previous = meta->slotA;
+
+    if (BL_BankSwap_MirrorBootloader() != true)
     {
         return false;
     }
 
-    if ((rst & 0x1U) == 0U)
+    meta->slotA          = *newActive;
+    meta->slotB          = previous;
+    meta->active_slot    = META_SLOT_A;
+    meta->target_slot    = META_SLOT_B;
+    meta->update_state   = META_UPDATE_IDLE;
+    meta->progress_bytes = 0U;
+    meta->progress_crc32 = 0U;
+    meta->seq++;
+
+    if (Meta_WriteAt(META_MIRROR_FLASH_ADDR, meta) != true)
     {
         return false;
     }
 
+    ctx->bank_swap_pending = true;
+
     return true;
 }
+#endif
 
 /**
- * @brief Perform low-level application jump
+ * @brief EXIT_BOOTLOADER command (no action defined yet)
  *
- * Transfers execution from bootloader to application safely.
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_ExitBootloader(BootloaderCtx_t *ctx)
+{
+	(void)ctx;
+
+	// Bootloader dan çıkar...
+}
+
+/**
+ * @brief SHUTDOWN_DEVICE command
  *
- * @param[in] appBase  Application flash base address
+ * @param[in,out] ctx  Bootloader context pointer
  */
-static void BL_Jump(uint32_t appBase)
+static void BL_Cmd_Shutdown(BootloaderCtx_t *ctx)
 {
-    uint32_t appStack;   /* Application'ın başlangıç Main Stack Pointer değeri */
-    uint32_t appEntry;   /* Application'ın Reset_Handler (giriş noktası) adresi */
+	ctx->state = BL_STATE_SHUTDOWN;
+}
 
-    appStack = *(volatile uint32_t *)(appBase);        /* Vector table [0]: initial MSP */
-    appEntry = *(volatile uint32_t *)(appBase + 4U);   /* Vector table [1]: reset handler */
+/**
+ * @brief GO_APPLICATION command: jump if an application exists, shut down otherwise
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_GoApplication(BootloaderCtx_t *ctx)
+{
+	// VARSA Application koduna atlar yoksa cihaz kapanır...
+	if(ctx->meta.active_slot != META_SLOT_NONE)
+		ctx->state = BL_STATE_JUMP;
+	else
+		ctx->state = BL_STATE_SHUTDOWN;
+}
+
+/**
+ * @brief RESET_DEVICE command
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_ResetDevice(BootloaderCtx_t *ctx)
+{
+	(void)ctx;
+
+	// Süren flash işi yarıda kesilmez...
+	(void)Flash_Async_Wait();
+
+	// Cihaza reset atar...
+	HAL_NVIC_SystemReset();
+}
+
+/**
+ * @brief UPDATE_STATS command: report the counters of the last transfer
+ *
+ * Reply (9 x uint32, LE): requestsSent | retransmits | packetsReceived |
+ * crcErrors | bytesCommitted | flashWriteMs | finalCrcMs | transfer time
+ * (PACKET_INFO -> last commit, ms) | first packet latency (PACKET_INFO ->
+ * first SEND_PACKET, ms). Counters are cleared when PACKET_INFO is accepted,
+ * so the reply describes the transfer in progress or the last one.
+ *
+ * @param[in] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_ReportStats(BootloaderCtx_t *ctx)
+{
+	const bl_update_stats_t *stats = &ctx->update_stats;
+	uint32_t				 values[9];
+	uint8_t					 payload[sizeof(values)];
+
+	values[0] = stats->requestsSent;
+	values[1] = stats->retransmits;
+	values[2] = stats->packetsReceived;
+	values[3] = stats->crcErrors;
+	values[4] = stats->bytesCommitted;
+	values[5] = stats->flashWriteMs;
+	values[6] = stats->finalCrcMs;
+	values[7] = (stats->lastCommitTick != 0U) ? (stats->lastCommitTick - stats->infoTick) : 0U;
+	values[8] = (stats->firstPacketTick != 0U) ? (stats->firstPacketTick - stats->infoTick) : 0U;
+
+	for (uint8_t i = 0U; i < 9U; i++)
+	{
+		payload[(i * 4U) + 0U] = (uint8_t)(values[i]);
+		payload[(i * 4U) + 1U] = (uint8_t)(values[i] >> 8);
+		payload[(i * 4U) + 2U] = (uint8_t)(values[i] >> 16);
+		payload[(i * 4U) + 3U] = (uint8_t)(values[i] >> 24);
+	}
+
+	(void)USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE,
+							   USB_FIRMWARE_UPDATE_STATS,
+							   0,
+							   sizeof(payload),
+							   payload);
+
+	/* Frame RECEIVE_DATA'ya kadar tutulursa cevap her turda tekrar gönderilirdi */
+	USB_Rx_Release_Frame(&usbRxFrame);
+}
+
+/**
+ * @brief STATUS_REQ command: the host is present, start announcing READY
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_StatusRequest(BootloaderCtx_t *ctx)
+{
+	ctx->updateState = BL_UPDATE_READY;
+}
+
+/**
+ * @brief PACKET_INFO command: store the image description and check it next
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_PacketInfo(BootloaderCtx_t *ctx)
+{
+	uint8_t *rx;
+
+	/* RX data pointer */
+	rx = usbRxFrame.data;
+
+	/* Güvenlik: uzunluk kontrolü */
+	if (usbRxFrame.data_len >= 13U)
+	{
+		bl_update_info_t *info = &ctx->update_info;
+
+		/* fw_size_bytes */
+		info->fw_size_bytes =
+			  ((uint32_t)rx[0])
+			| ((uint32_t)rx[1] << 8)
+			| ((uint32_t)rx[2] << 16)
+			| ((uint32_t)rx[3] << 24);
+
+		/* fw_crc32 */
+		info->fw_crc32 =
+			  ((uint32_t)rx[4])
+			| ((uint32_t)rx[5] << 8)
+			| ((uint32_t)rx[6] << 16)
+			| ((uint32_t)rx[7] << 24);
+
+		/* fw_format */
+		info->fw_format = (bl_fw_format_t)rx[8];
+
+		/* fw_version */
+		info->fw_version.major = rx[11];
+		info->fw_version.minor = rx[10];
+		info->fw_version.patch = rx[9];
+
+		ctx->update_info.fw_version = info->fw_version;
+
+		/* Pencere derinliği: 0/1 = stop-and-wait, >1 = aynı anda bekleyen talep sayısı */
+		ctx->update_window.depth = (uint8_t)(rx[12] & ~BL_UPDATE_WINDOW_PUSH_FLAG);
+		info->push_mode			 = ((rx[12] & BL_UPDATE_WINDOW_PUSH_FLAG) != 0U);
+
+		/* Blok boyutu (opsiyonel, 13..16): yoksa BL_UPDATE_CHUNK_SIZE */
+		if (usbRxFrame.data_len >= 17U)
+		{
+			info->chunk_size = BL_NegotiateChunkSize(
+				  ((uint32_t)rx[13])
+				| ((uint32_t)rx[14] << 8)
+				| ((uint32_t)rx[15] << 16)
+				| ((uint32_t)rx[16] << 24));
+		}
+		else
+		{
+			info->chunk_size = BL_NegotiateChunkSize(0U);
+		}
+
+		/* LZ4/DELTA: yazılacak imaj boyutu (17..20) zorunlu, BIN'de transfer boyutuyla aynı */
+		info->image_size_bytes = info->fw_size_bytes;
+		info->base_crc32	   = 0U;
+
+		if ((info->fw_format == BL_FW_FORMAT_LZ4) ||
+			(info->fw_format == BL_FW_FORMAT_DELTA))
+		{
+			if (usbRxFrame.data_len >= 21U)
+			{
+				info->image_size_bytes =
+					  ((uint32_t)rx[17])
+					| ((uint32_t)rx[18] << 8)
+					| ((uint32_t)rx[19] << 16)
+					| ((uint32_t)rx[20] << 24);
+			}
+			else
+			{
+				info->image_size_bytes = 0U;
+			}
+		}
+
+		/* DELTA: patch'in üretildiği kaynak imajın CRC32'si (21..24) */
+		if (info->fw_format == BL_FW_FORMAT_DELTA)
+		{
+			if (usbRxFrame.data_len >= 25U)
+			{
+				info->base_crc32 =
+					  ((uint32_t)rx[21])
+					| ((uint32_t)rx[22] << 8)
+					| ((uint32_t)rx[23] << 16)
+					| ((uint32_t)rx[24] << 24);
+			}
+			else
+			{
+				info->image_size_bytes = 0U;
+			}
+		}
+
+		/* State ilerlet */
+		ctx->updateState = BL_UPDATE_CHECK_INFO;
+	}
+	else
+	{
+		/* Paket eksik / hatalı */
+		ctx->updateState = BL_UPDATE_ERROR;
+	}
+}
+
+/**
+ * @brief FLASH_ERASE command: erase both slots and record that no application exists
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_FlashErase(BootloaderCtx_t *ctx)
+{
+	/* -------------------------------------------------
+	 * SLOT A / SLOT B ERASE
+	 * Her slot kendi bankında tek çok sayfalı işlemle silinir
+	 * (Slot A: bank 1, Slot B: bank 2)
+	 * ------------------------------------------------- */
+	if ((Flash_EraseRange(SLOT_B_BASE_ADDR, (SLOT_B_END_ADDR - SLOT_B_BASE_ADDR) + 1U) != true) ||
+		(Flash_EraseRange(SLOT_A_BASE_ADDR, (SLOT_A_END_ADDR - SLOT_A_BASE_ADDR) + 1U) != true))
+	{
+		ctx->error = BL_ERR_FLASH_WRITE;
+		//ctx->state = BL_STATE_ERROR;
+		return;
+	}
+
+	/* -------------------------------------------------
+	 * 2) Metadata güncelle (iki slot da boş)
+	 *    - Tutarlı bir meta record yaz (CRC dahil)
+	 * ------------------------------------------------- */
+	{
+		meta_record_t m;
+		memset(&m, 0, sizeof(m));
+
+		/* "Temiz + boş" meta kaydı oluştur */
+		m.magic        = META_MAGIC;
+		m.seq          = (ctx->meta.seq == 0xFFFFFFFFu || ctx->meta.seq == 0u) ? 1u : (ctx->meta.seq + 1u);
+
+		/* Her iki slot boş: valid=0 */
+		m.slotA.valid  = 0u;
+		m.slotB.valid  = 0u;
+		m.progress_bytes = 0u;
+
+		/* Sanity check’lerden geçsin diye A/B set ediyoruz,
+		   ama state NO_APP ile “geçerli app yok” bilgisini veriyoruz. */
+		m.active_slot  = META_SLOT_A;
+		m.target_slot  = META_SLOT_B;
+		m.update_state = META_UPDATE_NO_APP;
+
+		/* Journal'a eklenir: yazma yarım kalırsa önceki kayıt geçerli kalır */
+		if (Meta_Write(&m) != true)
+		{
+			ctx->error = BL_ERR_FLASH_WRITE;
+			ctx->state = BL_STATE_ERROR;
+			return;
+		}
+
+		/* RAM'deki meta’yı da senkronla */
+		ctx->meta = m;
+	}
+
+	/* -------------------------------------------------
+	 * 3) Hedef slotu SLOT A olarak işaretle
+	 * ------------------------------------------------- */
+	ctx->update_target_info.g_target_slot      = BL_SLOT_A;
+	ctx->update_target_info.g_target_base_addr = SLOT_A_BASE_ADDR;
+	ctx->update_target_info.g_target_end_addr  = SLOT_A_END_ADDR;
+}
+
+/**
+ * @brief PAGE_MANIFEST command: reply with the page CRC32s of the active slot
+ *
+ * @param[in] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_PageManifest(BootloaderCtx_t *ctx)
+{
+	/* Host değişmeyen sayfaları bulmak için aktif slotun sayfa CRC'lerini ister */
+	if (BL_SendPageManifest(ctx, usbRxFrame.data, usbRxFrame.data_len) != true)
+	{
+		/* TX kuyruğu dolu: istek saklanır, REQUEST_UPDATE_INFO sonraki turlarda cevabı tekrar dener */
+		memcpy(ctx->manifest_request, usbRxFrame.data, sizeof(ctx->manifest_request));
+		ctx->manifest_pending = true;
+	}
+}
+
+/**
+ * @brief SEND_PACKET command: hand a data packet that matches a request to VERIFY
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Cmd_SendPacket(BootloaderCtx_t *ctx)
+{
+	uint8_t *rx;
+	uint16_t rxLen;
+	int8_t   slotIndex;
+
+	/* RX data pointer */
+	rx 	  = usbRxFrame.data;
+	rxLen = usbRxFrame.data_len;
+
+	/*
+	 * Gelen paketin adresi bekleyen taleplerden biriyle eşleşmeli.
+	 * Paketler sırasız gelebilir; eşleşmeyen (geç kalmış / tekrar) paketler yok sayılır.
+	 */
+	bool runAllowed = (ctx->update_info.fw_format == BL_FW_FORMAT_BIN);
+
+	slotIndex = BL_Window_MatchPacket(&ctx->update_window,
+									  rx,
+									  rxLen,
+									  runAllowed ? ctx->update_info.fw_size_bytes : 0U,
+									  (runAllowed && (BL_GetSourceBase(ctx) != 0U)) ?
+											ctx->update_info.fw_size_bytes : 0U);
+
+	if (slotIndex >= 0)
+	{
+		bl_window_slot_t *slot = &ctx->update_window.slot[slotIndex];
+
+		if (ctx->update_stats.packetsReceived++ == 0U)
+		{
+			ctx->update_stats.firstPacketTick = HAL_GetTick();
+		}
+
+		/*
+		 * Gelen data içerisinden ilk ctx->update_packet_info.requestedDataLength kadarı veriyi
+		 * ondan sonraki 4 byte ise CRC32 yi içermektedir. İlk olarak crc32 kontorlünün yapılması gerekir.
+		 *
+		 * Veri kopyalanmaz: frame flash'a yazılana kadar slot tarafından tutulur.
+		 */
+		Bootloader_Packet_Parser(&slot->packet,
+								 rx,
+								 rxLen);
+
+		slot->frame 	 = usbRxFrame;
+		memset(&usbRxFrame, 0, sizeof(usbRxFrame));
+
+		ctx->update_window.activeSlot = (uint8_t)slotIndex;
+		ctx->updateState 			  = BL_UPDATE_VERIFY;
+	}
+}
+
+/**
+ * @brief Run the update command in usbRxFrame if the current update state allows it
+ *
+ * The frame is released afterwards unless the handler kept it.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true  A handler ran
+ * @return false No frame, unknown command or not allowed in this state
+ */
+static bool BL_Update_Dispatch(BootloaderCtx_t *ctx)
+{
+	const bl_update_command_t *command = NULL;
+	bool 					   handled = false;
+
+	if (usbRxFrame.valid == 0)
+	{
+		return false;
+	}
+
+	if ((usbRxFrame.packet_type == USB_PACKET_FIRMWARE_UPDATE) &&
+		((uint32_t)usbRxFrame.command_id < USB_RX_COMMAND_ID_COUNT))
+	{
+		command = &blUpdateCommands[usbRxFrame.command_id];
+	}
+
+	if ((command != NULL) && (command->handler != NULL) &&
+		((command->allowedStates & BL_UPDATE_STATE_BIT(ctx->updateState)) != 0U))
+	{
+		command->handler(ctx);
+		handled = true;
+	}
+
+	/* SEND_PACKET eşleşen frame'i pencere slotuna aldıysa usbRxFrame boştur */
+	USB_Rx_Release_Frame(&usbRxFrame);
+
+	return handled;
+}
+
+/**
+ * @brief Check whether an unprocessed RX frame must be kept for RECEIVE_DATA
+ *
+ * In windowed mode the host may answer several GET_PACKET requests back to
+ * back; a SEND_PACKET arriving while the state machine verifies or programs
+ * another packet is held instead of being dropped. RECEIVE_DATA itself also
+ * keeps the frame: a frame held through the other states reaches it only at
+ * the start of the next turn, and RECEIVE_DATA releases what it does not use.
+ *
+ * @param[in] ctx  Bootloader context pointer
+ * @return true  Frame is kept
+ * @return false Frame can be released
+ */
+static bool BL_IsRxFramePending(const BootloaderCtx_t *ctx)
+{
+    if (ctx->state != BL_STATE_UPDATE_MODE)
+    {
+        return false;
+    }
+
+    switch (ctx->updateState)
+    {
+        case BL_UPDATE_REQUEST_UPDATE_INFO:
+            return ctx->manifest_pending;
+
+        case BL_UPDATE_REQUEST_PACKET:
+        case BL_UPDATE_RECEIVE_DATA:
+        case BL_UPDATE_VERIFY:
+        case BL_UPDATE_WRITE_FLASH:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * @brief Clamp the block size proposed by the host to what the bootloader accepts
+ *
+ * The result lies between BL_UPDATE_CHUNK_SIZE_MIN and BL_UPDATE_CHUNK_SIZE_MAX
+ * and is a multiple of BL_UPDATE_CHUNK_ALIGN so every block starts on a flash
+ * quad-word boundary.
+ *
+ * @param[in] requested  Block size from PACKET_INFO (0 = not proposed)
+ * @return Agreed block size in bytes
+ */
+static uint32_t BL_NegotiateChunkSize(uint32_t requested)
+{
+    if (requested == 0U)
+    {
+        return BL_UPDATE_CHUNK_SIZE;
+    }
+
+    if (requested > BL_UPDATE_CHUNK_SIZE_MAX)
+    {
+        requested = BL_UPDATE_CHUNK_SIZE_MAX;
+    }
+    else if (requested < BL_UPDATE_CHUNK_SIZE_MIN)
+    {
+        requested = BL_UPDATE_CHUNK_SIZE_MIN;
+    }
+
+    return requested - (requested % BL_UPDATE_CHUNK_ALIGN);
+}
+
+/**
+ * @brief Reset sliding-window transfer bookkeeping
+ *
+ * @param[out] window  Window structure
+ * @param[in]  depth   Requested number of outstanding packets (0 treated as 1)
+ */
+static void BL_Window_Reset(bl_update_window_t *window, uint8_t depth)
+{
+    /* Yeni transfer başlamadan süren flash işleri tamamlanır */
+    (void)Flash_Async_Wait();
+
+    /* Slotlarda tutulan RX frame'ler havuza geri verilir */
+    for (uint8_t i = 0; i < BL_UPDATE_WINDOW_MAX; i++)
+    {
+        USB_Rx_Release_Frame(&window->slot[i].frame);
+    }
+
+    memset(window, 0, sizeof(bl_update_window_t));
+
+    if (depth == 0U)
+    {
+        depth = 1U;
+    }
+    else if (depth > BL_UPDATE_WINDOW_MAX)
+    {
+        depth = BL_UPDATE_WINDOW_MAX;
+    }
+
+    window->depth = depth;
+}
+
+/**
+ * @brief Send a single GET_PACKET request for a window slot
+ *
+ * @param[in,out] slot  Window slot (offset / length already assigned)
+ * @return true  Request queued for transmission
+ * @return false TX queue full, request not queued
+ */
+static bool BL_Window_SendRequest(bl_window_slot_t *slot)
+{
+	uint8_t packet[8] 	= {0};
+	uint16_t dataLength = 8;
+
+	packet[0] = (uint8_t)( slot->offset >> 24 & 0xFF);
+	packet[1] = (uint8_t)( slot->offset >> 16 & 0xFF);
+	packet[2] = (uint8_t)( slot->offset >> 8  & 0xFF);
+	packet[3] = (uint8_t)( slot->offset >> 0  & 0xFF);
+	packet[4] = (uint8_t)( slot->length >> 24 & 0xFF);
+	packet[5] = (uint8_t)( slot->length >> 16 & 0xFF);
+	packet[6] = (uint8_t)( slot->length >> 8  & 0xFF);
+	packet[7] = (uint8_t)( slot->length >> 0  & 0xFF);
+
+	uint8_t transmitStatus = USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE,
+												  USB_FIRMWARE_UPDATE_GET_PACKET,
+												  0,
+												  dataLength,
+												  packet);
+
+	if (transmitStatus != USBD_OK)
+	{
+		return false;
+	}
+
+	slot->state 	  = BL_WINDOW_SLOT_REQUESTED;
+	slot->requestTick = HAL_GetTick();
+
+	return true;
+}
+
+/**
+ * @brief Issue GET_PACKET requests for free and timed-out window slots
+ *
+ * Re-sends requests whose answer did not arrive within
+ * BL_UPDATE_WINDOW_TIMEOUT_MS first, then fills free slots with the next
+ * offsets of the image until the window depth is reached.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true  Requests issued (or nothing to request)
+ * @return false A slot exceeded its retry limit
+ */
+static bool BL_Window_RequestPackets(BootloaderCtx_t *ctx)
+{
+    bl_update_window_t *window = &ctx->update_window;
+    uint32_t now = HAL_GetTick();
+
+    /* 1) Timed-out requests: selective retransmit */
+    for (uint8_t i = 0U; i < window->depth; i++)
+    {
+        bl_window_slot_t *slot = &window->slot[i];
+
+        if ((slot->state == BL_WINDOW_SLOT_REQUESTED) &&
+            ((now - slot->requestTick) >= BL_UPDATE_WINDOW_TIMEOUT_MS))
+        {
+            if (slot->packet.requestCounter >= BL_UPDATE_REQUEST_RETRY_MAX)
+            {
+                return false;
+            }
+
+            slot->packet.requestCounter += 1U;
+
+            if (BL_Window_SendRequest(slot) != true)
+            {
+                /* USB meşgul: bir sonraki turda tekrar denenecek */
+                return true;
+            }
+
+            ctx->update_stats.requestsSent += 1U;
+            ctx->update_stats.retransmits  += 1U;
+        }
+    }
+
+    /* 2) Free slots: request next offsets in order */
+    for (uint8_t i = 0U; i < window->depth; i++)
+    {
+        bl_window_slot_t *slot = &window->slot[i];
+
+        if (window->nextRequestOffset >= ctx->update_info.fw_size_bytes)
+        {
+            break;
+        }
+
+        if (slot->state != BL_WINDOW_SLOT_FREE)
+        {
+            continue;
+        }
+
+        slot->offset = window->nextRequestOffset;
+        slot->length = ctx->update_info.fw_size_bytes - slot->offset;
+
+        if (slot->length > ctx->update_info.chunk_size)
+        {
+            slot->length = ctx->update_info.chunk_size;
+        }
+
+        slot->packet.requestCounter = 0U;
+
+        if (ctx->update_info.push_mode == true)
+        {
+            /* Host bu offset'i zaten sırayla gönderiyor: talep mesajı yok, yalnızca zaman aşımı için işaretle */
+            slot->state       = BL_WINDOW_SLOT_REQUESTED;
+            slot->requestTick = now;
+        }
+        else if (BL_Window_SendRequest(slot) != true)
+        {
+            break;
+        }
+        else
+        {
+            ctx->update_stats.requestsSent += 1U;
+        }
+
+        window->nextRequestOffset += slot->length;
+
+        ctx->update_packet_info.currentAddress      = slot->offset;
+        ctx->update_packet_info.requestedDataLength = slot->length;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Find the window slot holding a given offset in a given state
+ *
+ * @param[in] window  Window structure
+ * @param[in] offset  Image offset
+ * @param[in] state   Required slot state
+ * @return Slot pointer or NULL
+ */
+static bl_window_slot_t *BL_Window_FindSlot(bl_update_window_t *window,
+                                            uint32_t offset,
+                                            bl_window_slot_state_t state)
+{
+    for (uint8_t i = 0U; i < window->depth; i++)
+    {
+        if ((window->slot[i].state == state) && (window->slot[i].offset == offset))
+        {
+            return &window->slot[i];
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Match a received SEND_PACKET payload against outstanding requests
+ *
+ * Payload layout: addr(4, BE) | len(4, BE) | data(len) | crc32(4, BE)
+ *
+ * @param[in] window     Window structure
+ * @param[in] rx         Received payload (addr, len, data, crc)
+ * @param[in] rxLen      Received payload length
+ * @param[in] sparseEnd  Image end a sparse run may reach (0 = sparse not allowed)
+ * @param[in] copyEnd    Image end a copy run may reach (0 = copy not allowed)
+ * @return Slot index, or -1 when the packet does not match a request or its
+ *         length does not equal the length field plus BL_PACKET_OVERHEAD
+ */
+static int8_t BL_Window_MatchPacket(bl_update_window_t *window,
+                                    const uint8_t *rx,
+                                    uint16_t rxLen,
+                                    uint32_t sparseEnd,
+                                    uint32_t copyEnd)
+{
+    uint32_t addr;
+    uint32_t len;
+    uint32_t flags;
+    uint32_t runEnd;
+
+    if (rxLen < BL_PACKET_OVERHEAD)
+    {
+        return -1;
+    }
+
+    addr = ((uint32_t)rx[0] << 24) | ((uint32_t)rx[1] << 16) |
+           ((uint32_t)rx[2] << 8)  |  (uint32_t)rx[3];
+    len  = ((uint32_t)rx[4] << 24) | ((uint32_t)rx[5] << 16) |
+           ((uint32_t)rx[6] << 8)  |  (uint32_t)rx[7];
+
+    flags = len & BL_PACKET_RUN_FLAGS;
+    len  &= ~BL_PACKET_RUN_FLAGS;
+
+    if (flags == BL_PACKET_SPARSE_FLAG)
+    {
+        runEnd = sparseEnd;
+    }
+    else if (flags == BL_PACKET_COPY_FLAG)
+    {
+        runEnd = copyEnd;
+    }
+    else
+    {
+        runEnd = 0U;
+    }
+
+    for (uint8_t i = 0U; i < window->depth; i++)
+    {
+        bl_window_slot_t *slot = &window->slot[i];
+
+        if ((slot->state  != BL_WINDOW_SLOT_REQUESTED) ||
+            (slot->offset != addr))
+        {
+            continue;
+        }
+
+        if (flags == 0U)
+        {
+            /* Uzunluk alanı ile paket boyu tam tutmalı; fazlası/eksiği bozuk pakettir */
+            if ((slot->length == len) &&
+                ((uint32_t)rxLen == (len + BL_PACKET_OVERHEAD)))
+            {
+                return (int8_t)i;
+            }
+        }
+        /*
+         * 0xFF / kopya aralığı en az talep edilen bloğu kapsamalı, imaj içinde kalmalı ve
+         * sonraki blok quad-word hizasında başlamalı (imaj sonu hariç)
+         */
+        else if (((uint32_t)rxLen == BL_PACKET_OVERHEAD) &&
+                 (runEnd > addr) &&
+                 (len >= slot->length) &&
+                 (len <= (runEnd - addr)) &&
+                 (((len % BL_UPDATE_CHUNK_ALIGN) == 0U) || ((addr + len) == runEnd)))
+        {
+            return (int8_t)i;
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief Drop the window requests an accepted run makes obsolete
+ *
+ * Blocks inside the run are covered by it (erased target or copied pages).
+ * Blocks after it were requested on the old chunk grid, while the host
+ * continues from the run end (a run is cut to a quad-word, not to a chunk),
+ * so they are dropped too and requests restart at the run end. Late answers
+ * for dropped slots no longer match a request and are ignored.
+ *
+ * @param[in,out] window  Window structure
+ * @param[in]     keep    Slot that owns the run (left untouched)
+ * @param[in]     start   Start of the run
+ * @param[in]     end     End of the run (exclusive)
+ */
+static void BL_Window_SkipRange(bl_update_window_t *window,
+                                const bl_window_slot_t *keep,
+                                uint32_t start,
+                                uint32_t end)
+{
+    for (uint8_t i = 0U; i < window->depth; i++)
+    {
+        bl_window_slot_t *slot = &window->slot[i];
+
+        if ((slot != keep) &&
+            (slot->state != BL_WINDOW_SLOT_FREE) &&
+            (slot->offset >= start))
+        {
+            USB_Rx_Release_Frame(&slot->frame);
+            slot->state = BL_WINDOW_SLOT_FREE;
+        }
+    }
+
+    window->nextRequestOffset = end;
+}
+
+/**
+ * @brief Base address of the slot unchanged pages can be copied from
+ *
+ * Only the active slot qualifies, and only when metadata marks it valid and
+ * it is not the slot being written.
+ *
+ * @param[in] ctx  Bootloader context pointer
+ * @return Active slot base address, or 0 when it holds no usable image
+ */
+static uint32_t BL_GetSourceBase(const BootloaderCtx_t *ctx)
+{
+    const meta_slot_info_t *info;
+    uint32_t               base;
+
+    if (ctx->meta.active_slot == META_SLOT_A)
+    {
+        info = &ctx->meta.slotA;
+    }
+    else if (ctx->meta.active_slot == META_SLOT_B)
+    {
+        info = &ctx->meta.slotB;
+    }
+    else
+    {
+        return 0U;
+    }
+
+    base = Meta_SlotToBaseAddr(ctx->meta.active_slot);
+
+    if ((info->valid == 0U) || (base == ctx->update_target_info.g_target_base_addr))
+    {
+        return 0U;
+    }
+
+    return base;
+}
+
+/**
+ * @brief Answer a PAGE_MANIFEST request with CRC32s of active slot pages
+ *
+ * Reply: first page (2, BE) | count (1) | count x CRC32 (4, BE) over whole
+ * _FLASH_PAGE_SIZE pages. The host compares them with its 0xFF-padded image
+ * and answers GET_PACKET for matching pages with a COPY run. Count is 0 when
+ * there is no usable source slot or the range is outside the slot.
+ *
+ * @param[in] ctx    Bootloader context pointer
+ * @param[in] rx     Request payload: first page (2, BE) | count (1)
+ * @param[in] rxLen  Request payload length
+ * @return true  Reply queued (or request too short to answer)
+ * @return false TX queue full, reply not queued
+ */
+static bool BL_SendPageManifest(const BootloaderCtx_t *ctx, const uint8_t *rx, uint16_t rxLen)
+{
+    const uint32_t slotPages = BL_SLOT_SIZE / _FLASH_PAGE_SIZE;
+
+    uint8_t  reply[3U + (BL_MANIFEST_PAGES_PER_MSG * 4U)] = {0};
+    uint32_t source = BL_GetSourceBase(ctx);
+    uint32_t firstPage;
+    uint8_t  count;
+
+    if (rxLen < 3U)
+    {
+        return true;
+    }
+
+    firstPage = ((uint32_t)rx[0] << 8) | (uint32_t)rx[1];
+    count     = rx[2];
+
+    if (count > BL_MANIFEST_PAGES_PER_MSG)
+    {
+        count = BL_MANIFEST_PAGES_PER_MSG;
+    }
+
+    if ((source == 0U) || (firstPage >= slotPages))
+    {
+        count = 0U;
+    }
+    else if (count > (slotPages - firstPage))
+    {
+        count = (uint8_t)(slotPages - firstPage);
+    }
+
+    reply[0] = rx[0];
+    reply[1] = rx[1];
+    reply[2] = count;
+
+    for (uint8_t i = 0U; i < count; i++)
+    {
+        uint32_t crc = CRC32_Calculate((const uint8_t *)(source + ((firstPage + i) * _FLASH_PAGE_SIZE)),
+                                       _FLASH_PAGE_SIZE);
+
+        reply[3U + (i * 4U)] = (uint8_t)(crc >> 24 & 0xFF);
+        reply[4U + (i * 4U)] = (uint8_t)(crc >> 16 & 0xFF);
+        reply[5U + (i * 4U)] = (uint8_t)(crc >> 8  & 0xFF);
+        reply[6U + (i * 4U)] = (uint8_t)(crc >> 0  & 0xFF);
+    }
+
+    return (USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE,
+                                 USB_FIRMWARE_UPDATE_PAGE_MANIFEST,
+                                 0,
+                                 (uint16_t)(3U + (count * 4U)),
+                                 reply) == USBD_OK);
+}
+
+/**
+ * @brief Check whether any outstanding request has timed out
+ *
+ * @param[in] window  Window structure
+ * @return true  At least one request needs to be re-sent
+ */
+static bool BL_Window_IsTimedOut(const bl_update_window_t *window)
+{
+    uint32_t now = HAL_GetTick();
+
+    for (uint8_t i = 0U; i < window->depth; i++)
+    {
+        if ((window->slot[i].state == BL_WINDOW_SLOT_REQUESTED) &&
+            ((now - window->slot[i].requestTick) >= BL_UPDATE_WINDOW_TIMEOUT_MS))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Push mode: report the committed offset to the host about twice per window
+ *
+ * The host keeps at most one window of blocks in flight beyond the last
+ * reported offset, so a report every half window keeps it streaming
+ * without a round trip per block. The final offset is always reported.
+ * A report that does not fit the TX queue is retried on the next commit.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Window_ReportProgress(BootloaderCtx_t *ctx)
+{
+    bl_update_window_t *window   = &ctx->update_window;
+    uint32_t           interval  = (((uint32_t)window->depth + 1U) / 2U) * ctx->update_info.chunk_size;
+    uint8_t            packet[4] = {0};
+
+    if (window->commitOffset == window->reportedOffset)
+    {
+        return;
+    }
+
+    if (((window->commitOffset - window->reportedOffset) < interval) &&
+        (window->commitOffset < ctx->update_info.fw_size_bytes))
+    {
+        return;
+    }
+
+    packet[0] = (uint8_t)(window->commitOffset >> 24 & 0xFF);
+    packet[1] = (uint8_t)(window->commitOffset >> 16 & 0xFF);
+    packet[2] = (uint8_t)(window->commitOffset >> 8  & 0xFF);
+    packet[3] = (uint8_t)(window->commitOffset >> 0  & 0xFF);
+
+    if (USB_Transmit_Message(USB_PACKET_FIRMWARE_UPDATE,
+                             USB_FIRMWARE_UPDATE_PROGRESS,
+                             0,
+                             sizeof(packet),
+                             packet) == USBD_OK)
+    {
+        window->reportedOffset = window->commitOffset;
+    }
+}
+
+/**
+ * @brief Program a block to flash, retrying up to BL_FLASH_WRITE_RETRY_COUNT times
+ *
+ * @param[in] address  Flash address (16-byte aligned)
+ * @param[in] data     Source data
+ * @param[in] length   Number of bytes
+ * @return true on success
+ */
+static bool BL_Flash_WriteRetry(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    bool    flash_status = false;
+    uint8_t retry_cnt    = 0U;
+
+    while ((flash_status == false) && (retry_cnt < BL_FLASH_WRITE_RETRY_COUNT))
+    {
+        flash_status = Flash_Write(address, data, length);
+        retry_cnt++;
+    }
+
+    return flash_status;
+}
+
+/**
+ * @brief Erase a page-aligned range of the target slot
+ *
+ * @param[in] ctx     Bootloader context pointer
+ * @param[in] offset  Slot offset of the first page
+ * @param[in] length  Number of bytes (rounded up to whole pages)
+ * @return true on success
+ */
+static bool BL_EraseTargetRange(const BootloaderCtx_t *ctx, uint32_t offset, uint32_t length)
+{
+    if (length == 0U)
+    {
+        return true;
+    }
+
+    /* Bank / sayfa eşlemesi slot adresinden yapılır (Slot A: bank 1, Slot B: bank 2) */
+    return Flash_EraseRange(ctx->update_target_info.g_target_base_addr + offset, length);
+}
+
+/**
+ * @brief Erase target slot pages up to (and including) the page holding endOffset - 1
+ *
+ * Writes reach the slot in increasing offset order, so a single erase mark is
+ * enough. Pages past the image are never erased.
+ *
+ * @param[in,out] ctx        Bootloader context pointer
+ * @param[in]     endOffset  Slot offset the next write ends at (exclusive)
+ * @return true on success
+ */
+static bool BL_Target_EnsureErased(BootloaderCtx_t *ctx, uint32_t endOffset)
+{
+    bl_target_info_t *target = &ctx->update_target_info;
+
+    /* Kuyruktaki silme / programlama işleri bitmeden flash'a doğrudan erişilmez */
+    if (BL_Target_Sync(ctx) != true)
+    {
+        return false;
+    }
+
+    while (target->erasedOffset < endOffset)
+    {
+        if (BL_EraseTargetRange(ctx, target->erasedOffset, _FLASH_PAGE_SIZE) != true)
+        {
+            return false;
+        }
+
+        target->erasedOffset += _FLASH_PAGE_SIZE;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Program a block into the target slot, erasing its pages first if needed
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Slot offset (16-byte aligned)
+ * @param[in]     data    Source data
+ * @param[in]     length  Number of bytes
+ * @return true on success
+ */
+static bool BL_Target_Write(BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    if (BL_Target_EnsureErased(ctx, offset + length) != true)
+    {
+        return false;
+    }
+
+    if (BL_Flash_WriteRetry(ctx->update_target_info.g_target_base_addr + offset, data, length) != true)
+    {
+        return false;
+    }
+
+#if (BL_READBACK_VERIFY == 1)
+    if (BL_Target_Readback(ctx, offset, data, length) != true)
+    {
+        return false;
+    }
+#endif
+
+    ctx->update_target_info.writeOffset = offset + length;
+
+    return true;
+}
+
+/**
+ * @brief Idle work: queue the erase of one page ahead of the write pointer
+ *
+ * Keeps up to BL_ERASE_AHEAD_PAGES erased pages in front of the last write,
+ * never past the end of the announced image. Nothing is queued while the
+ * flash engine is busy; a failed erase is reported by the next write.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Target_EraseAhead(BootloaderCtx_t *ctx)
+{
+    bl_target_info_t *target = &ctx->update_target_info;
+    uint32_t         limit   = target->writeOffset + (BL_ERASE_AHEAD_PAGES * _FLASH_PAGE_SIZE);
+
+    if (limit > ctx->update_info.image_size_bytes)
+    {
+        limit = ctx->update_info.image_size_bytes;
+    }
+
+    if ((target->erasedOffset < limit) && (Flash_Async_Status() == FLASH_ASYNC_IDLE))
+    {
+        (void)BL_Target_QueueErase(ctx, target->erasedOffset + _FLASH_PAGE_SIZE);
+    }
+}
+
+/**
+ * @brief Queue the erase of target slot pages up to the page holding endOffset - 1
+ *
+ * The pages are marked erased when queued: the flash engine runs jobs in
+ * order, so a program queued afterwards finds them erased. A failed job
+ * fails the whole update.
+ *
+ * @param[in,out] ctx        Bootloader context pointer
+ * @param[in]     endOffset  Slot offset the next write ends at (exclusive)
+ * @return true if queued (or nothing to erase)
+ */
+static bool BL_Target_QueueErase(BootloaderCtx_t *ctx, uint32_t endOffset)
+{
+    bl_target_info_t *target = &ctx->update_target_info;
+    uint32_t         pages;
+
+    if (target->erasedOffset >= endOffset)
+    {
+        return true;
+    }
+
+    pages = ((endOffset - target->erasedOffset) + _FLASH_PAGE_SIZE - 1U) / _FLASH_PAGE_SIZE;
+
+    if (Flash_Async_EraseRange(target->g_target_base_addr + target->erasedOffset, pages * _FLASH_PAGE_SIZE) != true)
+    {
+        return false;
+    }
+
+    target->erasedOffset += pages * _FLASH_PAGE_SIZE;
+
+    return true;
+}
+
+/**
+ * @brief Queue a block for interrupt-driven programming into the target slot
+ *
+ * Pages the block reaches are queued for erase first. The caller keeps the
+ * source buffer unchanged until Flash_Async_Status() is no longer BUSY.
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Slot offset (16-byte aligned)
+ * @param[in]     data    Source data, valid until the flash engine is idle
+ * @param[in]     length  Number of bytes
+ * @return true if queued
+ */
+static bool BL_Target_WriteAsync(BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    bl_target_info_t *target = &ctx->update_target_info;
+
+    /* Önceki blok geri okunmadan yenisi kuyruğa girmez: tek bekleyen kayıt tutulur */
+    if ((target->verifyLength != 0U) && (BL_Target_Sync(ctx) != true))
+    {
+        return false;
+    }
+
+    if (BL_Target_QueueErase(ctx, offset + length) != true)
+    {
+        return false;
+    }
+
+    if (Flash_Async_Program(target->g_target_base_addr + offset, data, length) != true)
+    {
+        return false;
+    }
+
+#if (BL_READBACK_VERIFY == 1)
+    target->verifyData   = data;
+    target->verifyOffset = offset;
+    target->verifyLength = length;
+#endif
+
+    target->writeOffset = offset + length;
+
+    return true;
+}
+
+/**
+ * @brief Wait for queued flash jobs before a blocking target access
+ *
+ * With BL_READBACK_VERIFY the last interrupt-programmed block is compared
+ * with its source buffer once the engine is idle.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return false if a queued erase / program failed (the error is cleared) or its readback mismatched
+ */
+static bool BL_Target_Sync(BootloaderCtx_t *ctx)
+{
+    bl_target_info_t *target = &ctx->update_target_info;
+    uint32_t         length  = target->verifyLength;
+
+    target->verifyLength = 0U;
+
+    if (Flash_Async_Wait() != true)
+    {
+        Flash_Async_ClearError();
+
+        return false;
+    }
+
+    return (length == 0U) || (BL_Target_Readback(ctx, target->verifyOffset, target->verifyData, length) == true);
+}
+
+/**
+ * @brief Compare a programmed target block with its source buffer
+ *
+ * @param[in] ctx     Bootloader context pointer
+ * @param[in] offset  Slot offset
+ * @param[in] data    Source data
+ * @param[in] length  Number of bytes
+ * @return true if flash holds the source data
+ */
+static bool BL_Target_Readback(const BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    return (memcmp((const uint8_t *)(ctx->update_target_info.g_target_base_addr + offset), data, length) == 0);
+}
+
+/**
+ * @brief Start the running image CRC for a new transfer
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Digest_Reset(BootloaderCtx_t *ctx)
+{
+    bl_image_digest_t *digest = &ctx->image_digest;
+
+    digest->crc    = 0U;
+    digest->offset = 0U;
+    digest->valid  = true;
+
+    CRC32_CombineInit(&digest->chunkShift, ctx->update_info.chunk_size);
+}
+
+/**
+ * @brief Add image bytes handed to flash to the running image CRC
+ *
+ * A gap or overlap in image order drops the digest; FINISH then reads
+ * the image back from flash instead.
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Image offset of data (must continue the digest)
+ * @param[in]     data    Image bytes, NULL for an erased (0xFF) run
+ * @param[in]     length  Number of bytes
+ */
+static void BL_Digest_Update(BootloaderCtx_t *ctx, uint32_t offset, const uint8_t *data, uint32_t length)
+{
+    static const uint8_t erased[64] = { [0 ... 63] = 0xFFU };
+    bl_image_digest_t    *digest    = &ctx->image_digest;
+    uint32_t             crc;
+    uint32_t             step;
+
+    if ((digest->valid != true) || (offset != digest->offset))
+    {
+        digest->valid = false;
+        return;
+    }
+
+    /* Final XOR kendi tersidir: tamamlanmış CRC'den hesaba devam edilir */
+    crc = CRC32_Final(digest->crc);
+
+    if (data != NULL)
+    {
+        crc = CRC32_Update(crc, data, length);
+    }
+    else
+    {
+        for (uint32_t done = 0U; done < length; done += step)
+        {
+            step = ((length - done) > sizeof(erased)) ? sizeof(erased) : (length - done);
+            crc  = CRC32_Update(crc, erased, step);
+        }
+    }
+
+    digest->crc     = CRC32_Final(crc);
+    digest->offset += length;
+}
+
+/**
+ * @brief Add a verified BIN block to the running image CRC by its packet CRC
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     offset  Image offset of the block (must continue the digest)
+ * @param[in]     crc     CRC32 of the block
+ * @param[in]     length  Block length in bytes
+ */
+static void BL_Digest_Append(BootloaderCtx_t *ctx, uint32_t offset, uint32_t crc, uint32_t length)
+{
+    bl_image_digest_t *digest = &ctx->image_digest;
+
+    if ((digest->valid != true) || (offset != digest->offset))
+    {
+        digest->valid = false;
+        return;
+    }
+
+    /* Son blok kısa olabilir: operatör o uzunluk için kurulur */
+    digest->crc     = (length == digest->chunkShift.len) ?
+                          CRC32_CombineWith(&digest->chunkShift, digest->crc, crc) :
+                          CRC32_Combine(digest->crc, crc, length);
+    digest->offset += length;
+}
+
+/**
+ * @brief Load the checkpoint of an interrupted transfer into the target slot
+ *
+ * The checkpoint is used only if the metadata is IN_PROGRESS for the same
+ * target slot and the programmed prefix still matches its CRC32.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return Page-aligned offset the transfer can resume from, 0 to start over
+ */
+static uint32_t BL_Resume_Load(BootloaderCtx_t *ctx)
+{
+    const meta_record_t    *meta   = &ctx->meta;
+    bl_update_resume_t     *resume = &ctx->update_resume;
+    const meta_slot_info_t *info;
+    uint32_t               offset  = meta->progress_bytes;
+
+    memset(resume, 0, sizeof(bl_update_resume_t));
+
+    if ((meta->update_state != META_UPDATE_IN_PROGRESS) ||
+        (Meta_SlotToBaseAddr(meta->target_slot) != ctx->update_target_info.g_target_base_addr))
+    {
+        return 0U;
+    }
+
+    info = (meta->target_slot == META_SLOT_A) ? &meta->slotA : &meta->slotB;
+
+    if ((offset == 0U) ||
+        ((offset % _FLASH_PAGE_SIZE) != 0U) ||
+        (offset >= info->fw.size_bytes) ||
+        (info->fw.size_bytes > BL_APP_MAX_SIZE))
+    {
+        return 0U;
+    }
+
+    /* Checkpoint'ten önce yazılan sayfalar hâlâ sağlam mı */
+    if (CRC32_Image(ctx->update_target_info.g_target_base_addr, offset) != meta->progress_crc32)
+    {
+        return 0U;
+    }
+
+    resume->offset           = offset;
+    resume->fwSize           = info->fw.size_bytes;
+    resume->fwCrc            = info->fw.crc32;
+    resume->checkpointOffset = offset;
+    resume->checkpointCrc    = meta->progress_crc32;
+
+    return offset;
+}
+
+/**
+ * @brief Start checkpointing for an accepted PACKET_INFO, continuing an interrupted transfer if it matches
+ *
+ * Only BIN transfers are checkpointed: the LZ4/DELTA decoder state cannot be
+ * rebuilt from the slot contents alone.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Resume_Begin(BootloaderCtx_t *ctx)
+{
+    bl_update_resume_t *resume = &ctx->update_resume;
+    bl_update_window_t *window = &ctx->update_window;
+
+    resume->enabled = (ctx->update_info.fw_format == BL_FW_FORMAT_BIN) &&
+                      (Meta_SlotToBaseAddr(ctx->meta.target_slot) == ctx->update_target_info.g_target_base_addr);
+
+    if (resume->offset != 0U)
+    {
+        if ((resume->enabled == true) &&
+            (ctx->update_info.fw_size_bytes == resume->fwSize) &&
+            (ctx->update_info.fw_crc32 == resume->fwCrc))
+        {
+            /* Aynı imaj: checkpoint'e kadar olan kısım tekrar istenmez */
+            window->commitOffset      = resume->offset;
+            window->nextRequestOffset = resume->offset;
+            window->reportedOffset    = resume->offset;
+
+            ctx->image_digest.crc     = resume->checkpointCrc;
+            ctx->image_digest.offset  = resume->offset;
+
+            ctx->update_packet_info.startAddress         = resume->offset;
+            ctx->update_packet_info.remainingDataLength -= resume->offset;
+
+            return;
+        }
+
+        /* Farklı imaj: korunan ön kısım da yazılmadan önce silinecek */
+        ctx->update_target_info.erasedOffset = 0U;
+        ctx->update_target_info.writeOffset  = 0U;
+        resume->offset                       = 0U;
+    }
+
+    resume->checkpointOffset = 0U;
+    resume->checkpointCrc    = 0U;
+
+    if (resume->enabled == true)
+    {
+        /* Kayıt yazılamazsa transfer sürer, yalnızca kesintide baştan başlanır */
+        (void)BL_Resume_Save(ctx);
+    }
+}
+
+/**
+ * @brief Record the committed offset in metadata once BL_RESUME_CHECKPOINT_BYTES more are written
+ *
+ * The checkpoint is rounded down to a page boundary so that the page holding
+ * the commit offset is erased again on resume.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ */
+static void BL_Resume_Checkpoint(BootloaderCtx_t *ctx)
+{
+    bl_update_resume_t       *resume = &ctx->update_resume;
+    const bl_update_window_t *window = &ctx->update_window;
+    uint32_t                 aligned;
+    uint32_t                 length;
+
+    if ((resume->enabled == false) || (window->commitOffset >= ctx->update_info.fw_size_bytes))
+    {
+        return;
+    }
+
+    aligned = window->commitOffset - (window->commitOffset % _FLASH_PAGE_SIZE);
+    length  = aligned - resume->checkpointOffset;
+
+    if (length < BL_RESUME_CHECKPOINT_BYTES)
+    {
+        return;
+    }
+
+    if ((ctx->image_digest.valid == true) && (aligned == ctx->image_digest.offset))
+    {
+        resume->checkpointCrc = ctx->image_digest.crc;
+    }
+    else
+    {
+        /* Yalnızca son checkpoint'ten sonra yazılan kısım geri okunur */
+        resume->checkpointCrc = CRC32_Combine(resume->checkpointCrc,
+                                              CRC32_Calculate((const uint8_t *)(ctx->update_target_info.g_target_base_addr +
+                                                                                resume->checkpointOffset),
+                                                              length),
+                                              length);
+    }
+
+    resume->checkpointOffset = aligned;
+
+    (void)BL_Resume_Save(ctx);
+}
+
+/**
+ * @brief Write the checkpoint fields to metadata
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true on success
+ */
+static bool BL_Resume_Save(BootloaderCtx_t *ctx)
+{
+    meta_record_t    *meta = &ctx->meta;
+    meta_slot_info_t *info = (meta->target_slot == META_SLOT_A) ? &meta->slotA : &meta->slotB;
+
+    meta->update_state   = META_UPDATE_IN_PROGRESS;
+    meta->progress_bytes = ctx->update_resume.checkpointOffset;
+    meta->progress_crc32 = ctx->update_resume.checkpointCrc;
+
+    /* Hedef slot yazılmakta: devam kararında imaj kimliği olarak kullanılır */
+    info->valid            = 0U;
+    info->fw.size_bytes    = ctx->update_info.fw_size_bytes;
+    info->fw.crc32         = ctx->update_info.fw_crc32;
+    info->fw.version_major = ctx->update_info.fw_version.major;
+    info->fw.version_minor = ctx->update_info.fw_version.minor;
+    info->fw.version_patch = ctx->update_info.fw_version.patch;
+
+    meta->seq++;
+
+    return Meta_Write(meta);
+}
+
+/**
+ * @brief Prepare the image decoder for the announced firmware format
+ *
+ * LZ4 back-references into earlier pages are read from the target slot.
+ * DELTA reads its source bytes from the active slot, which must hold the
+ * image the patch was generated from.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return false when the update cannot be applied (e.g. delta base mismatch)
+ */
+static bool BL_Stream_Init(BootloaderCtx_t *ctx)
+{
+    uint32_t sourceBase;
+    uint32_t sourceSize = 0U;
+
+    switch (ctx->update_info.fw_format)
+    {
+    case BL_FW_FORMAT_LZ4:
+
+        LZ4_Stream_Init(&ctx->update_stream.lz4,
+                        (const uint8_t *)ctx->update_target_info.g_target_base_addr,
+                        ctx->update_info.image_size_bytes);
+        return true;
+
+    case BL_FW_FORMAT_DELTA:
+
+        sourceBase = BL_Delta_CheckBase(ctx, &sourceSize);
+
+        if (sourceBase == 0U)
+        {
+            return false;
+        }
+
+        Delta_Stream_Init(&ctx->update_stream.delta,
+                          (const uint8_t *)sourceBase,
+                          sourceSize,
+                          ctx->update_info.image_size_bytes);
+        return true;
+
+    default:
+
+        ctx->update_stream.bin.bufOffset = 0U;
+        ctx->update_stream.bin.bufFill   = 0U;
+        ctx->update_stream.bin.fillIndex = 0U;
+        return true;
+    }
+}
+
+/**
+ * @brief Write a committed packet to the target slot according to the firmware format
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Stream_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet)
+{
+    switch (ctx->update_info.fw_format)
+    {
+    case BL_FW_FORMAT_LZ4:
+
+        return BL_Lz4_WritePacket(ctx, packet);
+
+    case BL_FW_FORMAT_DELTA:
+
+        return BL_Delta_WritePacket(ctx, packet);
+
+    default:
+
+        return BL_Bin_WritePacket(ctx, packet);
+    }
+}
+
+/**
+ * @brief Complete the image once every packet is committed
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Stream_Finish(BootloaderCtx_t *ctx)
+{
+    switch (ctx->update_info.fw_format)
+    {
+    case BL_FW_FORMAT_LZ4:
+
+        return BL_Lz4_Finish(ctx);
+
+    case BL_FW_FORMAT_DELTA:
+
+        return BL_Delta_Finish(ctx);
+
+    default:
+
+        /* Son yarım sayfa yazılır; imaj CRC'si flash'tan okunabilir olmalı */
+        if ((BL_Bin_Flush(ctx) != true) || (BL_Target_Sync(ctx) != true))
+        {
+            return BL_ERR_FLASH_WRITE;
+        }
+
+        return BL_ERR_NONE;
+    }
+}
+
+/**
+ * @brief Merge a committed BIN block into the page buffer, programming each page it completes
+ *
+ * Blocks arrive in image order, so the buffer grows contiguously. Block
+ * size and alignment no longer decide how flash is programmed: a page is
+ * written in one burst sequence once it is full. A block crossing a page
+ * boundary continues in the second buffer while the first is programmed.
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Bin_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet)
+{
+    bl_bin_stream_t *bin    = &ctx->update_stream.bin;
+    const uint8_t   *data   = packet->packetData;
+    uint32_t        left    = packet->packetLen;
+    uint32_t        room;
+    uint32_t        copy;
+
+    /* Tampondakiyle bitişik olmayan blok: önce tampon yazılır */
+    if ((bin->bufFill != 0U) && (packet->packetAddr != (bin->bufOffset + bin->bufFill)))
+    {
+        if (BL_Bin_Flush(ctx) != true)
+        {
+            return BL_ERR_FLASH_WRITE;
+        }
+    }
+
+    if (bin->bufFill == 0U)
+    {
+        bin->bufOffset = packet->packetAddr;
+    }
+
+    while (left > 0U)
+    {
+        room = _FLASH_PAGE_SIZE - ((bin->bufOffset % _FLASH_PAGE_SIZE) + bin->bufFill);
+        copy = (left < room) ? left : room;
+
+        memcpy(&bin->page[bin->fillIndex][bin->bufFill], data, copy);
+
+        bin->bufFill += copy;
+        data         += copy;
+        left         -= copy;
+
+        if (copy == room)
+        {
+            /* Sayfa doldu */
+            if (BL_Bin_Flush(ctx) != true)
+            {
+                return BL_ERR_FLASH_WRITE;
+            }
+        }
+    }
+
+    return BL_ERR_NONE;
+}
+
+/**
+ * @brief Queue the buffered part of the current page for programming
+ *
+ * The flushed buffer stays untouched until the flash engine is idle again;
+ * filling continues in the other buffer at the next offset.
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return true if queued (or buffer empty)
+ */
+static bool BL_Bin_Flush(BootloaderCtx_t *ctx)
+{
+    bl_bin_stream_t *bin = &ctx->update_stream.bin;
+
+    if (bin->bufFill == 0U)
+    {
+        return true;
+    }
+
+    if (BL_Target_WriteAsync(ctx, bin->bufOffset, bin->page[bin->fillIndex], bin->bufFill) != true)
+    {
+        return false;
+    }
+
+    bin->fillIndex ^= 1U;
+    bin->bufOffset += bin->bufFill;
+    bin->bufFill    = 0U;
+
+    return true;
+}
+
+/**
+ * @brief Decompress a committed LZ4 block and program every page it fills
+ *
+ * Blocks arrive in image order (commitOffset), so the stream is fed
+ * sequentially. Each full staging page is written to the target slot at
+ * its decompressed offset; pages are flash-page aligned because the slot
+ * base is.
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Lz4_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet)
+{
+    lz4_stream_t        *lz4  = &ctx->update_stream.lz4;
+    const uint8_t       *data = packet->packetData;
+    uint32_t            left  = packet->packetLen;
+    uint32_t            used;
+    lz4_stream_status_t status;
+
+    for (;;)
+    {
+        status = LZ4_Stream_Decode(lz4, data, left, &used);
+
+        data += used;
+        left -= used;
+
+        if (status == LZ4_STREAM_NEED_INPUT)
+        {
+            return BL_ERR_NONE;
+        }
+
+        if (status != LZ4_STREAM_PAGE_READY)
+        {
+            return BL_ERR_DECOMPRESS;
+        }
+
+        if (BL_Target_Write(ctx,
+                            lz4->pageOffset,
+                            lz4->page,
+                            lz4->pageFill) != true)
+        {
+            return BL_ERR_FLASH_WRITE;
+        }
+
+        BL_Digest_Update(ctx, lz4->pageOffset, lz4->page, lz4->pageFill);
+
+        LZ4_Stream_NextPage(lz4);
+    }
+}
+
+/**
+ * @brief Check that the LZ4 stream ended cleanly and program the last partial page
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Lz4_Finish(BootloaderCtx_t *ctx)
+{
+    lz4_stream_t *lz4 = &ctx->update_stream.lz4;
+
+    if (LZ4_Stream_IsComplete(lz4) != true)
+    {
+        return BL_ERR_DECOMPRESS;
+    }
+
+    if (lz4->pageFill > 0U)
+    {
+        if (BL_Target_Write(ctx,
+                            lz4->pageOffset,
+                            lz4->page,
+                            lz4->pageFill) != true)
+        {
+            return BL_ERR_FLASH_WRITE;
+        }
+
+        BL_Digest_Update(ctx, lz4->pageOffset, lz4->page, lz4->pageFill);
+
+        LZ4_Stream_NextPage(lz4);
+    }
+
+    return BL_ERR_NONE;
+}
+
+/**
+ * @brief Check that the active slot holds the image the patch was built against
+ *
+ * Both the metadata record and the slot contents must match the base CRC
+ * from PACKET_INFO; a patch applied to a different image would produce a
+ * wrong target that only the final CRC check would catch.
+ *
+ * @param[in]  ctx         Bootloader context pointer
+ * @param[out] sourceSize  Active image size in bytes
+ * @return Active slot base address, or 0 when the patch cannot be applied
+ */
+static uint32_t BL_Delta_CheckBase(const BootloaderCtx_t *ctx, uint32_t *sourceSize)
+{
+    const meta_slot_info_t *info;
+    uint32_t               base;
+
+    if (ctx->meta.active_slot == META_SLOT_A)
+    {
+        info = &ctx->meta.slotA;
+    }
+    else if (ctx->meta.active_slot == META_SLOT_B)
+    {
+        info = &ctx->meta.slotB;
+    }
+    else
+    {
+        return 0U;
+    }
+
+    base = Meta_SlotToBaseAddr(ctx->meta.active_slot);
+
+    /* Kaynak slot hedefle aynıysa silme işlemi kaynağı bozmuş olur */
+    if ((info->valid == 0U) || (base == 0U) || (base == ctx->update_target_info.g_target_base_addr))
+    {
+        return 0U;
+    }
+
+    if ((info->fw.size_bytes == 0U) || (info->fw.size_bytes > BL_APP_MAX_SIZE) ||
+        (info->fw.crc32 != ctx->update_info.base_crc32))
+    {
+        return 0U;
+    }
+
+    if (CRC32_Image(base, info->fw.size_bytes) != ctx->update_info.base_crc32)
+    {
+        return 0U;
+    }
+
+    *sourceSize = info->fw.size_bytes;
+
+    return base;
+}
+
+/**
+ * @brief Apply a committed patch block and program every page it fills
+ *
+ * @param[in,out] ctx     Bootloader context pointer
+ * @param[in]     packet  Verified packet, in image order
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Delta_WritePacket(BootloaderCtx_t *ctx, const bl_update_packet_t *packet)
+{
+    delta_stream_t        *delta = &ctx->update_stream.delta;
+    const uint8_t         *data  = packet->packetData;
+    uint32_t              left   = packet->packetLen;
+    uint32_t              used;
+    delta_stream_status_t status;
+
+    for (;;)
+    {
+        status = Delta_Stream_Decode(delta, data, left, &used);
+
+        data += used;
+        left -= used;
+
+        if (status == DELTA_STREAM_NEED_INPUT)
+        {
+            return BL_ERR_NONE;
+        }
+
+        if (status != DELTA_STREAM_PAGE_READY)
+        {
+            return BL_ERR_DECOMPRESS;
+        }
+
+        if (BL_Target_Write(ctx,
+                            delta->pageOffset,
+                            delta->page,
+                            delta->pageFill) != true)
+        {
+            return BL_ERR_FLASH_WRITE;
+        }
+
+        BL_Digest_Update(ctx, delta->pageOffset, delta->page, delta->pageFill);
+
+        Delta_Stream_NextPage(delta);
+    }
+}
+
+/**
+ * @brief Check that the patch ended cleanly and program the last partial page
+ *
+ * @param[in,out] ctx  Bootloader context pointer
+ * @return BL_ERR_NONE, BL_ERR_DECOMPRESS or BL_ERR_FLASH_WRITE
+ */
+static bl_error_t BL_Delta_Finish(BootloaderCtx_t *ctx)
+{
+    delta_stream_t *delta = &ctx->update_stream.delta;
+
+    if (Delta_Stream_IsComplete(delta) != true)
+    {
+        return BL_ERR_DECOMPRESS;
+    }
+
+    if (delta->pageFill > 0U)
+    {
+        if (BL_Target_Write(ctx,
+                            delta->pageOffset,
+                            delta->page,
+                            delta->pageFill) != true)
+        {
+            return BL_ERR_FLASH_WRITE;
+        }
+
+        BL_Digest_Update(ctx, delta->pageOffset, delta->page, delta->pageFill);
+
+        Delta_Stream_NextPage(delta);
+    }
+
+    return BL_ERR_NONE;
+}
+
+/**
+ * @brief Check application vector table integrity
+ *
+ * @param[in] appBase  Application flash base address
+ * @return true  Vector table valid
+ * @return false Vector table invalid
+ */
+static bool BL_IsVectorTableSane(uint32_t appBase)
+{
+    uint32_t msp;
+    uint32_t rst;
+
+    msp = *(volatile uint32_t *)(appBase);
+    rst = *(volatile uint32_t *)(appBase + 4U);
+
+    if ((msp < BL_SRAM_BASE) || (msp > BL_SRAM_END))
+    {
+        return false;
+    }
+
+    if ((rst < appBase) || (rst > (appBase + 0x200000UL)))
+    {
+        return false;
+    }
+
+    if ((rst & 0x1U) == 0U)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Check the application image against the CRC32 recorded in metadata
+ *
+ * Image is read by the CRC unit over GPDMA (software CRC as fallback).
+ *
+ * @param[in] ctx      Bootloader context pointer
+ * @param[in] appBase  Application flash base address
+ * @return true  CRC matches, or the slot has no size / CRC record
+ * @return false Image CRC mismatch
+ */
+static bool BL_IsImageCrcValid(const BootloaderCtx_t *ctx, uint32_t appBase)
+{
+    const meta_slot_info_t *info;
+
+    if (appBase == Meta_SlotToBaseAddr(META_SLOT_A))
+    {
+        info = &ctx->meta.slotA;
+    }
+    else if (appBase == Meta_SlotToBaseAddr(META_SLOT_B))
+    {
+        info = &ctx->meta.slotB;
+    }
+    else
+    {
+        return true;
+    }
+
+    /* Slotlardan kurulan metadata'da imaj bilgisi yok: yalnız vektör tablosu kontrol edilir */
+    if ((info->valid == 0U) || (info->fw.size_bytes == 0U) || (info->fw.size_bytes > BL_APP_MAX_SIZE))
+    {
+        return true;
+    }
+
+    return (CRC32_Image(appBase, info->fw.size_bytes) == info->fw.crc32);
+}
+
+/**
+ * @brief Perform low-level application jump
+ *
+ * Transfers execution from bootloader to application safely.
+ *
+ * @param[in] appBase  Application flash base address
+ */
+static void BL_Jump(uint32_t appBase)
+{
+    uint32_t appStack;   /* Application'ın başlangıç Main Stack Pointer değeri */
+    uint32_t appEntry;   /* Application'ın Reset_Handler (giriş noktası) adresi */
+
+    appStack = *(volatile uint32_t *)(appBase);        /* Vector table [0]: initial MSP */
+    appEntry = *(volatile uint32_t *)(appBase + 4U);   /* Vector table [1]: reset handler */
+
+    (void)Flash_Async_Wait();  /* Kuyruktaki flash işleri kesmeyle biter, kesmeler kapanmadan beklenir */
 
     __disable_irq();     /* Jump sırasında kesmelerin çalışmasını engelle */
 
@@ -1202,8 +3720,10 @@ static bool BL_CheckUpdateRequest(BootloaderCtx_t *ctx)
     /* =========================================================
      * Step 3: Final decision (OR logic)
      * ========================================================= */
+    /* Kesintiye uğramış güncelleme: host'un kaldığı yerden devam edebilmesi için update moduna girilir */
     if ((update_from_backup == false) &&
-        (update_from_eeprom == false))
+        (update_from_eeprom == false) &&
+        (ctx->meta.update_state != META_UPDATE_IN_PROGRESS))
     {
         /* Ne EEPROM ne de Backup update istiyor */
         return false;
@@ -10,10 +10,71 @@
 
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * CRC32 (IEEE 802.3, yansıtılmış 0xEDB88320) gerçekleme seçimi. Üçü de aynı sonucu verir:
+ *   BITWISE: byte başına 8 kaydırma adımı, tablo yok
+ *   TABLE  : byte başına bir tablo araması (1 KB tablo)
+ *   SLICE8 : 8 byte başına sekiz tablo araması (8 KB tablo)
+ * Tablolar ilk kullanımda RAM'de üretilir.
+ */
+#define CRC32_IMPL_BITWISE		0
+#define CRC32_IMPL_TABLE		1
+#define CRC32_IMPL_SLICE8		2
+
+#ifndef CRC32_IMPL
+#define CRC32_IMPL				CRC32_IMPL_SLICE8
+#endif
+
+/*
+ * Flash'taki büyük alanlar (imaj doğrulama) için CRC birimi + GPDMA. Aynı CRC32'yi verir;
+ * başlangıçta yazılım CRC'si ile karşılaştırılır, tutmazsa ya da 0 ise yazılım CRC'si kullanılır.
+ * Süresi içinde bitmeyen bir hesaptan sonra da (CRC32_HW_Poll ERROR) yazılım CRC'si kullanılır.
+ */
+#ifndef CRC32_USE_HW
+#define CRC32_USE_HW			1
+#endif
+
+typedef enum
+{
+    CRC32_HW_IDLE = 0,
+    CRC32_HW_BUSY,
+    CRC32_HW_DONE,
+    CRC32_HW_ERROR
+} crc32_hw_status_t;
+
+/*
+ * CRC32(A) ve CRC32(B)'den CRC32(A || B)'yi veriye dokunmadan hesaplamak için
+ * B uzunluğundaki sıfır kaydırma operatörü (GF(2) 32x32 matris, sütun başına bir kelime).
+ * Sabit blok boyutu için bir kez hazırlanır, sonraki birleştirmeler 32 adımdır.
+ */
+typedef struct
+{
+    uint32_t len;
+    uint32_t op[32];
+} crc32_combine_t;
+
+/* Parça parça hesap: crc = CRC32_Start(); crc = CRC32_Update(crc, ...); ... CRC32_Final(crc) */
+uint32_t CRC32_Start(void);
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length);
+uint32_t CRC32_Final(uint32_t crc);
 
 uint32_t CRC32_Calculate(const uint8_t *data, uint32_t length);
 uint8_t CRC32_Verify(const uint8_t *data,
                      uint32_t data_len,
                      uint32_t received_crc);
 
+void     CRC32_CombineInit(crc32_combine_t *comb, uint32_t len2);
+uint32_t CRC32_CombineWith(const crc32_combine_t *comb, uint32_t crc1, uint32_t crc2);
+uint32_t CRC32_Combine(uint32_t crc1, uint32_t crc2, uint32_t len2);
+
+void              CRC32_HW_Init(void);
+bool              CRC32_HW_Start(uint32_t address, uint32_t length);
+crc32_hw_status_t CRC32_HW_Poll(uint32_t *crc);
+void              CRC32_HW_IRQHandler(void);
+
+/* Bloklayan imaj CRC'si: donanım hazırsa CRC birimi, değilse yazılım */
+uint32_t CRC32_Image(uint32_t address, uint32_t length);
+
 #endif /* BOOTLOADER_DRIVERS_CRC_INC_CRC_H_ */
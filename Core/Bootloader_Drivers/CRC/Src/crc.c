@@ -7,31 +7,130 @@
 
 
 #include "crc.h"
+#include <string.h>
 
-uint32_t CRC32_Calculate(const uint8_t *data, uint32_t length)
+#if (CRC32_USE_HW == 1)
+#include "main.h"
+#endif
+
+#define CRC32_POLY		0xEDB88320u
+
+#if (CRC32_IMPL == CRC32_IMPL_SLICE8)
+#define CRC32_TABLE_COUNT	8u
+#elif (CRC32_IMPL == CRC32_IMPL_TABLE)
+#define CRC32_TABLE_COUNT	1u
+#endif
+
+#ifdef CRC32_TABLE_COUNT
+/*
+ * crc32Table[0][b]: b byte'ının CRC'si (klasik byte tablosu)
+ * crc32Table[k][b]: aynı byte'ın ardından k sıfır byte gelmiş hali
+ */
+static uint32_t crc32Table[CRC32_TABLE_COUNT][256];
+static uint8_t  crc32TableReady = 0u;
+
+static void CRC32_BuildTable(void)
 {
-    uint32_t crc = 0xFFFFFFFFu;
+    for (uint32_t b = 0u; b < 256u; b++)
+    {
+        uint32_t crc = b;
+
+        for (uint8_t j = 0; j < 8; j++)
+        {
+            crc = (crc & 1u) ? ((crc >> 1) ^ CRC32_POLY) : (crc >> 1);
+        }
+
+        crc32Table[0][b] = crc;
+    }
+
+    for (uint32_t k = 1u; k < CRC32_TABLE_COUNT; k++)
+    {
+        for (uint32_t b = 0u; b < 256u; b++)
+        {
+            uint32_t prev = crc32Table[k - 1u][b];
+
+            crc32Table[k][b] = (prev >> 8) ^ crc32Table[0][prev & 0xFFu];
+        }
+    }
+
+    crc32TableReady = 1u;
+}
+#endif
+
+uint32_t CRC32_Start(void)
+{
+    return 0xFFFFFFFFu;
+}
+
+uint32_t CRC32_Update(uint32_t crc, const uint8_t *data, uint32_t length)
+{
+#ifdef CRC32_TABLE_COUNT
+    if (crc32TableReady == 0u)
+    {
+        CRC32_BuildTable();
+    }
+#endif
+
+#if (CRC32_IMPL == CRC32_IMPL_SLICE8)
+    /* Little-endian: iki 32 bit okuma, sekiz byte tek adımda */
+    while (length >= 8u)
+    {
+        uint32_t one;
+        uint32_t two;
+
+        memcpy(&one, data, sizeof(one));
+        memcpy(&two, data + 4, sizeof(two));
+
+        one ^= crc;
+
+        crc = crc32Table[7][one & 0xFFu]         ^
+              crc32Table[6][(one >> 8) & 0xFFu]  ^
+              crc32Table[5][(one >> 16) & 0xFFu] ^
+              crc32Table[4][one >> 24]           ^
+              crc32Table[3][two & 0xFFu]         ^
+              crc32Table[2][(two >> 8) & 0xFFu]  ^
+              crc32Table[1][(two >> 16) & 0xFFu] ^
+              crc32Table[0][two >> 24];
+
+        data   += 8;
+        length -= 8u;
+    }
+#endif
 
     for (uint32_t i = 0; i < length; i++)
     {
+#ifdef CRC32_TABLE_COUNT
+        crc = (crc >> 8) ^ crc32Table[0][(crc ^ data[i]) & 0xFFu];
+#else
         crc ^= data[i];
 
         for (uint8_t j = 0; j < 8; j++)
         {
             if (crc & 1u)
             {
-                crc = (crc >> 1) ^ 0xEDB88320u;
+                crc = (crc >> 1) ^ CRC32_POLY;
             }
             else
             {
                 crc >>= 1;
             }
         }
+#endif
     }
 
+    return crc;
+}
+
+uint32_t CRC32_Final(uint32_t crc)
+{
     return crc ^ 0xFFFFFFFFu;
 }
 
+uint32_t CRC32_Calculate(const uint8_t *data, uint32_t length)
+{
+    return CRC32_Final(CRC32_Update(CRC32_Start(), data, length));
+}
+
 uint8_t CRC32_Verify(const uint8_t *data,
                      uint32_t data_len,
                      uint32_t received_crc)
@@ -54,3 +153,401 @@ uint8_t CRC32_Verify(const uint8_t *data,
         return 0u;   /* CRC FAIL */
     }
 }
+
+/* GF(2) matris * vektör: vec'in set bitlerine karşılık gelen sütunlar XOR'lanır */
+static uint32_t CRC32_MatrixTimes(const uint32_t *mat, uint32_t vec)
+{
+    uint32_t sum = 0u;
+
+    while (vec != 0u)
+    {
+        if (vec & 1u)
+        {
+            sum ^= *mat;
+        }
+
+        vec >>= 1;
+        mat++;
+    }
+
+    return sum;
+}
+
+/* dst = a * b (önce b, sonra a uygulanır) */
+static void CRC32_MatrixMultiply(uint32_t *dst, const uint32_t *a, const uint32_t *b)
+{
+    for (uint8_t n = 0; n < 32u; n++)
+    {
+        dst[n] = CRC32_MatrixTimes(a, b[n]);
+    }
+}
+
+/*
+ * len2 sıfır byte'lık kaydırma operatörünü comb->op'a hazırlar.
+ * Ara matrisler statik: bootloader stack'i küçük.
+ */
+void CRC32_CombineInit(crc32_combine_t *comb, uint32_t len2)
+{
+    static uint32_t square[32];
+    static uint32_t tmp[32];
+    uint32_t        row = 1u;
+
+    comb->len = len2;
+
+    /* Birim matris */
+    for (uint8_t n = 0; n < 32u; n++)
+    {
+        comb->op[n] = row;
+        row <<= 1;
+    }
+
+    /* Tek sıfır bit operatörü, üç kez karesi alınarak tek sıfır byte'a çıkarılır */
+    square[0] = 0xEDB88320u;
+    row       = 1u;
+
+    for (uint8_t n = 1; n < 32u; n++)
+    {
+        square[n] = row;
+        row <<= 1;
+    }
+
+    for (uint8_t k = 0; k < 3u; k++)
+    {
+        CRC32_MatrixMultiply(tmp, square, square);
+        memcpy(square, tmp, sizeof(square));
+    }
+
+    /* len2'nin set bitleri için 2^k byte operatörleri çarpılır */
+    while (len2 != 0u)
+    {
+        if (len2 & 1u)
+        {
+            CRC32_MatrixMultiply(tmp, square, comb->op);
+            memcpy(comb->op, tmp, sizeof(tmp));
+        }
+
+        len2 >>= 1;
+
+        if (len2 != 0u)
+        {
+            CRC32_MatrixMultiply(tmp, square, square);
+            memcpy(square, tmp, sizeof(square));
+        }
+    }
+}
+
+uint32_t CRC32_CombineWith(const crc32_combine_t *comb, uint32_t crc1, uint32_t crc2)
+{
+    return CRC32_MatrixTimes(comb->op, crc1) ^ crc2;
+}
+
+/* Uzunluğu önceden bilinmeyen (ör. son) blok için: operatör her seferinde kurulur */
+uint32_t CRC32_Combine(uint32_t crc1, uint32_t crc2, uint32_t len2)
+{
+    static crc32_combine_t comb;
+
+    if (len2 == 0u)
+    {
+        return crc1;
+    }
+
+    CRC32_CombineInit(&comb, len2);
+
+    return CRC32_CombineWith(&comb, crc1, crc2);
+}
+
+#if (CRC32_USE_HW == 1)
+
+/*
+ * CRC birimi yansıtılmış CRC32 için: POL 0x04C11DB7, INIT 0xFFFFFFFF, giriş word olarak
+ * bit ters, çıkış bit ters; son XOR yazılımda yapılır. GPDMA kaynağı word okur, 16 bit blok
+ * sayacı nedeniyle imaj CRC32_HW_DMA_BLOCK'luk bloklara bölünür ve sonraki blok kesmede
+ * başlatılır. Word'e tamamlanmayan son byte'lar CPU tarafından byte olarak yazılır.
+ */
+#define CRC32_HW_POLY			0x04C11DB7u
+#define CRC32_HW_DMA_BLOCK		0xFFFCu
+
+/* Hesap süresi sınırı: 10 ms + 32 KB başına 1 ms (DMA en az 32 MB/s, gerçekte çok üstünde) */
+#define CRC32_HW_TIMEOUT_MS		10u
+
+static DMA_HandleTypeDef            crcHwDma;
+static volatile crc32_hw_status_t   crcHwStatus = CRC32_HW_IDLE;
+static bool                         crcHwReady  = false;
+static uint32_t                     crcHwNext;
+static uint32_t                     crcHwWordBytes;
+static uint32_t                     crcHwTailBytes;
+static uint32_t                     crcHwResult;
+static uint32_t                     crcHwStartTick;
+static uint32_t                     crcHwTimeoutMs;
+
+static void CRC32_HW_Finish(void)
+{
+    const uint8_t *tail = (const uint8_t *)crcHwNext;
+
+    if (crcHwTailBytes != 0u)
+    {
+        /* Byte yazımında ters çevirme byte bazında olmalı */
+        CRC->CR = (CRC->CR & ~CRC_CR_REV_IN) | CRC_CR_REV_IN_0;
+
+        for (uint32_t i = 0; i < crcHwTailBytes; i++)
+        {
+            *(volatile uint8_t *)&CRC->DR = tail[i];
+        }
+    }
+
+    crcHwResult = CRC->DR ^ 0xFFFFFFFFu;
+    crcHwStatus = CRC32_HW_DONE;
+}
+
+static bool CRC32_HW_NextBlock(void)
+{
+    uint32_t block = (crcHwWordBytes > CRC32_HW_DMA_BLOCK) ? CRC32_HW_DMA_BLOCK : crcHwWordBytes;
+
+    if (HAL_DMA_Start_IT(&crcHwDma, crcHwNext, (uint32_t)&CRC->DR, block) != HAL_OK)
+    {
+        return false;
+    }
+
+    crcHwNext      += block;
+    crcHwWordBytes -= block;
+
+    return true;
+}
+
+static void CRC32_HW_XferCplt(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+
+    if (crcHwWordBytes != 0u)
+    {
+        if (CRC32_HW_NextBlock() != true)
+        {
+            crcHwStatus = CRC32_HW_ERROR;
+        }
+    }
+    else
+    {
+        CRC32_HW_Finish();
+    }
+}
+
+static void CRC32_HW_XferError(DMA_HandleTypeDef *hdma)
+{
+    (void)hdma;
+
+    crcHwStatus = CRC32_HW_ERROR;
+}
+
+/* Öz testteki en uzun RAM örneği (byte) */
+#define CRC32_HW_TEST_MAX		64u
+
+/* Bir uzunluk için donanım sonucu yazılım CRC'si ile karşılaştırılır (bloklayan) */
+static bool CRC32_HW_SelfTest(uint32_t address, uint32_t length)
+{
+    crc32_hw_status_t status;
+    uint32_t          crc = 0u;
+
+    if (CRC32_HW_Start(address, length) != true)
+    {
+        return false;
+    }
+
+    /* Sınırlı: süresi dolan hesap Poll'dan ERROR döner */
+    while ((status = CRC32_HW_Poll(&crc)) == CRC32_HW_BUSY)
+    {
+    }
+
+    return (status == CRC32_HW_DONE) && (crc == CRC32_Calculate((const uint8_t *)address, length));
+}
+
+void CRC32_HW_Init(void)
+{
+    static uint8_t pattern[CRC32_HW_TEST_MAX] __attribute__((aligned(4)));
+    uint32_t       rng = 0x2545F491u;
+
+    crcHwReady  = false;
+    crcHwStatus = CRC32_HW_IDLE;
+
+    __HAL_RCC_CRC_CLK_ENABLE();
+    __HAL_RCC_GPDMA1_CLK_ENABLE();
+
+    crcHwDma.Instance                   = GPDMA1_Channel0;
+    crcHwDma.Init.Request               = DMA_REQUEST_SW;
+    crcHwDma.Init.BlkHWRequest          = DMA_BREQ_SINGLE_BURST;
+    crcHwDma.Init.Direction             = DMA_MEMORY_TO_MEMORY;
+    crcHwDma.Init.SrcInc                = DMA_SINC_INCREMENTED;
+    crcHwDma.Init.DestInc               = DMA_DINC_FIXED;
+    crcHwDma.Init.SrcDataWidth          = DMA_SRC_DATAWIDTH_WORD;
+    crcHwDma.Init.DestDataWidth         = DMA_DEST_DATAWIDTH_WORD;
+    crcHwDma.Init.Priority              = DMA_LOW_PRIORITY_LOW_WEIGHT;
+    crcHwDma.Init.SrcBurstLength        = 1u;
+    crcHwDma.Init.DestBurstLength       = 1u;
+    crcHwDma.Init.TransferAllocatedPort = DMA_SRC_ALLOCATED_PORT0 | DMA_DEST_ALLOCATED_PORT0;
+    crcHwDma.Init.TransferEventMode     = DMA_TCEM_BLOCK_TRANSFER;
+    crcHwDma.Init.Mode                  = DMA_NORMAL;
+
+    if (HAL_DMA_Init(&crcHwDma) != HAL_OK)
+    {
+        return;
+    }
+
+    crcHwDma.XferCpltCallback  = CRC32_HW_XferCplt;
+    crcHwDma.XferErrorCallback = CRC32_HW_XferError;
+
+    /* Flash motoru (1) ile aynı, USB (0) kesmesinin altında */
+    HAL_NVIC_SetPriority(GPDMA1_Channel0_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(GPDMA1_Channel0_IRQn);
+
+    crcHwReady = true;
+
+    for (uint32_t i = 0; i < CRC32_HW_TEST_MAX; i++)
+    {
+        rng ^= rng << 13;
+        rng ^= rng >> 17;
+        rng ^= rng << 5;
+        pattern[i] = (uint8_t)rng;
+    }
+
+    /*
+     * 0..3 byte yalnız CPU kuyruğu, sonrası DMA + 0..3 byte kuyruk. Son örnek bootloader'ın
+     * 256 KB'lık flash alanı üzerinde DMA blok sınırını geçer (sonraki blok kesmede başlar).
+     */
+    for (uint32_t length = 0u; length <= CRC32_HW_TEST_MAX; length++)
+    {
+        if (CRC32_HW_SelfTest((uint32_t)pattern, length) != true)
+        {
+            /* Donanım yazılım CRC'si ile aynı sonucu vermiyor: yalnız yazılım kullanılır */
+            crcHwReady = false;
+            return;
+        }
+    }
+
+    if (CRC32_HW_SelfTest(FLASH_BASE, CRC32_HW_DMA_BLOCK + 7u) != true)
+    {
+        crcHwReady = false;
+    }
+}
+
+/*
+ * Adres word hizalı olmalı. false: donanım kullanılamıyor ya da meşgul,
+ * çağıran yazılım CRC'sine döner.
+ */
+bool CRC32_HW_Start(uint32_t address, uint32_t length)
+{
+    if ((crcHwReady != true) || (crcHwStatus == CRC32_HW_BUSY) || ((address & 3u) != 0u))
+    {
+        return false;
+    }
+
+    CRC->INIT = 0xFFFFFFFFu;
+    CRC->POL  = CRC32_HW_POLY;
+    CRC->CR   = CRC_CR_REV_IN | CRC_CR_REV_OUT | CRC_CR_RESET;
+
+    crcHwNext      = address;
+    crcHwWordBytes = length & ~3u;
+    crcHwTailBytes = length & 3u;
+    crcHwStartTick = HAL_GetTick();
+    crcHwTimeoutMs = CRC32_HW_TIMEOUT_MS + (length >> 15);
+    crcHwStatus    = CRC32_HW_BUSY;
+
+    if (crcHwWordBytes == 0u)
+    {
+        CRC32_HW_Finish();
+        return true;
+    }
+
+    if (CRC32_HW_NextBlock() != true)
+    {
+        crcHwStatus = CRC32_HW_IDLE;
+        return false;
+    }
+
+    return true;
+}
+
+/*
+ * DONE / ERROR bir kez döner, ardından birim yeni hesaplamaya hazırdır. Süresi
+ * içinde bitmeyen hesap (kesme gelmiyor, callback'siz bus hatası) ERROR döner:
+ * DMA durdurulur ve donanım bir daha kullanılmaz, çağıran yazılım CRC'sine döner.
+ */
+crc32_hw_status_t CRC32_HW_Poll(uint32_t *crc)
+{
+    crc32_hw_status_t status = crcHwStatus;
+
+    if ((status == CRC32_HW_BUSY) && ((HAL_GetTick() - crcHwStartTick) > crcHwTimeoutMs))
+    {
+        (void)HAL_DMA_Abort(&crcHwDma);
+        crcHwReady  = false;
+        crcHwStatus = CRC32_HW_IDLE;
+        status      = CRC32_HW_ERROR;
+    }
+    else if (status == CRC32_HW_DONE)
+    {
+        if (crc != NULL)
+        {
+            *crc = crcHwResult;
+        }
+
+        crcHwStatus = CRC32_HW_IDLE;
+    }
+    else if (status == CRC32_HW_ERROR)
+    {
+        (void)HAL_DMA_Abort(&crcHwDma);
+        crcHwStatus = CRC32_HW_IDLE;
+    }
+
+    return status;
+}
+
+void CRC32_HW_IRQHandler(void)
+{
+    HAL_DMA_IRQHandler(&crcHwDma);
+}
+
+#else
+
+void CRC32_HW_Init(void)
+{
+}
+
+bool CRC32_HW_Start(uint32_t address, uint32_t length)
+{
+    (void)address;
+    (void)length;
+
+    return false;
+}
+
+crc32_hw_status_t CRC32_HW_Poll(uint32_t *crc)
+{
+    (void)crc;
+
+    return CRC32_HW_IDLE;
+}
+
+void CRC32_HW_IRQHandler(void)
+{
+}
+
+#endif
+
+uint32_t CRC32_Image(uint32_t address, uint32_t length)
+{
+    crc32_hw_status_t status;
+    uint32_t          crc = 0u;
+
+    if (CRC32_HW_Start(address, length) == true)
+    {
+        /* Sınırlı: süresi dolan hesap Poll'dan ERROR döner, yazılım CRC'sine geçilir */
+        while ((status = CRC32_HW_Poll(&crc)) == CRC32_HW_BUSY)
+        {
+        }
+
+        if (status == CRC32_HW_DONE)
+        {
+            return crc;
+        }
+    }
+
+    return CRC32_Calculate((const uint8_t *)address, length);
+}
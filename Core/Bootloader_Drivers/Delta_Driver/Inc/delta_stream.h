@@ -0,0 +1,74 @@
+/*
+ * delta_stream.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef BOOTLOADER_DRIVERS_DELTA_DRIVER_INC_DELTA_STREAM_H_
+#define BOOTLOADER_DRIVERS_DELTA_DRIVER_INC_DELTA_STREAM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * Aktif slottaki imaja (kaynak) karşı üretilmiş patch akışını parça parça uygular.
+ *
+ * Patch, art arda gelen kayıtlardan oluşur (tüm alanlar little endian):
+ *   COPY : 0x00 | len(4) | srcOffset(4)              -> kaynaktan len byte
+ *   DIFF : 0x01 | len(4) | srcOffset(4) | diff[len]  -> kaynak[i] + diff[i] (bsdiff)
+ *   DATA : 0x02 | len(4) | data[len]                 -> yeni byte'lar
+ *
+ * Çıktı sayfa boyutunda bir tampona yazılır; tampon dolunca çağıran taraf
+ * sayfayı flash'a yazar ve Delta_Stream_NextPage() ile devam eder.
+ */
+
+#define DELTA_STREAM_PAGE_SIZE		(8U * 1024U)
+
+#define DELTA_OP_COPY				(0x00U)
+#define DELTA_OP_DIFF				(0x01U)
+#define DELTA_OP_DATA				(0x02U)
+
+typedef enum
+{
+	DELTA_STREAM_NEED_INPUT = 0,	// Girdi tükendi, sonraki parça bekleniyor
+	DELTA_STREAM_PAGE_READY,		// Sayfa tamponu doldu, yazılmalı
+	DELTA_STREAM_ERROR				// Bozuk kayıt, kaynak veya çıktı sınırı aşıldı
+}delta_stream_status_t;
+
+typedef enum
+{
+	DELTA_STATE_OP = 0,
+	DELTA_STATE_HEADER,
+	DELTA_STATE_BODY
+}delta_stream_state_t;
+
+typedef struct
+{
+	delta_stream_state_t	state;
+	uint8_t					op;
+	uint8_t					header[8];
+	uint8_t					headerLen;		// Kaydın başlık uzunluğu
+	uint8_t					headerFill;
+	uint32_t				remaining;		// Kayıtta üretilecek byte
+	uint32_t				srcPos;
+
+	const uint8_t			*source;		// Aktif slot imajı
+	uint32_t				sourceSize;
+	uint32_t				outLimit;		// Hedef imajın beklenen boyutu
+	uint32_t				outPos;
+	uint32_t				pageOffset;		// Tampondaki sayfanın imaj içindeki offset'i
+	uint32_t				pageFill;
+
+	uint8_t					page[DELTA_STREAM_PAGE_SIZE] __attribute__((aligned(16)));
+}delta_stream_t;
+
+void Delta_Stream_Init(delta_stream_t *s, const uint8_t *source, uint32_t sourceSize, uint32_t outLimit);
+delta_stream_status_t Delta_Stream_Decode(delta_stream_t *s,
+										  const uint8_t *in,
+										  uint32_t len,
+										  uint32_t *consumed);
+void Delta_Stream_NextPage(delta_stream_t *s);
+bool Delta_Stream_IsComplete(const delta_stream_t *s);
+
+#endif /* BOOTLOADER_DRIVERS_DELTA_DRIVER_INC_DELTA_STREAM_H_ */
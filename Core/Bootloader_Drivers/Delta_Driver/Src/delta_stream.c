@@ -0,0 +1,228 @@
+/*
+ * delta_stream.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <string.h>
+#include "delta_stream.h"
+
+static uint32_t Delta_Stream_Min(uint32_t a, uint32_t b)
+{
+	return (a < b) ? a : b;
+}
+
+static uint32_t Delta_Stream_Le32(const uint8_t *p)
+{
+	return  ((uint32_t)p[0])
+		  | ((uint32_t)p[1] << 8)
+		  | ((uint32_t)p[2] << 16)
+		  | ((uint32_t)p[3] << 24);
+}
+
+/*
+ * Kayıt başlığı tamamlandığında uzunluk ve kaynak aralığını doğrular
+ */
+static bool Delta_Stream_StartRecord(delta_stream_t *s)
+{
+	s->remaining = Delta_Stream_Le32(&s->header[0]);
+	s->srcPos	 = 0U;
+
+	if (s->remaining > (s->outLimit - s->outPos))
+	{
+		return false;
+	}
+
+	if (s->op != DELTA_OP_DATA)
+	{
+		s->srcPos = Delta_Stream_Le32(&s->header[4]);
+
+		if ((s->srcPos > s->sourceSize) || (s->remaining > (s->sourceSize - s->srcPos)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+void Delta_Stream_Init(delta_stream_t *s, const uint8_t *source, uint32_t sourceSize, uint32_t outLimit)
+{
+	if (s == NULL)
+	{
+		return;
+	}
+
+	s->state		= DELTA_STATE_OP;
+	s->op			= 0U;
+	s->headerLen	= 0U;
+	s->headerFill	= 0U;
+	s->remaining	= 0U;
+	s->srcPos		= 0U;
+
+	s->source		= source;
+	s->sourceSize	= sourceSize;
+	s->outLimit		= outLimit;
+	s->outPos		= 0U;
+	s->pageOffset	= 0U;
+	s->pageFill		= 0U;
+}
+
+/*
+ * in[0..len) parçasını uygular. Sayfa tamponu dolarsa DELTA_STREAM_PAGE_READY ile
+ * döner; çağıran sayfayı yazıp Delta_Stream_NextPage() sonrası kalan girdiyle
+ * (in + *consumed) tekrar çağırır. DELTA_STREAM_NEED_INPUT: girdinin tamamı işlendi.
+ */
+delta_stream_status_t Delta_Stream_Decode(delta_stream_t *s,
+										  const uint8_t *in,
+										  uint32_t len,
+										  uint32_t *consumed)
+{
+	delta_stream_status_t	status;
+	uint32_t				pos = 0U;
+	uint32_t				n;
+	uint32_t				i;
+	uint8_t					*dst;
+
+	if ((s == NULL) || (consumed == NULL) || ((in == NULL) && (len > 0U)))
+	{
+		return DELTA_STREAM_ERROR;
+	}
+
+	for (;;)
+	{
+		if (s->pageFill >= DELTA_STREAM_PAGE_SIZE)
+		{
+			status = DELTA_STREAM_PAGE_READY;
+			break;
+		}
+
+		/* COPY gövdesi ve biten kayıt girdi tüketmez */
+		if ((pos >= len) &&
+			!((s->state == DELTA_STATE_BODY) && ((s->op == DELTA_OP_COPY) || (s->remaining == 0U))))
+		{
+			status = DELTA_STREAM_NEED_INPUT;
+			break;
+		}
+
+		switch (s->state)
+		{
+		case DELTA_STATE_OP:
+
+			s->op = in[pos++];
+
+			if (s->op > DELTA_OP_DATA)
+			{
+				*consumed = pos;
+				return DELTA_STREAM_ERROR;
+			}
+
+			s->headerLen	= (s->op == DELTA_OP_DATA) ? 4U : 8U;
+			s->headerFill	= 0U;
+			s->state		= DELTA_STATE_HEADER;
+			break;
+
+		case DELTA_STATE_HEADER:
+
+			n = Delta_Stream_Min((uint32_t)(s->headerLen - s->headerFill), len - pos);
+
+			memcpy(&s->header[s->headerFill], &in[pos], n);
+
+			pos 			+= n;
+			s->headerFill	+= (uint8_t)n;
+
+			if (s->headerFill == s->headerLen)
+			{
+				if (Delta_Stream_StartRecord(s) != true)
+				{
+					*consumed = pos;
+					return DELTA_STREAM_ERROR;
+				}
+
+				s->state = DELTA_STATE_BODY;
+			}
+			break;
+
+		case DELTA_STATE_BODY:
+
+			if (s->remaining == 0U)
+			{
+				s->state = DELTA_STATE_OP;
+				break;
+			}
+
+			n	= Delta_Stream_Min(s->remaining, DELTA_STREAM_PAGE_SIZE - s->pageFill);
+			dst = &s->page[s->pageFill];
+
+			if (s->op == DELTA_OP_COPY)
+			{
+				memcpy(dst, &s->source[s->srcPos], n);
+			}
+			else
+			{
+				n = Delta_Stream_Min(n, len - pos);
+
+				if (s->op == DELTA_OP_DIFF)
+				{
+					for (i = 0U; i < n; i++)
+					{
+						dst[i] = (uint8_t)(s->source[s->srcPos + i] + in[pos + i]);
+					}
+				}
+				else
+				{
+					memcpy(dst, &in[pos], n);
+				}
+
+				pos += n;
+			}
+
+			s->srcPos		+= n;
+			s->remaining	-= n;
+			s->pageFill		+= n;
+			s->outPos		+= n;
+			break;
+
+		default:
+
+			*consumed = pos;
+			return DELTA_STREAM_ERROR;
+		}
+	}
+
+	*consumed = pos;
+	return status;
+}
+
+/*
+ * Dolu sayfa yazıldıktan sonra tamponu bir sonraki sayfaya kaydırır
+ */
+void Delta_Stream_NextPage(delta_stream_t *s)
+{
+	if (s == NULL)
+	{
+		return;
+	}
+
+	s->pageOffset	+= s->pageFill;
+	s->pageFill		 = 0U;
+}
+
+/*
+ * Akış bir kayıt sınırında bitmeli ve beklenen boyutu tam üretmiş olmalı
+ */
+bool Delta_Stream_IsComplete(const delta_stream_t *s)
+{
+	if (s == NULL)
+	{
+		return false;
+	}
+
+	if (s->outPos != s->outLimit)
+	{
+		return false;
+	}
+
+	return (s->state == DELTA_STATE_OP) ||
+		   ((s->state == DELTA_STATE_BODY) && (s->remaining == 0U));
+}
@@ -8,10 +8,45 @@
 #ifndef BOOTLOADER_DRIVERS_FLASH_DRIVER_INC_FLASH_DRIVER_H_
 #define BOOTLOADER_DRIVERS_FLASH_DRIVER_INC_FLASH_DRIVER_H_
 
+#include <stdbool.h>
 #include "main.h"
 
+/* Asenkron flash motorunda aynı anda sırada bekleyebilecek iş sayısı */
+#define FLASH_ASYNC_QUEUE_DEPTH		4U
+
+typedef enum
+{
+    FLASH_ASYNC_IDLE = 0,
+    FLASH_ASYNC_BUSY,
+    FLASH_ASYNC_ERROR
+} flash_async_status_t;
+
+/* Bir adres aralığı bank sınırında en fazla iki parçaya bölünür */
+#define FLASH_MAX_PAGE_SPANS		2U
+
+typedef struct
+{
+    uint32_t bank;      /* FLASH_BANK_1 / FLASH_BANK_2 */
+    uint32_t page;      /* Bank içindeki ilk sayfa */
+    uint32_t nbPages;
+} flash_page_span_t;
+
+uint8_t Flash_MapRange(uint32_t address, uint32_t length, flash_page_span_t *spans);
+bool Flash_IsBankSwapped(void);
+bool Flash_SetBankSwap(bool swapped);
+
 void Flash_Read(uint32_t flash_addr, void *dst, uint32_t len);
 bool Flash_Erase(uint32_t address);
+bool Flash_EraseRange(uint32_t address, uint32_t length);
 bool Flash_Write(uint32_t address, const uint8_t *data, uint32_t length);
 
+void Flash_Async_Init(void);
+bool Flash_Async_Erase(uint32_t bank, uint32_t page, uint32_t nbPages);
+bool Flash_Async_EraseRange(uint32_t address, uint32_t length);
+bool Flash_Async_Program(uint32_t address, const uint8_t *data, uint32_t length);
+flash_async_status_t Flash_Async_Status(void);
+bool Flash_Async_Wait(void);
+void Flash_Async_ClearError(void);
+void Flash_Async_IRQHandler(void);
+
 #endif /* BOOTLOADER_DRIVERS_FLASH_DRIVER_INC_FLASH_DRIVER_H_ */
@@ -8,6 +8,101 @@
 #include <string.h>
 #include "bootloader_driver.h"
 
+#define FLASH_QUADWORD_SIZE		16U
+#define FLASH_BURST_SIZE		(FLASH_NB_WORDS_IN_BURST * 4U)	/* 8 quad-word = 128 byte */
+
+typedef enum
+{
+    FLASH_JOB_ERASE = 0,
+    FLASH_JOB_PROGRAM
+} flash_job_type_t;
+
+typedef struct
+{
+    flash_job_type_t type;
+    uint32_t         bank;      /* ERASE: bank */
+    uint32_t         address;   /* ERASE: ilk sayfa, PROGRAM: hedef adres */
+    const uint8_t    *data;     /* PROGRAM: iş bitene kadar geçerli kalmalı */
+    uint32_t         length;    /* ERASE: sayfa sayısı, PROGRAM: byte */
+} flash_job_t;
+
+/*
+ * Asenkron motor: işler sırayla yürütülür, her erase / burst / quad-word programlama
+ * FLASH kesmesinde biter ve sıradaki adım aynı kesmede başlatılır.
+ */
+static flash_job_t                   flashJobQueue[FLASH_ASYNC_QUEUE_DEPTH];
+static volatile uint8_t              flashJobTail;
+static volatile uint8_t              flashJobCount;
+static volatile uint32_t             flashJobProgress;   /* PROGRAM: yazılan byte, ERASE: 1 = başladı */
+static volatile bool                 flashOpDone;
+static volatile bool                 flashOpError;
+static volatile flash_async_status_t flashAsyncStatus = FLASH_ASYNC_IDLE;
+
+/* Hizasız kaynak / kısmi son quad için ara buffer; yalnızca Program çağrısı süresince kullanılır */
+static uint32_t                      flashStageBuf[FLASH_BURST_SIZE / 4U];
+
+static bool Flash_IsErased(const uint8_t *data, uint32_t length)
+{
+    for (uint32_t i = 0U; i < length; i++)
+    {
+        if (data[i] != 0xFFU)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Sıradaki programlama adımını hazırlar. Hedef 128 byte hizalı ve en az 128 byte
+ * kaldıysa burst (8 quad-word tek işlemde), aksi halde quad-word. Word hizalı tam
+ * adımlar doğrudan kaynaktan yazılır; diğerleri ara buffer'a kopyalanır, kısmi son
+ * quad 0xFF ile doldurulur.
+ *
+ * type  : FLASH_TYPEPROGRAM_BURST / FLASH_TYPEPROGRAM_QUADWORD
+ * source: HAL_FLASH_Program kaynağı, tamamı 0xFF olan adımda 0 (atlanır,
+ *         silinmiş flash zaten 0xFF okur)
+ * return: adımın kapsadığı kaynak byte sayısı
+ */
+static uint32_t Flash_PrepareStep(uint32_t address, const uint8_t *data, uint32_t remaining,
+                                  uint32_t *type, uint32_t *source)
+{
+    uint32_t chunk;
+    uint32_t size;
+
+    if (((address % FLASH_BURST_SIZE) == 0U) && (remaining >= FLASH_BURST_SIZE))
+    {
+        *type = FLASH_TYPEPROGRAM_BURST;
+        size  = FLASH_BURST_SIZE;
+        chunk = FLASH_BURST_SIZE;
+    }
+    else
+    {
+        *type = FLASH_TYPEPROGRAM_QUADWORD;
+        size  = FLASH_QUADWORD_SIZE;
+        chunk = (remaining > FLASH_QUADWORD_SIZE) ? FLASH_QUADWORD_SIZE : remaining;
+    }
+
+    if ((chunk == size) && (((uint32_t)data % 4U) == 0U))
+    {
+        *source = (uint32_t)data;
+    }
+    else
+    {
+        memset(flashStageBuf, 0xFF, size);
+        memcpy(flashStageBuf, data, chunk);
+        *source = (uint32_t)flashStageBuf;
+    }
+
+    if (Flash_IsErased((const uint8_t *)*source, size) == true)
+    {
+        *source = 0U;
+    }
+
+    return chunk;
+}
+
 void Flash_Read(uint32_t flash_addr, void *dst, uint32_t len)
 {
     if ((dst == NULL) || (len == 0U))
@@ -20,32 +115,133 @@ void Flash_Read(uint32_t flash_addr, void *dst, uint32_t len)
     memcpy(dst, src, len);
 }
 
-bool Flash_Erase(uint32_t address)
+/*
+ * Adres aralığını (bank, sayfa) parçalarına çevirir.
+ *
+ * STM32U5:
+ * Page size = 8 KB, her bankta FLASH_PAGE_NB sayfa
+ * Bank 1: FLASH_BASE ..., Bank 2: FLASH_BASE + FLASH_BANK_SIZE ...
+ * Page index bank içindedir: ((Address - FLASH_BASE) / FLASH_PAGE_SIZE) % FLASH_PAGE_NB
+ * SWAP_BANK set ise adres haritasında bankların yeri değişir; erase fiziksel bankı seçer
+ *
+ * spans : en az FLASH_MAX_PAGE_SPANS elemanlı dizi
+ * return: parça sayısı, aralık flash dışındaysa 0
+ */
+uint8_t Flash_MapRange(uint32_t address, uint32_t length, flash_page_span_t *spans)
 {
-    FLASH_EraseInitTypeDef erase_init;
-    uint32_t page_error = 0U;
+    uint8_t  count = 0U;
+    uint32_t first;
+    uint32_t last;
+
+    if ((spans == NULL) || (length == 0U) || (address < FLASH_BASE))
+    {
+        return 0U;
+    }
+
+    /* FLASH_BASE'ten itibaren sayfa numaraları (bank 2 sayfaları FLASH_PAGE_NB'den başlar) */
+    first = (address - FLASH_BASE) / FLASH_PAGE_SIZE;
+    last  = ((address - FLASH_BASE) + length - 1U) / FLASH_PAGE_SIZE;
+
+    if ((last < first) || (last >= (2U * FLASH_PAGE_NB)))
+    {
+        return 0U;
+    }
+
+    while (first <= last)
+    {
+        uint32_t bankIndex = first / FLASH_PAGE_NB;
+        uint32_t physical  = (Flash_IsBankSwapped() == true) ? (bankIndex ^ 1U) : bankIndex;
+        uint32_t bankLast  = ((bankIndex + 1U) * FLASH_PAGE_NB) - 1U;
+        uint32_t spanLast  = (last < bankLast) ? last : bankLast;
+
+        spans[count].bank    = (physical == 0U) ? FLASH_BANK_1 : FLASH_BANK_2;
+        spans[count].page    = first % FLASH_PAGE_NB;
+        spans[count].nbPages = (spanLast - first) + 1U;
+
+        count += 1U;
+        first  = spanLast + 1U;
+    }
+
+    return count;
+}
+
+bool Flash_IsBankSwapped(void)
+{
+    return (READ_BIT(FLASH->OPTR, FLASH_OPTR_SWAP_BANK) != 0U);
+}
 
-    /* STM32U5:
-     * Page size = 8 KB
-     * Page index = (Address - FLASH_BASE) / FLASH_PAGE_SIZE
-     * Metadata region is in BANK2 (0x083C0000 ...)
-     */
+/*
+ * SWAP_BANK option byte'ını yazar ve option byte yüklemesini başlatır.
+ * Yükleme cihazı reset'ler: başarılı olursa fonksiyon dönmez.
+ *
+ * return false: option byte yazılamadı, banklar değişmedi
+ */
+bool Flash_SetBankSwap(bool swapped)
+{
+    FLASH_OBProgramInitTypeDef ob_init;
 
-    uint32_t page = (address - FLASH_BASE) / FLASH_PAGE_SIZE;
+    memset(&ob_init, 0, sizeof(ob_init));
+
+    ob_init.OptionType = OPTIONBYTE_USER;
+    ob_init.USERType   = OB_USER_SWAP_BANK;
+    ob_init.USERConfig = (swapped == true) ? OB_SWAP_BANK_ENABLE : OB_SWAP_BANK_DISABLE;
+
+    (void)Flash_Async_Wait();
 
     HAL_FLASH_Unlock();
+    HAL_FLASH_OB_Unlock();
 
-    erase_init.TypeErase = FLASH_TYPEERASE_PAGES;
-    erase_init.Banks     = FLASH_BANK_2;   /* 0x083C0000 -> Bank 2 */
-    erase_init.Page      = page;
-    erase_init.NbPages   = 1;
+    if (HAL_FLASHEx_OBProgram(&ob_init) == HAL_OK)
+    {
+        (void)HAL_FLASH_OB_Launch();
+    }
 
-    if (HAL_FLASHEx_Erase(&erase_init, &page_error) != HAL_OK)
+    HAL_FLASH_OB_Lock();
+    HAL_FLASH_Lock();
+
+    return false;
+}
+
+bool Flash_Erase(uint32_t address)
+{
+    /* Metadata region is in BANK2 (0x083C0000 ...) */
+    return Flash_EraseRange(address, FLASH_PAGE_SIZE);
+}
+
+/*
+ * Aralığın kapsadığı tüm sayfaları siler; her bank tek çok sayfalı işlemle
+ */
+bool Flash_EraseRange(uint32_t address, uint32_t length)
+{
+    FLASH_EraseInitTypeDef erase_init;
+    flash_page_span_t      spans[FLASH_MAX_PAGE_SPANS];
+    uint32_t               page_error = 0U;
+    uint8_t                count      = Flash_MapRange(address, length, spans);
+
+    if (count == 0U)
     {
-        HAL_FLASH_Lock();
         return false;
     }
 
+    /* Asenkron motor çalışırken kilit / CR paylaşılamaz */
+    (void)Flash_Async_Wait();
+
+    HAL_FLASH_Unlock();
+
+    for (uint8_t i = 0U; i < count; i++)
+    {
+        erase_init.TypeErase = FLASH_TYPEERASE_PAGES;
+        erase_init.Banks     = spans[i].bank;
+        erase_init.Page      = spans[i].page;
+        erase_init.NbPages   = spans[i].nbPages;
+
+        if (HAL_FLASHEx_Erase(&erase_init, &page_error) != HAL_OK)
+        {
+            HAL_FLASH_Lock();
+            return false;
+        }
+    }
+
     HAL_FLASH_Lock();
     return true;
 }
@@ -61,35 +257,312 @@ bool Flash_Write(uint32_t address, const uint8_t *data, uint32_t length)
         return false;
     }
 
+    (void)Flash_Async_Wait();
+
     HAL_FLASH_Unlock();
 
     while (offset < length)
     {
-        uint8_t quad_buf[16];
-        memset(quad_buf, 0xFF, sizeof(quad_buf));
+        uint32_t type;
+        uint32_t source;
+        uint32_t chunk = Flash_PrepareStep(write_addr, &data[offset], length - offset, &type, &source);
 
-        uint32_t chunk = length - offset;
-        if (chunk > 16U)
+        if (source != 0U)
         {
-            chunk = 16U;
+            if (HAL_FLASH_Program(type, write_addr, source) != HAL_OK)
+            {
+                HAL_FLASH_Lock();
+                return false;
+            }
         }
 
-        memcpy(quad_buf, &data[offset], chunk);
+        /* Kısmi adım yalnızca sonda olur: adres ilerlemesi sonraki turu etkilemez */
+        write_addr += chunk;
+        offset     += chunk;
+    }
+
+    HAL_FLASH_Lock();
+    return true;
+}
 
-        if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_QUADWORD,
-                              write_addr,
-                              (uint32_t)quad_buf) != HAL_OK)
+
+
+
+/*
+ * Sıranın başındaki işin sıradaki adımını başlatır; biten işleri sıradan çıkarır.
+ * Kesme içinden ya da FLASH kesmesi kapalıyken çağrılır.
+ */
+static void Flash_Async_Start(void)
+{
+    while (flashJobCount != 0U)
+    {
+        flash_job_t *job = &flashJobQueue[flashJobTail];
+
+        if (job->type == FLASH_JOB_ERASE)
         {
-            HAL_FLASH_Lock();
-            return false;
+            FLASH_EraseInitTypeDef erase_init;
+
+            if (flashJobProgress != 0U)
+            {
+                /* Silme tamamlandı */
+                flashJobTail     = (uint8_t)((flashJobTail + 1U) % FLASH_ASYNC_QUEUE_DEPTH);
+                flashJobCount   -= 1U;
+                flashJobProgress = 0U;
+                continue;
+            }
+
+            erase_init.TypeErase = FLASH_TYPEERASE_PAGES;
+            erase_init.Banks     = job->bank;
+            erase_init.Page      = job->address;
+            erase_init.NbPages   = job->length;
+
+            flashJobProgress = 1U;
+
+            if (HAL_FLASHEx_Erase_IT(&erase_init) != HAL_OK)
+            {
+                break;
+            }
+
+            return;
         }
 
-        write_addr += 16U;
-        offset     += chunk;
+        /* Tamamı 0xFF olan adımlar kesme beklemeden atlanır */
+        while (flashJobProgress < job->length)
+        {
+            uint32_t address = job->address + flashJobProgress;
+            uint32_t type;
+            uint32_t source;
+
+            flashJobProgress += Flash_PrepareStep(address,
+                                                  &job->data[flashJobProgress],
+                                                  job->length - flashJobProgress,
+                                                  &type,
+                                                  &source);
+
+            if (source != 0U)
+            {
+                if (HAL_FLASH_Program_IT(type, address, source) != HAL_OK)
+                {
+                    flashOpError = true;
+                    break;
+                }
+
+                return;
+            }
+        }
+
+        if (flashOpError == true)
+        {
+            break;
+        }
+
+        flashJobTail     = (uint8_t)((flashJobTail + 1U) % FLASH_ASYNC_QUEUE_DEPTH);
+        flashJobCount   -= 1U;
+        flashJobProgress = 0U;
+    }
+
+    if (flashJobCount != 0U)
+    {
+        /* Başlatılamayan iş: sıra düşürülür, hata ClearError'a kadar korunur */
+        flashJobCount    = 0U;
+        flashJobProgress = 0U;
+        flashOpError     = false;
+        flashAsyncStatus = FLASH_ASYNC_ERROR;
+    }
+    else
+    {
+        flashAsyncStatus = FLASH_ASYNC_IDLE;
     }
 
     HAL_FLASH_Lock();
+}
+
+/*
+ * İşi sıraya ekler, motor boştaysa hemen başlatır
+ */
+static bool Flash_Async_Push(const flash_job_t *job)
+{
+    bool accepted = false;
+
+    HAL_NVIC_DisableIRQ(FLASH_IRQn);
+
+    if ((flashAsyncStatus != FLASH_ASYNC_ERROR) && (flashJobCount < FLASH_ASYNC_QUEUE_DEPTH))
+    {
+        flashJobQueue[(flashJobTail + flashJobCount) % FLASH_ASYNC_QUEUE_DEPTH] = *job;
+        flashJobCount += 1U;
+        accepted       = true;
+
+        if (flashAsyncStatus == FLASH_ASYNC_IDLE)
+        {
+            flashAsyncStatus = FLASH_ASYNC_BUSY;
+            flashJobProgress = 0U;
+
+            HAL_FLASH_Unlock();
+            Flash_Async_Start();
+        }
+    }
+
+    HAL_NVIC_EnableIRQ(FLASH_IRQn);
+
+    return accepted;
+}
+
+void Flash_Async_Init(void)
+{
+    flashJobTail     = 0U;
+    flashJobCount    = 0U;
+    flashJobProgress = 0U;
+    flashOpDone      = false;
+    flashOpError     = false;
+    flashAsyncStatus = FLASH_ASYNC_IDLE;
+
+    /* USB (0) kesmesinin altında: alım flash işlerinden etkilenmez */
+    HAL_NVIC_SetPriority(FLASH_IRQn, 1, 0);
+    HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+bool Flash_Async_Erase(uint32_t bank, uint32_t page, uint32_t nbPages)
+{
+    flash_job_t job;
+
+    if (nbPages == 0U)
+    {
+        return true;
+    }
+
+    job.type    = FLASH_JOB_ERASE;
+    job.bank    = bank;
+    job.address = page;
+    job.data    = NULL;
+    job.length  = nbPages;
+
+    return Flash_Async_Push(&job);
+}
+
+bool Flash_Async_EraseRange(uint32_t address, uint32_t length)
+{
+    flash_page_span_t spans[FLASH_MAX_PAGE_SPANS];
+    uint8_t           count = Flash_MapRange(address, length, spans);
+
+    if (count == 0U)
+    {
+        return false;
+    }
+
+    for (uint8_t i = 0U; i < count; i++)
+    {
+        if (Flash_Async_Erase(spans[i].bank, spans[i].page, spans[i].nbPages) != true)
+        {
+            return false;
+        }
+    }
+
     return true;
 }
 
+bool Flash_Async_Program(uint32_t address, const uint8_t *data, uint32_t length)
+{
+    flash_job_t job;
+
+    /* STM32U5: address must be 16-byte aligned */
+    if (((address % 16U) != 0U) || (data == NULL))
+    {
+        return false;
+    }
+
+    if (length == 0U)
+    {
+        return true;
+    }
+
+    job.type    = FLASH_JOB_PROGRAM;
+    job.bank    = 0U;
+    job.address = address;
+    job.data    = data;
+    job.length  = length;
+
+    return Flash_Async_Push(&job);
+}
+
+flash_async_status_t Flash_Async_Status(void)
+{
+    return flashAsyncStatus;
+}
+
+/*
+ * Sıradaki tüm işler bitene kadar bekler (işler kesmede ilerler)
+ *
+ * return true: işler hatasız tamamlandı
+ */
+bool Flash_Async_Wait(void)
+{
+    while (flashAsyncStatus == FLASH_ASYNC_BUSY)
+    {
+    }
+
+    return (flashAsyncStatus == FLASH_ASYNC_IDLE);
+}
+
+void Flash_Async_ClearError(void)
+{
+    HAL_NVIC_DisableIRQ(FLASH_IRQn);
+
+    if (flashAsyncStatus == FLASH_ASYNC_ERROR)
+    {
+        flashAsyncStatus = FLASH_ASYNC_IDLE;
+    }
+
+    HAL_NVIC_EnableIRQ(FLASH_IRQn);
+}
+
+/*
+ * FLASH_IRQHandler'dan çağrılır. Sıradaki adım HAL kilidi bırakıldıktan sonra,
+ * yani HAL_FLASH_IRQHandler döndükten sonra başlatılır.
+ */
+void Flash_Async_IRQHandler(void)
+{
+    HAL_FLASH_IRQHandler();
+
+    if (flashAsyncStatus != FLASH_ASYNC_BUSY)
+    {
+        return;
+    }
+
+    if (flashOpError == true)
+    {
+        flashJobCount    = 0U;
+        flashJobProgress = 0U;
+        flashOpError     = false;
+        flashOpDone      = false;
+        flashAsyncStatus = FLASH_ASYNC_ERROR;
+
+        HAL_FLASH_Lock();
+        return;
+    }
 
+    if (flashOpDone == true)
+    {
+        flashOpDone = false;
+        Flash_Async_Start();
+    }
+}
+
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue)
+{
+    /* Çok sayfalı silmede her sayfa için çağrılır; 0xFFFFFFFF son sayfadır */
+    if ((flashJobCount != 0U) &&
+        (flashJobQueue[flashJobTail].type == FLASH_JOB_ERASE) &&
+        (ReturnValue != 0xFFFFFFFFU))
+    {
+        return;
+    }
+
+    flashOpDone = true;
+}
+
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue)
+{
+    (void)ReturnValue;
+
+    flashOpError = true;
+}
@@ -0,0 +1,75 @@
+/*
+ * lz4_stream.h
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#ifndef BOOTLOADER_DRIVERS_LZ4_DRIVER_INC_LZ4_STREAM_H_
+#define BOOTLOADER_DRIVERS_LZ4_DRIVER_INC_LZ4_STREAM_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+/*
+ * LZ4 block formatındaki sıkıştırılmış imajı parça parça açar.
+ *
+ * Girdi ham bir LZ4 block'tur, LZ4 frame (.lz4 dosyası) değildir: magic,
+ * frame descriptor, block boyutu ve checksum alanları olmadan tek bir dizi
+ * akışı beklenir. Host tarafında LZ4_compress_default() çıktısı ya da
+ * Host/Tools/lz4_block.c ile üretilir. Açılmış boyut PACKET_INFO'daki imaj
+ * boyutu ile verilir.
+ *
+ * Çıktı sayfa boyutunda bir tampona yazılır; tampon dolunca çağıran taraf
+ * sayfayı flash'a yazar ve LZ4_Stream_NextPage() ile devam eder. Önceki
+ * sayfalara yapılan geri referanslar (en fazla 64 KB) doğrudan hedef
+ * adresten (memory-mapped flash) okunur, RAM'de ayrı bir pencere tutulmaz.
+ */
+
+#define LZ4_STREAM_PAGE_SIZE		(8U * 1024U)
+#define LZ4_STREAM_MIN_MATCH		(4U)
+
+typedef enum
+{
+	LZ4_STREAM_NEED_INPUT = 0,		// Girdi tükendi, sonraki parça bekleniyor
+	LZ4_STREAM_PAGE_READY,			// Sayfa tamponu doldu, yazılmalı
+	LZ4_STREAM_ERROR				// Bozuk akış veya çıktı sınırı aşıldı
+}lz4_stream_status_t;
+
+typedef enum
+{
+	LZ4_STATE_TOKEN = 0,
+	LZ4_STATE_LITERAL_LEN,
+	LZ4_STATE_LITERALS,
+	LZ4_STATE_OFFSET_LO,
+	LZ4_STATE_OFFSET_HI,
+	LZ4_STATE_MATCH_LEN,
+	LZ4_STATE_MATCH
+}lz4_stream_state_t;
+
+typedef struct
+{
+	lz4_stream_state_t	state;
+	uint8_t				token;
+	uint32_t			literalLen;
+	uint32_t			matchLen;
+	uint32_t			matchOffset;
+
+	const uint8_t		*history;		// Çıktının başlangıç adresi (yazılmış sayfalar buradan okunur)
+	uint32_t			outLimit;		// Açılmış imajın beklenen boyutu
+	uint32_t			outPos;			// Üretilen toplam byte
+	uint32_t			pageOffset;		// Tampondaki sayfanın imaj içindeki offset'i
+	uint32_t			pageFill;		// Tampondaki geçerli byte sayısı
+
+	uint8_t				page[LZ4_STREAM_PAGE_SIZE] __attribute__((aligned(16)));
+}lz4_stream_t;
+
+void LZ4_Stream_Init(lz4_stream_t *s, const uint8_t *history, uint32_t outLimit);
+lz4_stream_status_t LZ4_Stream_Decode(lz4_stream_t *s,
+									  const uint8_t *in,
+									  uint32_t len,
+									  uint32_t *consumed);
+void LZ4_Stream_NextPage(lz4_stream_t *s);
+bool LZ4_Stream_IsComplete(const lz4_stream_t *s);
+
+#endif /* BOOTLOADER_DRIVERS_LZ4_DRIVER_INC_LZ4_STREAM_H_ */
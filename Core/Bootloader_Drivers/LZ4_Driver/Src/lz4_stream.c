@@ -0,0 +1,268 @@
+/*
+ * lz4_stream.c
+ *
+ *  Created on: Oct 17, 2026
+ */
+
+#include <string.h>
+#include "lz4_stream.h"
+
+static uint32_t LZ4_Stream_Min(uint32_t a, uint32_t b)
+{
+	return (a < b) ? a : b;
+}
+
+/*
+ * Eşleşmenin n byte'ını sayfa tamponuna kopyalar. Kaynak önceki sayfalardaysa
+ * history'den (flash), tampondaysa tamponun kendisinden okunur. Offset n'den
+ * küçükse kaynak ile hedef örtüşür; LZ4 bunu ileri yönlü byte kopyası olarak tanımlar.
+ */
+static void LZ4_Stream_CopyMatch(lz4_stream_t *s, uint32_t n)
+{
+	uint32_t	src 	= s->outPos - s->matchOffset;
+	uint8_t		*dst 	= &s->page[s->pageFill];
+	uint32_t	left 	= n;
+
+	if (src < s->pageOffset)
+	{
+		uint32_t run = LZ4_Stream_Min(left, s->pageOffset - src);
+
+		memcpy(dst, &s->history[src], run);
+
+		dst 	+= run;
+		src 	+= run;
+		left 	-= run;
+	}
+
+	if (left > 0U)
+	{
+		const uint8_t *p = &s->page[src - s->pageOffset];
+
+		if ((uint32_t)(dst - p) >= left)
+		{
+			memcpy(dst, p, left);
+		}
+		else
+		{
+			while (left-- > 0U)
+			{
+				*dst++ = *p++;
+			}
+		}
+	}
+
+	s->pageFill += n;
+	s->outPos	+= n;
+	s->matchLen -= n;
+}
+
+void LZ4_Stream_Init(lz4_stream_t *s, const uint8_t *history, uint32_t outLimit)
+{
+	if (s == NULL)
+	{
+		return;
+	}
+
+	s->state		= LZ4_STATE_TOKEN;
+	s->token		= 0U;
+	s->literalLen	= 0U;
+	s->matchLen		= 0U;
+	s->matchOffset	= 0U;
+
+	s->history		= history;
+	s->outLimit		= outLimit;
+	s->outPos		= 0U;
+	s->pageOffset	= 0U;
+	s->pageFill		= 0U;
+}
+
+/*
+ * in[0..len) parçasını açar. Sayfa tamponu dolarsa LZ4_STREAM_PAGE_READY ile
+ * döner; çağıran sayfayı yazıp LZ4_Stream_NextPage() sonrası kalan girdiyle
+ * (in + *consumed) tekrar çağırır. LZ4_STREAM_NEED_INPUT: girdinin tamamı işlendi.
+ */
+lz4_stream_status_t LZ4_Stream_Decode(lz4_stream_t *s,
+									  const uint8_t *in,
+									  uint32_t len,
+									  uint32_t *consumed)
+{
+	lz4_stream_status_t status;
+	uint32_t			pos = 0U;
+	uint32_t			n;
+	uint8_t				b;
+
+	if ((s == NULL) || (consumed == NULL) || ((in == NULL) && (len > 0U)))
+	{
+		return LZ4_STREAM_ERROR;
+	}
+
+	for (;;)
+	{
+		if (s->pageFill >= LZ4_STREAM_PAGE_SIZE)
+		{
+			status = LZ4_STREAM_PAGE_READY;
+			break;
+		}
+
+		/* Eşleşme kopyası ve uzunluk geçişleri girdi tüketmez */
+		if ((pos >= len) &&
+			(s->state != LZ4_STATE_MATCH) &&
+			!((s->state == LZ4_STATE_LITERALS) && (s->literalLen == 0U)))
+		{
+			status = LZ4_STREAM_NEED_INPUT;
+			break;
+		}
+
+		switch (s->state)
+		{
+		case LZ4_STATE_TOKEN:
+
+			s->token		= in[pos++];
+			s->literalLen	= (uint32_t)(s->token >> 4);
+			s->state		= (s->literalLen == 15U) ? LZ4_STATE_LITERAL_LEN : LZ4_STATE_LITERALS;
+			break;
+
+		case LZ4_STATE_LITERAL_LEN:
+
+			b				= in[pos++];
+			s->literalLen  += b;
+
+			if (b != 255U)
+			{
+				s->state = LZ4_STATE_LITERALS;
+			}
+			break;
+
+		case LZ4_STATE_LITERALS:
+
+			if (s->literalLen == 0U)
+			{
+				s->state = LZ4_STATE_OFFSET_LO;
+				break;
+			}
+
+			if (s->literalLen > (s->outLimit - s->outPos))
+			{
+				*consumed = pos;
+				return LZ4_STREAM_ERROR;
+			}
+
+			n = LZ4_Stream_Min(s->literalLen, len - pos);
+			n = LZ4_Stream_Min(n, LZ4_STREAM_PAGE_SIZE - s->pageFill);
+
+			memcpy(&s->page[s->pageFill], &in[pos], n);
+
+			pos				+= n;
+			s->pageFill		+= n;
+			s->outPos		+= n;
+			s->literalLen	-= n;
+			break;
+
+		case LZ4_STATE_OFFSET_LO:
+
+			s->matchOffset	= in[pos++];
+			s->state		= LZ4_STATE_OFFSET_HI;
+			break;
+
+		case LZ4_STATE_OFFSET_HI:
+
+			s->matchOffset |= (uint32_t)in[pos++] << 8;
+
+			if ((s->matchOffset == 0U) || (s->matchOffset > s->outPos))
+			{
+				*consumed = pos;
+				return LZ4_STREAM_ERROR;
+			}
+
+			s->matchLen = (uint32_t)(s->token & 0x0FU);
+
+			if (s->matchLen == 15U)
+			{
+				s->state = LZ4_STATE_MATCH_LEN;
+			}
+			else
+			{
+				s->matchLen += LZ4_STREAM_MIN_MATCH;
+				s->state	 = LZ4_STATE_MATCH;
+			}
+			break;
+
+		case LZ4_STATE_MATCH_LEN:
+
+			b				= in[pos++];
+			s->matchLen	   += b;
+
+			if (b != 255U)
+			{
+				s->matchLen += LZ4_STREAM_MIN_MATCH;
+				s->state	 = LZ4_STATE_MATCH;
+			}
+			break;
+
+		case LZ4_STATE_MATCH:
+
+			if (s->matchLen == 0U)
+			{
+				s->state = LZ4_STATE_TOKEN;
+				break;
+			}
+
+			if (s->matchLen > (s->outLimit - s->outPos))
+			{
+				*consumed = pos;
+				return LZ4_STREAM_ERROR;
+			}
+
+			LZ4_Stream_CopyMatch(s, LZ4_Stream_Min(s->matchLen, LZ4_STREAM_PAGE_SIZE - s->pageFill));
+			break;
+
+		default:
+
+			*consumed = pos;
+			return LZ4_STREAM_ERROR;
+		}
+
+		/* 255'lerle şişirilmiş uzunluklar taşmadan önce reddedilir */
+		if ((s->literalLen > s->outLimit) || (s->matchLen > s->outLimit))
+		{
+			*consumed = pos;
+			return LZ4_STREAM_ERROR;
+		}
+	}
+
+	*consumed = pos;
+	return status;
+}
+
+/*
+ * Dolu sayfa yazıldıktan sonra tamponu bir sonraki sayfaya kaydırır
+ */
+void LZ4_Stream_NextPage(lz4_stream_t *s)
+{
+	if (s == NULL)
+	{
+		return;
+	}
+
+	s->pageOffset	+= s->pageFill;
+	s->pageFill		 = 0U;
+}
+
+/*
+ * Akış son literal dizisinden sonra bitmeli ve beklenen boyutu tam üretmiş olmalı
+ */
+bool LZ4_Stream_IsComplete(const lz4_stream_t *s)
+{
+	if (s == NULL)
+	{
+		return false;
+	}
+
+	if (s->outPos != s->outLimit)
+	{
+		return false;
+	}
+
+	return (s->state == LZ4_STATE_OFFSET_LO) ||
+		   ((s->state == LZ4_STATE_LITERALS) && (s->literalLen == 0U));
+}
@@ -22,11 +22,20 @@ extern "C" {
  * ========================================================= */
 #define BL_META_BASE_ADDR     	0x083C0000UL
 #define META_FLASH_ADDR			BL_META_BASE_ADDR
+/* Bank swap boot: diğer bankın aynı offset'i, SWAP_BANK değişince META_FLASH_ADDR'e taşınır */
+#define META_MIRROR_FLASH_ADDR	(BL_META_BASE_ADDR - 0x00200000UL)
 #define BL_META_SIZE_BYTES   	(256UL * 1024UL)
 #define BL_META_PAGE_SIZE    	(8UL * 1024UL)
 
 #define META_MAGIC   (0x4D455441UL)   /* 'META' ASCII */
 
+/*
+ * Kayıt sürümü. 1: tek sayfalık ilk kayıt (progress_crc32 yok, 60 B),
+ * 2: progress_crc32 eklenmiş tek sayfalık kayıt (64 B), 3: journal kaydı.
+ * Eski kayıtlar Meta_Init'te okunup journal'a taşınır.
+ */
+#define META_RECORD_VERSION     3UL
+
 /* =========================================================
  * Slot abstraction (driver'dan bağımsız)
  * ========================================================= */
@@ -77,17 +86,30 @@ typedef struct
     uint32_t magic;
     uint32_t seq;
     uint32_t crc;
+    uint32_t version;                   /* META_RECORD_VERSION, Meta_WriteAt yazar */
 
     meta_slot_t     active_slot;
     meta_slot_t     target_slot;
     meta_update_state_t update_state;
 
-    uint32_t        progress_bytes;
+    uint32_t        progress_bytes;     /* IN_PROGRESS: hedef slota yazılmış (sayfa hizalı) byte sayısı */
+    uint32_t        progress_crc32;     /* Hedef slotun [0, progress_bytes) aralığının CRC32'si */
 
     meta_slot_info_t slotA;
     meta_slot_info_t slotB;
+
+    uint32_t        reserved[3];        /* Kayıt boyu 16 byte'ın katı (quad-word programlama) */
 } meta_record_t;
 
+/*
+ * Journal: metadata alanının her sayfası art arda kayıtlarla dolar, geçerli
+ * kayıt seq'i en yüksek olandır. Sayfa dolunca sıradaki sayfa silinir
+ * (son sayfadan sonra ilk sayfaya dönülür); en yeni kaydın sayfası hiç silinmez.
+ */
+#define META_JOURNAL_PAGES          (BL_META_SIZE_BYTES / BL_META_PAGE_SIZE)
+#define META_RECORD_SLOT_SIZE       ((sizeof(meta_record_t) + 15UL) & ~15UL)
+#define META_RECORDS_PER_PAGE       (BL_META_PAGE_SIZE / META_RECORD_SLOT_SIZE)
+
 /* =========================================================
  * PUBLIC API (Driver bundan başka hiçbir şey görmez)
  * ========================================================= */
@@ -109,6 +131,7 @@ bool Meta_IsEmpty(const meta_record_t *meta);
 
 bool Meta_Read(meta_record_t *meta);
 bool Meta_Write(meta_record_t *meta);
+bool Meta_WriteAt(uint32_t base, meta_record_t *meta);
 
 uint32_t Meta_SlotToBaseAddr(meta_slot_t slot);
 
@@ -8,6 +8,10 @@
  * Journal-based (append-only) metadata in flash:
  *   0x083C0000 - 0x083FFFFF (256KB, 32 pages @ 8KB)
  *
+ * Her yazma sıradaki boş kayıt yerine eklenir, geçerli kayıt seq'i en yüksek
+ * olandır. Yazma sırasında kesilen güç yalnızca yeni kaydı bozar, bir önceki
+ * kayıt okunmaya devam eder. Sayfa dolunca sıradaki sayfa silinir.
+ *
  * NOTE:
  * - This module DOES NOT include bootloader_driver.h
  * - It uses HAL flash erase/program (main.h dependency is OK for HAL).
@@ -19,80 +23,106 @@
 #include "main.h"
 #include <string.h>
 
+/* =========================================================
+ * Journal
+ * ========================================================= */
+#define META_WRITE_ATTEMPTS     3U      /* Doğrulanamayan yazmadan sonra denenecek kayıt yeri */
+
+typedef struct
+{
+    uint32_t newest;                    /* Seq'i en yüksek geçerli kaydın adresi, 0: kayıt yok */
+    uint32_t seq;                       /* O kaydın seq'i */
+} meta_journal_t;
+
+/* Sürüm 1: metadata alanının başındaki tek kayıt */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t crc;
+
+    meta_slot_t     active_slot;
+    meta_slot_t     target_slot;
+    meta_update_state_t update_state;
+
+    uint32_t        progress_bytes;
+
+    meta_slot_info_t slotA;
+    meta_slot_info_t slotB;
+} meta_record_v1_t;
+
+/* Sürüm 2: progress_crc32 araya eklenmiş tek kayıt */
+typedef struct
+{
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t crc;
+
+    meta_slot_t     active_slot;
+    meta_slot_t     target_slot;
+    meta_update_state_t update_state;
+
+    uint32_t        progress_bytes;
+    uint32_t        progress_crc32;
+
+    meta_slot_info_t slotA;
+    meta_slot_info_t slotB;
+} meta_record_v2_t;
+
+static bool     Meta_IsRecordValid(const meta_record_t *meta);
+static void     Meta_Journal_Scan(uint32_t base, meta_journal_t *journal);
+static uint32_t Meta_Journal_NextSlot(uint32_t base, uint32_t address, bool *erase);
+static uint32_t Meta_Legacy_Crc(const void *record, uint32_t size);
+static bool     Meta_Legacy_Read(uint32_t base, meta_record_t *meta);
+
 /* =========================================================
  * Public API
  * ========================================================= */
 void Meta_Init(meta_record_t *meta)
 {
-    meta_record_t flash_meta;
-    bool meta_valid = true;
+    meta_record_t  flash_meta;
+    meta_journal_t journal;
 
     if (meta == NULL)
     {
         return;
     }
 
-    /* 1- Flash’tan metadata oku */
-    Meta_Read(&flash_meta);
+    /* 1- Journal'daki en yeni geçerli kayıt */
+    Meta_Journal_Scan(META_FLASH_ADDR, &journal);
 
-    /* 2- Tümü 0xFF mi? (ilk kurulum) */
-    if (Meta_IsEmpty(&flash_meta))
+    if (journal.newest != 0U)
     {
-        Meta_Init_FromSlots(meta);
-        return;
+        Flash_Read(journal.newest, &flash_meta, sizeof(meta_record_t));
     }
-
-    /* 3- Magic kontrolü */
-    if (flash_meta.magic != META_MAGIC)
+    /* 2- Journal boş: eski sürüm kayıt varsa journal'a taşı */
+    else if (Meta_Legacy_Read(META_FLASH_ADDR, &flash_meta) == true)
     {
-        meta_valid = false;
+        (void)Meta_Write(&flash_meta);
     }
-
-    /* 4- Seq kontrolü */
-    if ((flash_meta.seq == 0U) || (flash_meta.seq == 0xFFFFFFFFU))
+    /* 3- İlk kurulum ya da bozuk metadata → slot bazlı yeniden kur */
+    else
     {
-        meta_valid = false;
+        Meta_Init_FromSlots(meta);
+        return;
     }
 
-    meta_record_t tmp = flash_meta;
-    tmp.crc = 0U;
-
-    /* 5- CRC kontrolü */
-    uint32_t calc_crc = CRC32_Calculate(
-        ((uint8_t *)&tmp) + sizeof(uint32_t),
-        sizeof(meta_record_t) - sizeof(uint32_t)
-    );
-
-    if (calc_crc != flash_meta.crc)
-    {
-        meta_valid = false;
-    }
+    *meta = flash_meta;
 
-    /* 6- Metadata geçerli mi? */
-    if (meta_valid == true)
+    /* Aktif slot gerçekten dolu mu? */
+    if (!Slot_IsValid(Meta_SlotToBaseAddr(meta->active_slot)))
     {
-        *meta = flash_meta;
-
-        /* Aktif slot gerçekten dolu mu? */
-        if (!Slot_IsValid(Meta_SlotToBaseAddr(meta->active_slot)))
+        if (Slot_IsValid(Meta_SlotToBaseAddr(meta->target_slot)))
         {
-            if (Slot_IsValid(Meta_SlotToBaseAddr(meta->target_slot)))
-            {
-                meta_slot_t t = meta->active_slot;
-                meta->active_slot = meta->target_slot;
-                meta->target_slot = t;
-            }
-            else
-            {
-                Meta_Init_FromSlots(meta);
-            }
+            meta_slot_t t = meta->active_slot;
+            meta->active_slot = meta->target_slot;
+            meta->target_slot = t;
+        }
+        else
+        {
+            Meta_Init_FromSlots(meta);
         }
-
-        return;
     }
-
-    /* ❌ Metadata bozuk → slot bazlı yeniden kur */
-    Meta_Init_FromSlots(meta);
 }
 
 uint32_t Meta_CalcCrc_NoSelf(const meta_record_t *m)
@@ -123,80 +153,45 @@ bool Meta_IsEmpty(const meta_record_t *meta)
 
 bool Meta_Read(meta_record_t *meta)
 {
-    uint32_t calculated_crc;
+    meta_journal_t journal;
 
     if (meta == NULL)
     {
         return false;
     }
 
-    /* -------------------------------------------------
-     * Read raw metadata from flash
-     * ------------------------------------------------- */
-    Flash_Read(
-        META_FLASH_ADDR,
-        (uint8_t *)meta,
-        sizeof(meta_record_t)
-    );
-
-    /* -------------------------------------------------
-     * Check magic
-     * ------------------------------------------------- */
-    if (meta->magic != META_MAGIC)
-    {
-        return false;
-    }
-
-    /* -------------------------------------------------
-     * CRC check (exclude crc field itself)
-     * ------------------------------------------------- */
-    calculated_crc = Meta_CalcCrc_NoSelf(meta);
-
-    if (calculated_crc != meta->crc)
-    {
-        return false;
-    }
-
-    /* -------------------------------------------------
-     * Slot sanity check
-     * ------------------------------------------------- */
-    if (meta->active_slot != META_SLOT_A &&
-        meta->active_slot != META_SLOT_B)
-    {
-        return false;
-    }
-
-    if (meta->target_slot != META_SLOT_A &&
-        meta->target_slot != META_SLOT_B)
-    {
-        return false;
-    }
+    Meta_Journal_Scan(META_FLASH_ADDR, &journal);
 
-    if (meta->active_slot == meta->target_slot)
+    if (journal.newest == 0U)
     {
-        return false;
+        /* Henüz taşınmamış eski sürüm kayıt */
+        return Meta_Legacy_Read(META_FLASH_ADDR, meta);
     }
 
-    /* -------------------------------------------------
-     * Update state sanity check
-     * ------------------------------------------------- */
-    switch (meta->update_state)
-    {
-        case META_UPDATE_IDLE:
-        case META_UPDATE_IN_PROGRESS:
-        //case META_UPDATE_DONE:
-        case META_UPDATE_NO_APP:
-            break;
-
-        default:
-            return false;
-    }
+    Flash_Read(journal.newest, meta, sizeof(meta_record_t));
 
     return true;
 }
 
 bool Meta_Write(meta_record_t *meta)
 {
+    return Meta_WriteAt(META_FLASH_ADDR, meta);
+}
+
+/*
+ * Kaydı verilen metadata alanının journal'ına ekler. Bank swap boot'ta commit,
+ * swap sonrası geçerli olacak kaydı META_MIRROR_FLASH_ADDR'e yazar.
+ *
+ * seq alandaki en yeni kayıttan büyük olacak şekilde ilerletilir; version ve
+ * crc burada doldurulur. Yazılan kayıt geri okunup karşılaştırılır, tutmazsa
+ * sıradaki yer denenir.
+ */
+bool Meta_WriteAt(uint32_t base, meta_record_t *meta)
+{
+    meta_journal_t journal;
+    meta_record_t  check;
+    uint32_t       address;
+
     if (meta == NULL)
     {
         return false;
@@ -210,34 +205,49 @@ bool Meta_Write(meta_record_t *meta)
         return false;
     }
 
-    /* -------------------------------------------------
-     * CRC yeniden hesapla
-     *  - crc alanı hariç tutulur
-     * ------------------------------------------------- */
-    meta->crc = 0U;
-    meta->crc = CRC32_Calculate(((uint8_t *)meta)+4, sizeof(meta_record_t)-4);
+    Meta_Journal_Scan(base, &journal);
 
-    /* -------------------------------------------------
-     * Flash erase
-     * ------------------------------------------------- */
-    if (Flash_Erase(META_FLASH_ADDR) != true)
+    if ((meta->seq == 0U) || ((journal.newest != 0U) && (meta->seq <= journal.seq)))
     {
-        return false;
+        meta->seq = journal.seq + 1U;
     }
 
     /* -------------------------------------------------
-     * Flash write
+     * CRC yeniden hesapla
+     *  - crc alanı hariç tutulur
      * ------------------------------------------------- */
-    if (Flash_Write(
-            META_FLASH_ADDR,
-            (uint8_t *)meta,
-            sizeof(meta_record_t)
-        ) != true)
+    meta->version = META_RECORD_VERSION;
+    meta->crc     = Meta_CalcCrc_NoSelf(meta);
+
+    address = (journal.newest != 0U) ? (journal.newest + META_RECORD_SLOT_SIZE) : base;
+
+    for (uint32_t attempt = 0U; attempt < META_WRITE_ATTEMPTS; attempt++)
     {
-        return false;
+        bool erase;
+
+        address = Meta_Journal_NextSlot(base, address, &erase);
+
+        /* Sayfa doldu: sıradaki sayfa silinir (en yeni kayıt önceki sayfada kalır) */
+        if ((erase == true) && (Flash_Erase(address) != true))
+        {
+            return false;
+        }
+
+        if (Flash_Write(address, (const uint8_t *)meta, sizeof(meta_record_t)) == true)
+        {
+            Flash_Read(address, &check, sizeof(meta_record_t));
+
+            if (memcmp(&check, meta, sizeof(meta_record_t)) == 0)
+            {
+                return true;
+            }
+        }
+
+        /* Yarım kalan yer atlanır */
+        address += META_RECORD_SLOT_SIZE;
     }
 
-    return true;
+    return false;
 }
 
 void Meta_Init_FromSlots(meta_record_t *meta)
@@ -270,11 +280,7 @@ void Meta_Init_FromSlots(meta_record_t *meta)
         return;
     }
 
-    meta->crc = 0U;
-    meta->crc = Meta_CalcCrc_NoSelf(meta);
-
-    Flash_Erase(META_FLASH_ADDR);
-    Flash_Write(META_FLASH_ADDR, (uint8_t *)meta, sizeof(meta_record_t));
+    (void)Meta_Write(meta);
 }
 
 /*
@@ -337,3 +343,188 @@ uint32_t Meta_SlotToBaseAddr(meta_slot_t slot)
     }
 }
 
+/* =========================================================
+ * Journal helpers
+ * ========================================================= */
+
+/*
+ * Kayıt geçerli mi: magic, sürüm, seq, CRC ve slot / state tutarlılığı
+ */
+static bool Meta_IsRecordValid(const meta_record_t *meta)
+{
+    if ((meta->magic != META_MAGIC) || (meta->version != META_RECORD_VERSION))
+    {
+        return false;
+    }
+
+    if ((meta->seq == 0U) || (meta->seq == 0xFFFFFFFFU))
+    {
+        return false;
+    }
+
+    if (Meta_CalcCrc_NoSelf(meta) != meta->crc)
+    {
+        return false;
+    }
+
+    /* -------------------------------------------------
+     * Slot sanity check
+     * ------------------------------------------------- */
+    if (meta->active_slot != META_SLOT_A &&
+        meta->active_slot != META_SLOT_B)
+    {
+        return false;
+    }
+
+    if (meta->target_slot != META_SLOT_A &&
+        meta->target_slot != META_SLOT_B)
+    {
+        return false;
+    }
+
+    if (meta->active_slot == meta->target_slot)
+    {
+        return false;
+    }
+
+    /* -------------------------------------------------
+     * Update state sanity check
+     * ------------------------------------------------- */
+    switch (meta->update_state)
+    {
+        case META_UPDATE_IDLE:
+        case META_UPDATE_IN_PROGRESS:
+        //case META_UPDATE_DONE:
+        case META_UPDATE_NO_APP:
+            break;
+
+        default:
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Alanın tüm sayfalarını tarar, seq'i en yüksek geçerli kaydı bulur.
+ * Sayfalar baştan doldurulduğu için ilk boş yerden sonrası okunmaz.
+ */
+static void Meta_Journal_Scan(uint32_t base, meta_journal_t *journal)
+{
+    meta_record_t rec;
+
+    journal->newest = 0U;
+    journal->seq    = 0U;
+
+    for (uint32_t page = 0U; page < META_JOURNAL_PAGES; page++)
+    {
+        for (uint32_t i = 0U; i < META_RECORDS_PER_PAGE; i++)
+        {
+            uint32_t address = base + (page * BL_META_PAGE_SIZE) + (i * META_RECORD_SLOT_SIZE);
+
+            Flash_Read(address, &rec, sizeof(meta_record_t));
+
+            if (Meta_IsEmpty(&rec))
+            {
+                break;
+            }
+
+            if ((Meta_IsRecordValid(&rec) == true) && ((journal->newest == 0U) || (rec.seq > journal->seq)))
+            {
+                journal->newest = address;
+                journal->seq    = rec.seq;
+            }
+        }
+    }
+}
+
+/*
+ * address'ten itibaren aynı sayfadaki ilk boş kayıt yerini döner. Sayfada yer
+ * yoksa sıradaki sayfanın (sondan sonra ilk sayfa) başını döner, erase = true:
+ * yazmadan önce silinmelidir.
+ */
+static uint32_t Meta_Journal_NextSlot(uint32_t base, uint32_t address, bool *erase)
+{
+    meta_record_t rec;
+    uint32_t      page  = (address - base) / BL_META_PAGE_SIZE;
+    uint32_t      index = ((address - base) % BL_META_PAGE_SIZE) / META_RECORD_SLOT_SIZE;
+
+    *erase = false;
+
+    for (; index < META_RECORDS_PER_PAGE; index++)
+    {
+        uint32_t slot = base + (page * BL_META_PAGE_SIZE) + (index * META_RECORD_SLOT_SIZE);
+
+        Flash_Read(slot, &rec, sizeof(meta_record_t));
+
+        if (Meta_IsEmpty(&rec))
+        {
+            return slot;
+        }
+    }
+
+    *erase = true;
+
+    return base + (((page + 1U) % META_JOURNAL_PAGES) * BL_META_PAGE_SIZE);
+}
+
+/*
+ * Eski kayıtların CRC'si: crc alanı 0, magic hariç kaydın kendi boyu
+ */
+static uint32_t Meta_Legacy_Crc(const void *record, uint32_t size)
+{
+    uint8_t tmp[sizeof(meta_record_v2_t)];
+
+    memcpy(tmp, record, size);
+    memset(&tmp[2U * sizeof(uint32_t)], 0, sizeof(uint32_t));
+
+    return CRC32_Calculate(&tmp[sizeof(uint32_t)], size - sizeof(uint32_t));
+}
+
+/*
+ * Alanın başındaki sürüm 1 / 2 kaydını güncel kayda çevirir.
+ * Sürüm 1'de ilerleme CRC'si olmadığından yarım güncelleme baştan başlar.
+ */
+static bool Meta_Legacy_Read(uint32_t base, meta_record_t *meta)
+{
+    meta_record_v1_t v1;
+    meta_record_v2_t v2;
+
+    Flash_Read(base, &v1, sizeof(v1));
+    Flash_Read(base, &v2, sizeof(v2));
+
+    memset(meta, 0, sizeof(meta_record_t));
+
+    if ((v2.magic == META_MAGIC) && (Meta_Legacy_Crc(&v2, sizeof(v2)) == v2.crc))
+    {
+        meta->seq            = v2.seq;
+        meta->active_slot    = v2.active_slot;
+        meta->target_slot    = v2.target_slot;
+        meta->update_state   = v2.update_state;
+        meta->progress_bytes = v2.progress_bytes;
+        meta->progress_crc32 = v2.progress_crc32;
+        meta->slotA          = v2.slotA;
+        meta->slotB          = v2.slotB;
+    }
+    else if ((v1.magic == META_MAGIC) && (Meta_Legacy_Crc(&v1, sizeof(v1)) == v1.crc))
+    {
+        meta->seq            = v1.seq;
+        meta->active_slot    = v1.active_slot;
+        meta->target_slot    = v1.target_slot;
+        meta->update_state   = v1.update_state;
+        meta->progress_bytes = 0U;
+        meta->progress_crc32 = 0U;
+        meta->slotA          = v1.slotA;
+        meta->slotB          = v1.slotB;
+    }
+    else
+    {
+        return false;
+    }
+
+    meta->magic   = META_MAGIC;
+    meta->version = META_RECORD_VERSION;
+    meta->crc     = Meta_CalcCrc_NoSelf(meta);
+
+    return Meta_IsRecordValid(meta);
+}
@@ -86,7 +86,23 @@
 
 #define USB_DATA_PAGE_COUNT							1
 
-#define USB_MAX_BUFFER_LEN          				5000 * USB_DATA_PAGE_COUNT
+/* En büyük frame: 8 KB transfer bloğu + paket (12) ve frame (10) başlıkları, 512'ye yuvarlı */
+#define USB_MAX_BUFFER_LEN          				(8704u * USB_DATA_PAGE_COUNT)
+
+/* RX frame havuzu: ana döngü frame'i ring'den bu buffer'lara çıkarır, doğrulama ve
+ * flash yazımı aynı buffer üzerinden (kopyasız) yapılır.
+ * Sayı: update penceresi (8) + doğrulanan + yedek frame'ler */
+#define USB_RX_FRAME_POOL_COUNT						12u
+#define USB_RX_FRAME_ALIGN							32u
+#define USB_RX_EP_PACKET_SIZE						512u	/* CDC HS OUT endpoint transfer boyutu */
+
+/* ISR -> ana döngü byte ring'i: 2'nin kuvveti, en az bir frame + iki transfer */
+#define USB_RX_RING_SIZE							32768u
+#define USB_RX_RING_MASK							(USB_RX_RING_SIZE - 1u)
+
+/* TX kuyruğu: kontrol mesajları için, birden fazlası tek bulk IN transferinde gönderilir */
+#define USB_TX_QUEUE_DEPTH							8u
+#define USB_TX_MSG_MAX_LEN							48u		/* Header + en fazla 38 byte veri + checksum + footer */
 
 #define USB_INDEX_1_HEADER_1                        0
 #define USB_INDEX_2_HEADER_2                        1
@@ -136,7 +152,11 @@ typedef enum
 	USB_FIRMWARE_CMD_GO_APPLICATION		= 0x19,		// PC  - - - > MCU
 	USB_FIRMWARE_CMD_RESET_DEVICE		= 0x20,		// PC  - - - > MCU
 
-	USB_FIRMWARE_JUMPING_APPLICATION	= 0x21     // MCU - - - > PC
+	USB_FIRMWARE_JUMPING_APPLICATION	= 0x21,    // MCU - - - > PC
+
+	USB_FIRMWARE_UPDATE_PAGE_MANIFEST	= 0x22,    // PC <- - -> MCU  Aktif slot sayfa CRC32 listesi
+	USB_FIRMWARE_UPDATE_PROGRESS		= 0x23,    // MCU - - - > PC  Push modunda yazılan toplam offset
+	USB_FIRMWARE_UPDATE_STATS			= 0x24     // PC <- - -> MCU  Son transferin ölçümleri (bl_update_stats_t)
 }USBFirmwareUpdateCommandID_t;
 
 typedef enum
@@ -238,52 +258,17 @@ typedef enum
 
 //***************************TRANSMIT*******************************//
 //******************************************************************//
+/* TX kuyruğundaki çerçevelenmiş tek mesaj */
 typedef struct
 {
-    uint8_t status_code;
-}USBTxPacketStatusCode_t;
-
-
-typedef struct 
-{
-    USBPacketPacketType_t packet_type;
-    uint8_t command;
-    USBTxPacketStatusCode_t status_code;
-    uint16_t data_len;
-    uint8_t data[USB_MAX_BUFFER_LEN];
-    uint8_t checksum;
-
-}USBTxPacketInfo_t;
-
-
-typedef struct
-{
-    uint8_t usbTxBuf[USB_MAX_BUFFER_LEN];
-    uint16_t usbTxBufLen;
-    USBTxPacketInfo_t USB_Tx_packet_info;
-    
-}USBTxParameters_t;
+    uint8_t buf[USB_TX_MSG_MAX_LEN];
+    uint16_t len;
+}USBTxMessage_t;
 //******************************************************************//
 //******************************************************************//
 
 //***************************RECEIVE*******************************//
 //******************************************************************//
-typedef enum
-{
-    USB_RX_WAIT_PACKET_STATE,
-    USB_RX_HEADER_CONTROL_STATE,
-    USB_RX_PACKET_TYPE_CONTROL_STATE,
-    USB_RX_COMMAND_ID_CONTROL_STATE,
-    USB_RX_PROCESS_TYPE_CONTROL_STATE,
-    USB_RX_DATA_LENGTH_CONTROL_STATE,
-    USB_RX_DATA_CONTROL_STATE,
-    USB_RX_CHECKSUM_CONTROL_STATE,
-    USB_RX_STOP_BIT_CONTROL_STATE,
-    USB_RX_OPERATION_STATE,
-
-    USB_RX_STATE_COUNT
-} USBRxDeviceState_t;
-
 typedef enum
 {
     USB_PACKET_CORRECT                          = 0x0000,
@@ -304,28 +289,80 @@ typedef struct
     USBCommandID_t command;
     USBPacketProcessType_t process_type;
     uint16_t data_len;
-    uint8_t data[USB_MAX_BUFFER_LEN];
+    uint8_t *data;						/* usbRxBuf içindeki payload'a işaret eder */
     uint8_t checksum;
+    uint8_t command_flags;				/* Komut tablosundaki USB_RX_CMD_FLAG_* */
 
 }USBRxPacketInfo_t;
 
+/*
+ * Komut tablosu: (paket tipi, komut ID) -> geçerlilik, payload uzunluk sınırları ve
+ * frame özellikleri. Yeni komut eklemek için USB_Receive.c'deki tabloya bir satır eklenir.
+ */
+#define USB_RX_COMMAND_ID_COUNT						128u	/* Komut ID'leri 0x00..0x7F */
+#define USB_RX_DATA_LEN_MAX							(USB_MAX_BUFFER_LEN - USB_OVERHEAD_BYTES)
+#define USB_RX_CONTROL_DATA_LEN_MAX					64u		/* Kontrol komutlarının payload üst sınırı */
+
+#define USB_RX_CMD_FLAG_VALID						0x01u
+#define USB_RX_CMD_FLAG_LEAN						0x02u	/* XOR checksum yok: payload kendi CRC32'sini taşır */
+#define USB_RX_CMD_FLAG_FORWARD						0x04u	/* Frame sahipliği görünümle update engine'e geçer */
+
+typedef enum
+{
+    USB_RX_PACKET_SLOT_NONE = 0,
+    USB_RX_PACKET_SLOT_TEST,
+    USB_RX_PACKET_SLOT_CONFIG,
+    USB_RX_PACKET_SLOT_FLASH,
+    USB_RX_PACKET_SLOT_FLASH_DEBUG,
+    USB_RX_PACKET_SLOT_FIRMWARE_UPDATE,
+    USB_RX_PACKET_SLOT_COUNT
+}USBRxPacketSlot_t;
+
+typedef struct
+{
+    uint8_t 	flags;
+    uint16_t 	minDataLen;
+    uint16_t 	maxDataLen;
+}USBRxCommandEntry_t;
+
+typedef enum
+{
+    USB_RX_FRAME_FREE = 0,				/* Havuzda, ring'den frame çıkarılabilir */
+    USB_RX_FRAME_IN_USE					/* Ana döngüde (doğrulama veya update engine) */
+}USBRxFrameState_t;
+
+typedef struct
+{
+    uint8_t 			buf[USB_MAX_BUFFER_LEN];
+    uint16_t 			len;
+    volatile USBRxFrameState_t state;
+}__attribute__((aligned(USB_RX_FRAME_ALIGN))) USBRxFrame_t;
+
+/* Doğrulanmış bir frame'in kopyasız görünümü (pointer + uzunluk) */
+typedef struct
+{
+    uint8_t 						valid;
+    uint8_t 						frameIndex;
+    USBPacketPacketType_t 			packet_type;
+    USBFirmwareUpdateCommandID_t	command_id;
+    USBPacketProcessType_t 			process_type;
+    uint8_t 						*data;
+    uint16_t 						data_len;
+}USBRxFrameView_t;
+
 typedef struct
 {
-    uint8_t 			usbRxBuf[USB_MAX_BUFFER_LEN];
+    uint8_t 			*usbRxBuf;			/* Doğrulanan frame (havuzdaki buffer) */
     uint16_t 			usbRxBufLen;
-    uint8_t 			usbRxFlag;
-    USBRxDeviceState_t 	device_rx_state;
+    uint8_t 			usbRxFrameIndex;
     USBRxPacketInfo_t 	USB_rx_packet_info;
     USBPacketErrors_t   USB_packet_error;
-    uint16_t 			expectedFrameLen;   /* Header + payload + CRC + footer */
-    uint8_t  			headerLocked;       /* AA55 bulundu mu? (0/1) */
 }USBRxParameters_t;
 //******************************************************************//
 //******************************************************************//
 
 typedef struct
 {
-    USBTxParameters_t   USB_tx_parameters;
     USBRxParameters_t   USB_rx_parameters;
 }USBCommParameters_t;
 
@@ -12,25 +12,23 @@
 #include <stdint.h>
 #include "USB_General.h"
 
-#define USB_RX_DEBUG_BUF_SIZE 2048
-
 typedef struct
 {
     uint32_t rx_callback_count;      /* USB_RXCallback kaç kez çağrıldı */
-    uint32_t total_received_bytes;   /* Frame boyunca toplanan byte sayısı */
-    uint16_t expected_frame_len;     /* Hesaplanan toplam frame uzunluğu */
+    uint32_t total_received_bytes;   /* Ring'e yazılan toplam byte sayısı */
     uint16_t last_rx_len;             /* Son USB paketinin uzunluğu */
-    uint8_t  frame_in_progress;      /* 1 = header yakalandı, frame toplanıyor */
-    uint8_t  frame_completed;        /* 1 = frame tamamlandı */
-    uint8_t  data_len_zero;           /* 1 = DataLen == 0 olan frame */
-    uint8_t  overflow_error;          /* Buffer overflow oldu mu */
+    uint8_t  overflow_error;          /* Buffer overflow / geçersiz uzunluk oldu mu */
     uint8_t  footer_error;            /* Footer hatası oldu mu */
-    uint8_t  raw_bytes[USB_RX_DEBUG_BUF_SIZE];
-    uint16_t raw_len;
+    uint32_t resync_count;            /* Header aranırken atlanan byte sayısı */
+    uint32_t ring_full_count;         /* Ring dolu olduğu için endpoint'in bekletilme sayısı */
+    uint32_t pool_exhausted_count;    /* Boş frame olmadığı için ring'de bekleyen frame sayısı */
 } USB_RxDebug_t;
 
-void System_USB_Communication_Receive_Function(USBCommParameters_t *USB_Comm_ParametersLocal);
+void System_USB_Communication_Receive_Function(USBRxFrameView_t *rxFrame);
 void USB_RXCallback(uint8_t *buf, uint32_t *len);
+uint8_t *USB_Rx_Get_Rx_Buffer(uint32_t pendingLen);
+uint8_t *USB_Rx_Get_Init_Buffer(void);
+void USB_Rx_Release_Frame(USBRxFrameView_t *rxFrame);
 
 
 #endif /* LW_USB_RECEIVE_H_ */
@@ -10,455 +10,623 @@
 
 extern USBCommParameters_t USB_Comm_Parameters;
 
-void USB_Rx_Wait_Packet_Function(void);
-void USB_Rx_Header_Control_Function(void);
-void USB_Rx_Packet_Type_Control_Function(void);
-void USB_Rx_Command_ID_Control_Function(void);
-void USB_Rx_Process_Type_Control_Function(void);
-void USB_Rx_Data_Length_Control_Function(void);
-void USB_Rx_Data_Control_Function(void);
-void USB_Rx_Checksum_Control_Function(void);
-void USB_Rx_Stop_Bit_Control_Function(void);
-void USB_Rx_Operation_Function(USBCommParameters_t *USB_Comm_ParametersLocal);
+static USBPacketErrors_t USB_Rx_Decode_Frame(const uint8_t *buf, uint16_t len, uint8_t checksum, USBRxPacketInfo_t *info);
+static const USBRxCommandEntry_t *USB_Rx_Lookup_Command(uint8_t packetType, uint8_t commandId);
+static uint32_t USB_Rx_Copy_Xor(uint8_t *dst, const uint8_t *src, uint32_t len, uint32_t xorAcc);
+void USB_Rx_Operation_Function(USBRxFrameView_t *rxFrame);
 static void USB_Rx_Packet_Reset(void);
+static void USB_Rx_Packet_Detach(void);
+static uint8_t USB_Rx_Ring_Extract_Frame(uint8_t *checksum);
+static void USB_Rx_Ring_Resume(void);
 
+/* Ana döngünün ring'den çıkardığı ve yerinde doğruladığı frame havuzu */
+static USBRxFrame_t usbRxFramePool[USB_RX_FRAME_POOL_COUNT];
 
-void System_USB_Communication_Receive_Function(USBCommParameters_t *USB_Comm_ParametersLocal)
-{
-    switch (USB_Comm_Parameters.USB_rx_parameters.device_rx_state)
-    {
-    case USB_RX_WAIT_PACKET_STATE:
-        USB_Rx_Wait_Packet_Function();
-        break;
-    case USB_RX_HEADER_CONTROL_STATE:
-        USB_Rx_Header_Control_Function();
-        break;
-    case USB_RX_PACKET_TYPE_CONTROL_STATE:
-        USB_Rx_Packet_Type_Control_Function();
-        break;
-    case USB_RX_COMMAND_ID_CONTROL_STATE:
-        USB_Rx_Command_ID_Control_Function();
-        break;
-    case USB_RX_PROCESS_TYPE_CONTROL_STATE:
-        USB_Rx_Process_Type_Control_Function();
-        break;
-    case USB_RX_DATA_LENGTH_CONTROL_STATE:
-        USB_Rx_Data_Length_Control_Function();
-        break;
-    case USB_RX_DATA_CONTROL_STATE:
-        USB_Rx_Data_Control_Function();
-        break;
-    case USB_RX_CHECKSUM_CONTROL_STATE:
-        USB_Rx_Checksum_Control_Function();
-        break;
-    case USB_RX_STOP_BIT_CONTROL_STATE:
-        USB_Rx_Stop_Bit_Control_Function();
-        break;
-    case USB_RX_OPERATION_STATE:
-        USB_Rx_Operation_Function(USB_Comm_ParametersLocal);
-        break;
-
-    default:
-        break;
-    }
-}
+/*
+ * ISR -> ana döngü byte ring'i (tek üretici / tek tüketici, kilitsiz).
+ * Head'i yalnızca ISR, tail'i yalnızca ana döngü yazar; indeksler serbest sayar.
+ */
+static uint8_t usbRxRing[USB_RX_RING_SIZE] __attribute__((aligned(USB_RX_FRAME_ALIGN)));
+static volatile uint32_t usbRxRingHead 		= 0;
+static volatile uint32_t usbRxRingTail 		= 0;
+static volatile uint8_t  usbRxRingPaused 	= 0;	/* 1: ring dolu, endpoint kurulmadı */
 
-void USB_Rx_Wait_Packet_Function(void)
-{
-    if (!(USB_Comm_Parameters.USB_rx_parameters.usbRxFlag) &&
-        !(USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen))
-    {
+/*
+ * OTG HS DMA'nın yazdığı OUT buffer'ları (ping-pong). Biri ring'e aktarılırken
+ * diğeri sonraki transfer için kurulu kalır.
+ */
+static uint8_t usbRxDmaBuf[2][USB_RX_EP_PACKET_SIZE] __attribute__((aligned(USB_RX_FRAME_ALIGN)));
+static uint8_t usbRxDmaIndex = 0;
 
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-    }
-    else
-    {
-    	USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_HEADER_CONTROL_STATE;
-    }
-}
+#define USB_RX_RING_AT(idx)		(usbRxRing[(idx) & USB_RX_RING_MASK])
 
-void USB_Rx_Header_Control_Function(void)
+/* Paket tipi byte'ı -> komut tablosu satırı (0: tanımsız tip) */
+static const uint8_t usbRxPacketTypeSlot[256] =
 {
-    if(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_1_HEADER_1] != USB_PACKET_HEADER_1 && 
-       USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_2_HEADER_2] != USB_PACKET_HEADER_2)
-    {
-        USB_Rx_Packet_Reset();
-        USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_HEADER;
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-    }
-    else
-    {
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_PACKET_TYPE_CONTROL_STATE;
-    }   
-}
+	[USB_PACKET_PACKET_TYPE_TEST] 		= USB_RX_PACKET_SLOT_TEST,
+	[USB_PACKET_PACKET_TYPE_CONFIG] 	= USB_RX_PACKET_SLOT_CONFIG,
+	[USB_PACKET_PACKET_FLASH] 			= USB_RX_PACKET_SLOT_FLASH,
+	[USB_PACKET_PACKET_FLASH_DEBUG] 	= USB_RX_PACKET_SLOT_FLASH_DEBUG,
+	[USB_PACKET_FIRMWARE_UPDATE] 		= USB_RX_PACKET_SLOT_FIRMWARE_UPDATE,
+};
+
+#define USB_RX_CMD(flags, minLen, maxLen)	{ (uint8_t)(USB_RX_CMD_FLAG_VALID | (flags)), (minLen), (maxLen) }
+#define USB_RX_CMD_ANY						USB_RX_CMD(0u, 0u, USB_RX_DATA_LEN_MAX)
+#define USB_RX_CMD_CONTROL(minLen)			USB_RX_CMD(USB_RX_CMD_FLAG_FORWARD, (minLen), USB_RX_CONTROL_DATA_LEN_MAX)
 
-void USB_Rx_Packet_Type_Control_Function(void)
+/*
+ * Kabul edilen komutlar. Frame çözümü ve yönlendirme bu tablodan tek indeksle yapılır;
+ * burada olmayan (tip, komut) çifti USB_PACKET_ERROR_INVALID_*_COMMAND_ID ile reddedilir.
+ */
+static const USBRxCommandEntry_t usbRxCommandTable[USB_RX_PACKET_SLOT_COUNT][USB_RX_COMMAND_ID_COUNT] =
 {
-    
-    if(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_3_PACKET_TYPE] != USB_PACKET_PACKET_TYPE_TEST &&
-       USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_3_PACKET_TYPE] != USB_PACKET_PACKET_TYPE_CONFIG &&
-	   USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_3_PACKET_TYPE] != USB_PACKET_PACKET_FLASH &&
-	   USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_3_PACKET_TYPE] != USB_PACKET_FIRMWARE_UPDATE &&
-	   USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_3_PACKET_TYPE] != USB_PACKET_PACKET_FLASH_DEBUG)
-    {
-        USB_Rx_Packet_Reset();
-        USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_PACKET_TYPE;
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-    }
-    else
-    {
-        USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_3_PACKET_TYPE];
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_COMMAND_ID_CONTROL_STATE;
-    }
+	[USB_RX_PACKET_SLOT_TEST] =
+	{
+		[USB_TEST_COMMAND_ID_LSM6DSOX] 						= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_ADS1192] 						= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_AT24C32] 						= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_MAX17303] 						= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BLE] 							= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_LED] 							= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_VIBRATION] 					= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_AVG_VCELL_MV] 			= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_AVG_CURRENT_MA] 		= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_TEMP_C] 				= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_SOC_PERCENT] 			= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_REP_CAPACITY_MAH] 		= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_FULL_CAPACITY_MAH] 	= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_TTE_MINUTES] 			= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_TTF_MINUTES] 			= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_CYCLE_COUNT] 			= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_BATTERY_SOH_PERCENT] 			= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_FLASH_CLEAR] 					= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_ECG_STREAM] 					= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_FLASH_TEST] 					= USB_RX_CMD_ANY,
+		[USB_TEST_COMMAND_ID_SOFTWARE_RESET] 				= USB_RX_CMD_ANY,
+	},
+
+	[USB_RX_PACKET_SLOT_CONFIG] =
+	{
+		[USB_COMMAND_ID_RTC] 								= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_FIRMWARE_VERSION] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_HARDWARE_VERSION] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_NAME] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_NUMBER] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_SERIAL_NUMBER] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_MANUFACTORING_DATE] 				= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BATCH_NUMBER] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_LAST_SERVICE_DATE] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_PATIENT_NAME] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BATTERY_DESIGN_CAPACITY_MAH] 		= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BATTERY_RSENSE_MOHM] 				= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_TYPE] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BLE_BAUDRATE] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BLE_NAME] 							= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BLE_PHY_MODE] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BLE_SERIAL_NUMBER] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_BLE_INDICATOR] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_SAMPLING_FREQUENCY] 			= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_HPF_CUTOFF_FREQUENCY] 				= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_LPF_CUTOFF_FREQUENCY] 				= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_NOTCH_FREQUENCY] 			= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_NOTCH_Q_VALUE] 				= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_CHANGE_BAUDRATE] 			= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_DEVICE_UPDATE_REQUEST] 				= USB_RX_CMD_ANY,
+	},
+
+	[USB_RX_PACKET_SLOT_FLASH] =
+	{
+		[USB_COMMAND_ID_LIST_RECORD_COUNT_AND_PAGE] 		= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_REQUEST] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_FEEDBACK] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_FINISH] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_RECOVER] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_CANCEL] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_FLASH_HEALTH_CONTROL] 				= USB_RX_CMD_ANY,
+	},
+
+	[USB_RX_PACKET_SLOT_FLASH_DEBUG] =
+	{
+		[USB_COMMAND_ID_LIST_RECORD_COUNT_AND_PAGE] 		= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_REQUEST] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_FEEDBACK] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_FINISH] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_RECOVER] 					= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_RECORD_CANCEL] 						= USB_RX_CMD_ANY,
+		[USB_COMMAND_ID_FLASH_HEALTH_CONTROL] 				= USB_RX_CMD_ANY,
+	},
+
+	[USB_RX_PACKET_SLOT_FIRMWARE_UPDATE] =
+	{
+		[USB_FIRMWARE_UPDATE_STATUS_REQ] 					= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_UPDATE_READY] 						= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_UPDATE_PACKET_INFO] 					= USB_RX_CMD_CONTROL(13u),	/* size, crc, format, version, pencere */
+		[USB_FIRMWARE_UPDATE_SEND_PACKET] 					= USB_RX_CMD(USB_RX_CMD_FLAG_FORWARD | USB_RX_CMD_FLAG_LEAN,
+																		 12u, USB_RX_DATA_LEN_MAX),	/* addr, len, CRC32 */
+		[USB_FIRMWARE_FLASH_ERASE] 							= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_CMD_EXIT_BOOTLOADER] 					= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_CMD_SHUTDOWN_DEVICE] 					= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_CMD_GO_APPLICATION] 					= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_CMD_RESET_DEVICE] 					= USB_RX_CMD_CONTROL(0u),
+		[USB_FIRMWARE_UPDATE_PAGE_MANIFEST] 				= USB_RX_CMD_CONTROL(3u),	/* ilk sayfa, adet */
+		[USB_FIRMWARE_UPDATE_STATS] 						= USB_RX_CMD_CONTROL(0u),
+	},
+};
+
+
+void System_USB_Communication_Receive_Function(USBRxFrameView_t *rxFrame)
+{
+	USBPacketErrors_t 	error;
+	uint8_t 			checksum;
+
+	USB_Rx_Ring_Resume();
+
+	if (USB_Rx_Ring_Extract_Frame(&checksum) == 0)
+	{
+		return;
+	}
+
+	/* Frame tek çağrıda çözülür, geçerliyse aynı turda ilgili tarafa verilir */
+	error = USB_Rx_Decode_Frame(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf,
+								USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen,
+								checksum,
+								&USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info);
+
+	if (error != USB_PACKET_CORRECT)
+	{
+		USB_Rx_Packet_Reset();
+		USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= error;
+		return;
+	}
+
+	USB_Rx_Operation_Function(rxFrame);
 }
 
-void USB_Rx_Command_ID_Control_Function(void)
+/*
+ * Header, paket tipi, komut, işlem tipi, uzunluk, checksum ve footer'ı tek
+ * geçişte doğrular; geçerliyse info'yu doldurur. Payload kopyalanmaz, info->data
+ * frame buffer içindeki yerine işaret eder.
+ *
+ * checksum: USB_Rx_Ring_Extract_Frame'in kopyalarken hesapladığı değer
+ */
+static USBPacketErrors_t USB_Rx_Decode_Frame(const uint8_t *buf, uint16_t len, uint8_t checksum, USBRxPacketInfo_t *info)
 {
-    switch (USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type)
-    {
-    case USB_PACKET_PACKET_TYPE_TEST:
-        switch (USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID])
-        {
-            case USB_TEST_COMMAND_ID_LSM6DSOX:
-            case USB_TEST_COMMAND_ID_ADS1192:
-            case USB_TEST_COMMAND_ID_AT24C32:
-            case USB_TEST_COMMAND_ID_MAX17303:
-            case USB_TEST_COMMAND_ID_BLE:
-            case USB_TEST_COMMAND_ID_LED:
-            case USB_TEST_COMMAND_ID_VIBRATION:
-            case USB_TEST_COMMAND_ID_BATTERY_AVG_VCELL_MV:
-            case USB_TEST_COMMAND_ID_BATTERY_AVG_CURRENT_MA:
-            case USB_TEST_COMMAND_ID_BATTERY_TEMP_C:
-            case USB_TEST_COMMAND_ID_BATTERY_SOC_PERCENT:
-            case USB_TEST_COMMAND_ID_BATTERY_REP_CAPACITY_MAH:
-            case USB_TEST_COMMAND_ID_BATTERY_FULL_CAPACITY_MAH:
-            case USB_TEST_COMMAND_ID_BATTERY_TTE_MINUTES:
-            case USB_TEST_COMMAND_ID_BATTERY_TTF_MINUTES:
-            case USB_TEST_COMMAND_ID_BATTERY_CYCLE_COUNT:
-            case USB_TEST_COMMAND_ID_BATTERY_SOH_PERCENT:
-            case USB_TEST_COMMAND_ID_FLASH_CLEAR:
-            case USB_TEST_COMMAND_ID_ECG_STREAM:
-            case USB_TEST_COMMAND_ID_FLASH_TEST:
-            case USB_TEST_COMMAND_ID_SOFTWARE_RESET:
-
-
-            	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.command.USB_test_command_id = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID];
-                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_PROCESS_TYPE_CONTROL_STATE;
-            break;
-        
-            default:
-                USB_Rx_Packet_Reset();
-                USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_INVALID_TEST_COMMAND_ID;
-                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-            break;
-        }
-    break;
-
-    case USB_PACKET_PACKET_TYPE_CONFIG:
-        switch (USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID])
-        {
-            case USB_COMMAND_ID_RTC:
-            case USB_COMMAND_ID_FIRMWARE_VERSION:
-            case USB_COMMAND_ID_HARDWARE_VERSION:
-            case USB_COMMAND_ID_DEVICE_NAME:
-            case USB_COMMAND_ID_DEVICE_NUMBER:
-            case USB_COMMAND_ID_SERIAL_NUMBER:
-            case USB_COMMAND_ID_MANUFACTORING_DATE:
-            case USB_COMMAND_ID_BATCH_NUMBER:
-            case USB_COMMAND_ID_LAST_SERVICE_DATE:
-            case USB_COMMAND_ID_PATIENT_NAME:
-            case USB_COMMAND_ID_BATTERY_DESIGN_CAPACITY_MAH:
-            case USB_COMMAND_ID_BATTERY_RSENSE_MOHM:
-            case USB_COMMAND_ID_DEVICE_TYPE:
-            case USB_COMMAND_ID_BLE_BAUDRATE:
-            case USB_COMMAND_ID_BLE_NAME:
-            case USB_COMMAND_ID_BLE_PHY_MODE:
-            case USB_COMMAND_ID_BLE_SERIAL_NUMBER:
-            case USB_COMMAND_ID_BLE_INDICATOR:
-            case USB_COMMAND_ID_DEVICE_SAMPLING_FREQUENCY:
-            case USB_COMMAND_ID_HPF_CUTOFF_FREQUENCY:
-            case USB_COMMAND_ID_LPF_CUTOFF_FREQUENCY:
-            case USB_COMMAND_ID_DEVICE_NOTCH_FREQUENCY:
-            case USB_COMMAND_ID_DEVICE_NOTCH_Q_VALUE:
-            case USB_COMMAND_ID_DEVICE_CHANGE_BAUDRATE:
-            case USB_COMMAND_ID_DEVICE_UPDATE_REQUEST:
-
-            	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.command.USB_config_command_id = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID];
-                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_PROCESS_TYPE_CONTROL_STATE;
-
-            break;
-
-            default:
-
-                USB_Rx_Packet_Reset();
-                USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_INVALID_CONFIG_COMMAND_ID;
-                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-
-            break;
-        }
-    break;
-    case USB_PACKET_PACKET_FLASH:
-    case USB_PACKET_PACKET_FLASH_DEBUG:
-        switch (USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID])
-        {
-            case USB_COMMAND_ID_LIST_RECORD_COUNT_AND_PAGE:
-            case USB_COMMAND_ID_RECORD_REQUEST:
-            case USB_COMMAND_ID_RECORD_FEEDBACK:
-            case USB_COMMAND_ID_RECORD_FINISH:
-            case USB_COMMAND_ID_RECORD_RECOVER:
-            case USB_COMMAND_ID_RECORD_CANCEL:
-            case USB_COMMAND_ID_FLASH_HEALTH_CONTROL:
-
-            	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.command.USB_flash_command_id = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID];
-                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_PROCESS_TYPE_CONTROL_STATE;
-            break;
-
-            default:
-                USB_Rx_Packet_Reset();
-                USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_INVALID_CONFIG_COMMAND_ID;
-                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-            break;
-        }
-
-        case USB_PACKET_FIRMWARE_UPDATE:
-        	switch (USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID])
-        	{
-        		case USB_FIRMWARE_UPDATE_STATUS_REQ:
-				case USB_FIRMWARE_UPDATE_READY:
-				case USB_FIRMWARE_UPDATE_PACKET_INFO:
-				case USB_FIRMWARE_UPDATE_SEND_PACKET:
-				case USB_FIRMWARE_FLASH_ERASE:
-				case USB_FIRMWARE_CMD_EXIT_BOOTLOADER:
-				case USB_FIRMWARE_CMD_SHUTDOWN_DEVICE:
-				case USB_FIRMWARE_CMD_GO_APPLICATION:
-				case USB_FIRMWARE_CMD_RESET_DEVICE:
-
-	            	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_4_COMMAND_ID];
-	                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_PROCESS_TYPE_CONTROL_STATE;
-
-					break;
-				default:
-
-	                USB_Rx_Packet_Reset();
-	                USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_INVALID_CONFIG_COMMAND_ID;
-	                USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-
-					break;
-        	}
-        	break;
-    default:
-        break;
-    }
+	const USBRxCommandEntry_t 	*entry;
+	USBPacketPacketType_t 		packetType;
+	uint8_t 					commandId;
+	uint16_t 					dataLen;
+
+	if (len < USB_OVERHEAD_BYTES)
+	{
+		return USB_PACKET_ERROR_INVALID_DATA_LEN;
+	}
+
+	if ((buf[USB_INDEX_1_HEADER_1] != USB_PACKET_HEADER_1) ||
+		(buf[USB_INDEX_2_HEADER_2] != USB_PACKET_HEADER_2))
+	{
+		return USB_PACKET_ERROR_HEADER;
+	}
+
+	packetType 	= (USBPacketPacketType_t)buf[USB_INDEX_3_PACKET_TYPE];
+	commandId 	= buf[USB_INDEX_4_COMMAND_ID];
+
+	if (usbRxPacketTypeSlot[packetType] == USB_RX_PACKET_SLOT_NONE)
+	{
+		return USB_PACKET_ERROR_PACKET_TYPE;
+	}
+
+	entry = USB_Rx_Lookup_Command(packetType, commandId);
+
+	if (entry == NULL)
+	{
+		return (packetType == USB_PACKET_PACKET_TYPE_TEST) ? USB_PACKET_ERROR_INVALID_TEST_COMMAND_ID :
+															 USB_PACKET_ERROR_INVALID_CONFIG_COMMAND_ID;
+	}
+
+	if ((buf[USB_INDEX_5_PROCESS_TYPE] != USB_PACKET_PROCESS_TYPE_READ) &&
+		(buf[USB_INDEX_5_PROCESS_TYPE] != USB_PACKET_PROCESS_TYPE_WRITE))
+	{
+		return USB_PACKET_ERROR_INVALID_PROCESS_TYPE;
+	}
+
+	dataLen = (uint16_t)(buf[USB_INDEX_6_DATA_LEN_MSB] << 8) | buf[USB_INDEX_7_DATA_LEN_LSB];
+
+	/* Payload frame'in içinde kalmalı: sonraki katmanlar buffer'a doğrudan erişir */
+	if (((uint32_t)dataLen + USB_OVERHEAD_BYTES) != len)
+	{
+		return USB_PACKET_ERROR_INVALID_DATA_LEN;
+	}
+
+	if ((dataLen < entry->minDataLen) || (dataLen > entry->maxDataLen))
+	{
+		return USB_PACKET_ERROR_INVALID_DATA_LEN;
+	}
+
+	/*
+	 * Lean frame'lerde (firmware veri blokları) checksum alanı kontrol edilmez: payload
+	 * kendi CRC32'sini taşır ve USB bulk transferi link katmanında CRC16 ile korunur
+	 */
+	if (((entry->flags & USB_RX_CMD_FLAG_LEAN) == 0u) &&
+		(buf[USB_INDEX_DATA_START + dataLen] != checksum))
+	{
+		return USB_PACKET_ERROR_CHECKSUM;
+	}
+
+	if ((buf[USB_INDEX_DATA_START + dataLen + 1u] != USB_PACKET_FOOTER_1) ||
+		(buf[USB_INDEX_DATA_START + dataLen + 2u] != USB_PACKET_FOOTER_2))
+	{
+		return USB_PACKET_ERROR_FOOTER;
+	}
+
+	info->packet_type 	= packetType;
+	info->process_type 	= (USBPacketProcessType_t)buf[USB_INDEX_5_PROCESS_TYPE];
+	info->data_len 		= dataLen;
+	info->data 			= (uint8_t *)&buf[USB_INDEX_DATA_START];
+	info->checksum 		= checksum;
+	info->command_flags = entry->flags;
+
+	switch (packetType)
+	{
+		case USB_PACKET_PACKET_TYPE_TEST:
+			info->command.USB_test_command_id 				= (USBTestCommandID_t)commandId;
+			break;
+		case USB_PACKET_PACKET_TYPE_CONFIG:
+			info->command.USB_config_command_id 			= (USBConfigCommandID_t)commandId;
+			break;
+		case USB_PACKET_PACKET_FLASH:
+		case USB_PACKET_PACKET_FLASH_DEBUG:
+			info->command.USB_flash_command_id 				= (USBRecordCommandID_t)commandId;
+			break;
+		default:
+			info->command.USB_firmware_update_command_id 	= (USBFirmwareUpdateCommandID_t)commandId;
+			break;
+	}
+
+	return USB_PACKET_CORRECT;
 }
 
-void USB_Rx_Process_Type_Control_Function(void)
+/*
+ * Tek indeksli erişimle komut tablosu girdisi; tanımsız tip / komut için NULL
+ */
+static const USBRxCommandEntry_t *USB_Rx_Lookup_Command(uint8_t packetType, uint8_t commandId)
 {
-    if(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_5_PROCESS_TYPE] != USB_PACKET_PROCESS_TYPE_READ &&
-        USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_5_PROCESS_TYPE] != USB_PACKET_PROCESS_TYPE_WRITE)
-    {
-            USB_Rx_Packet_Reset();
-            USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_INVALID_PROCESS_TYPE;
-            USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-    }
-    else
-    {
-    	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.process_type = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_5_PROCESS_TYPE];
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_DATA_LENGTH_CONTROL_STATE;
-    }
+	const USBRxCommandEntry_t *entry;
+
+	if (commandId >= USB_RX_COMMAND_ID_COUNT)
+	{
+		return NULL;
+	}
+
+	entry = &usbRxCommandTable[usbRxPacketTypeSlot[packetType]][commandId];
+
+	return ((entry->flags & USB_RX_CMD_FLAG_VALID) != 0u) ? entry : NULL;
 }
 
-void USB_Rx_Data_Length_Control_Function(void)
+void USB_Rx_Operation_Function(USBRxFrameView_t *rxFrame)
 {
-    if(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_6_DATA_LEN_MSB] == 0 && USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_7_DATA_LEN_LSB] == 0)
+    /* Bootloader'da yalnızca update engine'e yönlendirilen komutlar işlenir, diğerleri düşürülür */
+    if ((USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.command_flags & USB_RX_CMD_FLAG_FORWARD) == 0u)
     {
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_CHECKSUM_CONTROL_STATE;
+        USB_Rx_Packet_Reset();
     }
     else
     {
-    	if((USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_6_DATA_LEN_MSB] + 9) > USB_MAX_BUFFER_LEN)
+    	/*
+    	 * Frame'in sahipliği görünüm ile birlikte çağırana geçer.
+    	 * Çağıran işi bitince USB_Rx_Release_Frame() ile havuza geri verir.
+    	 */
+    	if (rxFrame->valid)
     	{
-            USB_Rx_Packet_Reset();
-            USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_INVALID_DATA_LEN;
-            USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
+    		USB_Rx_Release_Frame(rxFrame);
     	}
-    	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len = (uint16_t)(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_6_DATA_LEN_MSB] << 8) | USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_7_DATA_LEN_LSB];
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_DATA_CONTROL_STATE;
+
+    	rxFrame->valid 			= 1;
+    	rxFrame->frameIndex 	= USB_Comm_Parameters.USB_rx_parameters.usbRxFrameIndex;
+    	rxFrame->packet_type 	= USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type;
+    	rxFrame->command_id 	= USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.command.USB_firmware_update_command_id;
+    	rxFrame->process_type 	= USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.process_type;
+    	rxFrame->data 			= USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data;
+    	rxFrame->data_len 		= USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len;
+
+    	USB_Rx_Packet_Detach();
     }
 }
 
-void USB_Rx_Data_Control_Function(void)
+void USB_Rx_Release_Frame(USBRxFrameView_t *rxFrame)
 {
-    for(uint16_t i = 0; i < USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len; i++)
-    {
-    	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data[i] = USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_DATA_START + i];
-    }
+	if ((rxFrame == NULL) || (rxFrame->valid == 0) || (rxFrame->frameIndex >= USB_RX_FRAME_POOL_COUNT))
+	{
+		return;
+	}
+
+	usbRxFramePool[rxFrame->frameIndex].len 	= 0;
+	usbRxFramePool[rxFrame->frameIndex].state 	= USB_RX_FRAME_FREE;
 
-    USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_CHECKSUM_CONTROL_STATE;
+	memset(rxFrame, 0, sizeof(USBRxFrameView_t));
 }
 
-void USB_Rx_Checksum_Control_Function(void)
+/*
+ * Doğrulama durumunu temizler, frame'i havuza geri vermez (sahiplik görünüme geçti)
+ */
+static void USB_Rx_Packet_Detach(void)
 {
-    for(uint16_t i = USB_INDEX_3_PACKET_TYPE; i < (USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len + USB_INDEX_DATA_START); i++)
-    {
-    	USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.checksum = USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.checksum ^ USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[i];
-    }
-
-    if(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[USB_INDEX_DATA_START + USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len] != USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.checksum)
-    {
-        USB_Rx_Packet_Reset();
-        USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_CHECKSUM;
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-    }
-    else
-    {
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_STOP_BIT_CONTROL_STATE;
-    }
+    memset(&USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info, 0 , sizeof(USBRxPacketInfo_t));
+    USB_Comm_Parameters.USB_rx_parameters.usbRxBuf = NULL;
+    USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen = 0;
 }
 
-void USB_Rx_Stop_Bit_Control_Function(void)
+static void USB_Rx_Packet_Reset(void)
 {
-    if(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[6 + USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len + 2] != USB_PACKET_FOOTER_1 &&
-       USB_Comm_Parameters.USB_rx_parameters.usbRxBuf[6 + USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.data_len + 3] != USB_PACKET_FOOTER_2)
-    {
-        USB_Rx_Packet_Reset();
-        USB_Comm_Parameters.USB_rx_parameters.USB_packet_error |= USB_PACKET_ERROR_FOOTER;
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
-    }
-    else
-    {
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_OPERATION_STATE;
-    }
+	if (USB_Comm_Parameters.USB_rx_parameters.usbRxBuf != NULL)
+	{
+		uint8_t frameIndex = USB_Comm_Parameters.USB_rx_parameters.usbRxFrameIndex;
+
+		usbRxFramePool[frameIndex].len 		= 0;
+		usbRxFramePool[frameIndex].state 	= USB_RX_FRAME_FREE;
+	}
+
+	USB_Rx_Packet_Detach();
 }
 
-void USB_Rx_Operation_Function(USBCommParameters_t *USB_Comm_ParametersLocal)
+volatile USB_RxDebug_t g_usb_rx_debug = {0};
+
+/*
+ * Ring'deki bir sonraki tam frame'i havuzdaki boş bir frame'e çıkarır.
+ * Header'a kadar olan byte'lar atlanır; footer tutmazsa tek byte ilerleyip
+ * yeniden senkronize olunur. Eksik frame ring'de bekler.
+ * Kopyalama sırasında frame'in checksum'ı da aynı döngüde hesaplanır.
+ *
+ * return 1: frame USB_rx_parameters'a yüklendi, 0: işlenecek frame yok
+ */
+static uint8_t USB_Rx_Ring_Extract_Frame(uint8_t *checksum)
 {
-    if(USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_PACKET_TYPE_TEST)
-    {
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
+	uint32_t 		tail 	= usbRxRingTail;
+	uint32_t 		avail 	= usbRxRingHead - tail;
+	uint32_t 		frameLen;
+	uint32_t 		offset;
+	uint32_t 		first;
+	uint32_t 		xorAcc;
+	USBRxFrame_t 	*frame 	= NULL;
+	uint8_t 		frameIndex;
+	const USBRxCommandEntry_t *leanEntry;
+
+	/* Head okunduktan sonra veri okunmalı */
+	__DMB();
+
+	while (avail >= 2u)
+	{
+		if ((USB_RX_RING_AT(tail) == USB_PACKET_HEADER_1) && (USB_RX_RING_AT(tail + 1u) == USB_PACKET_HEADER_2))
+		{
+			break;
+		}
 
-        USB_Rx_Packet_Reset();
-    }
-    else if(USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_PACKET_TYPE_CONFIG)
-    {
-    	USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
+		tail 	+= 1u;
+		avail 	-= 1u;
+		g_usb_rx_debug.resync_count += 1;
+	}
 
-    	USB_Rx_Packet_Reset();
-    }
-    else if(USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_PACKET_FLASH)
-    {
-    	USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
+	usbRxRingTail = tail;
 
-    	USB_Rx_Packet_Reset();
-    }
-    else if(USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_PACKET_FLASH_DEBUG)
-    {
-        USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
+	if (avail < USB_INDEX_DATA_START)
+	{
+		return 0;
+	}
 
-    	USB_Rx_Packet_Reset();        
-    }
-    else if(USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info.packet_type == USB_PACKET_FIRMWARE_UPDATE)
-    {
-    	memcpy((void *)USB_Comm_ParametersLocal, (const void *)&USB_Comm_Parameters, sizeof(USB_Comm_Parameters));
+	frameLen = (((uint32_t)USB_RX_RING_AT(tail + USB_INDEX_6_DATA_LEN_MSB) << 8) |
+				 (uint32_t)USB_RX_RING_AT(tail + USB_INDEX_7_DATA_LEN_LSB)) + USB_OVERHEAD_BYTES;
 
-    	USB_Comm_Parameters.USB_rx_parameters.device_rx_state = USB_RX_WAIT_PACKET_STATE;
+	if (frameLen > USB_MAX_BUFFER_LEN)
+	{
+		/* Geçersiz uzunluk: sahte header, bir byte ileriden aramaya devam */
+		g_usb_rx_debug.overflow_error 	= 1;
+		usbRxRingTail 					= tail + 1u;
+		return 0;
+	}
 
-    	USB_Rx_Packet_Reset();
-    }
-}
+	if (avail < frameLen)
+	{
+		return 0;
+	}
 
+	if ((USB_RX_RING_AT(tail + frameLen - 2u) != USB_PACKET_FOOTER_1) ||
+		(USB_RX_RING_AT(tail + frameLen - 1u) != USB_PACKET_FOOTER_2))
+	{
+		g_usb_rx_debug.footer_error = 1;
+		usbRxRingTail 				= tail + 1u;
+		return 0;
+	}
 
-static void USB_Rx_Packet_Reset(void)
-{
-    memset(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf, 0 , sizeof(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf));
-    memset(&USB_Comm_Parameters.USB_rx_parameters.USB_rx_packet_info, 0 , sizeof(USBRxPacketInfo_t));
-    USB_Comm_Parameters.USB_rx_parameters.usbRxFlag = 0;
-    USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen = 0;
+	for (frameIndex = 0; frameIndex < USB_RX_FRAME_POOL_COUNT; frameIndex++)
+	{
+		if (usbRxFramePool[frameIndex].state == USB_RX_FRAME_FREE)
+		{
+			frame = &usbRxFramePool[frameIndex];
+			break;
+		}
+	}
+
+	if (frame == NULL)
+	{
+		/* Havuz dolu: frame ring'de kalır, update engine frame bıraktıkça alınır */
+		g_usb_rx_debug.pool_exhausted_count += 1;
+		return 0;
+	}
+
+	offset 	= tail & USB_RX_RING_MASK;
+	first 	= USB_RX_RING_SIZE - offset;
+
+	leanEntry = USB_Rx_Lookup_Command(USB_RX_RING_AT(tail + USB_INDEX_3_PACKET_TYPE),
+									  USB_RX_RING_AT(tail + USB_INDEX_4_COMMAND_ID));
+
+	if ((leanEntry != NULL) && ((leanEntry->flags & USB_RX_CMD_FLAG_LEAN) != 0u))
+	{
+		/* Lean frame: checksum hesaplanmaz, düz kopya */
+		if (first >= frameLen)
+		{
+			memcpy(frame->buf, &usbRxRing[offset], frameLen);
+		}
+		else
+		{
+			memcpy(frame->buf, &usbRxRing[offset], first);
+			memcpy(&frame->buf[first], usbRxRing, frameLen - first);
+		}
+
+		*checksum = 0;
+	}
+	else
+	{
+		if (first >= frameLen)
+		{
+			xorAcc = USB_Rx_Copy_Xor(frame->buf, &usbRxRing[offset], frameLen, 0);
+		}
+		else
+		{
+			xorAcc = USB_Rx_Copy_Xor(frame->buf, &usbRxRing[offset], first, 0);
+			xorAcc = USB_Rx_Copy_Xor(&frame->buf[first], usbRxRing, frameLen - first, xorAcc);
+		}
+
+		/*
+		 * Tüm frame'in XOR'u alındı; checksum alanı (paket tipi .. data sonu) dışında
+		 * kalan header, checksum ve footer byte'ları tekrar XOR'lanarak çıkarılır.
+		 */
+		xorAcc ^= xorAcc >> 16;
+		xorAcc ^= xorAcc >> 8;
+
+		*checksum = (uint8_t)xorAcc ^ frame->buf[USB_INDEX_1_HEADER_1] ^ frame->buf[USB_INDEX_2_HEADER_2] ^
+					frame->buf[frameLen - 3u] ^ frame->buf[frameLen - 2u] ^ frame->buf[frameLen - 1u];
+	}
+
+	frame->len 		= (uint16_t)frameLen;
+	frame->state 	= USB_RX_FRAME_IN_USE;
+
+	/* Veri okunduktan sonra alan ISR'a geri verilir */
+	__DMB();
+	usbRxRingTail = tail + frameLen;
+
+	USB_Comm_Parameters.USB_rx_parameters.usbRxBuf 			= frame->buf;
+	USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen 		= frame->len;
+	USB_Comm_Parameters.USB_rx_parameters.usbRxFrameIndex 	= frameIndex;
+
+	return 1;
 }
 
-static int32_t find_header_index(const uint8_t *buf, uint32_t len)
+/*
+ * len byte'ı kopyalar ve kopyalanan byte'ları 32-bit gruplar halinde xorAcc'a
+ * XOR'lar. Dönen değerin byte'ları birbiriyle XOR'lanınca byte bazlı XOR elde edilir.
+ */
+static uint32_t USB_Rx_Copy_Xor(uint8_t *dst, const uint8_t *src, uint32_t len, uint32_t xorAcc)
 {
-    if (len < 2u) return -1;
+	uint32_t word;
+	uint32_t i = 0;
 
-    for (uint32_t i = 0; i < (len - 1u); i++)
-    {
-        if ((buf[i] == USB_PACKET_HEADER_1) && (buf[i + 1u] == USB_PACKET_HEADER_2))
-        {
-            return (int32_t)i;
-        }
-    }
-    return -1;
+	for (; (i + 4u) <= len; i += 4u)
+	{
+		memcpy(&word, &src[i], sizeof(word));
+		memcpy(&dst[i], &word, sizeof(word));
+		xorAcc ^= word;
+	}
+
+	for (; i < len; i++)
+	{
+		dst[i] 	= src[i];
+		xorAcc ^= src[i];
+	}
+
+	return xorAcc;
 }
 
-volatile USB_RxDebug_t g_usb_rx_debug = {0};
+/*
+ * Ring dolduğu için durdurulan endpoint'i, yeterli alan açıldıysa yeniden kurar
+ */
+static void USB_Rx_Ring_Resume(void)
+{
+	uint8_t *next;
 
+	if (usbRxRingPaused == 0)
+	{
+		return;
+	}
+
+	next = USB_Rx_Get_Rx_Buffer(0);
 
+	if (next != NULL)
+	{
+		usbRxRingPaused = 0;
+		CDC_Resume_Receive_HS(next);
+	}
+}
+
+/*
+ * ISR bağlamında çalışır: yalnızca ring'e ekler, frame ayrıştırmaz.
+ * Süre transfer boyutuyla (en fazla USB_RX_EP_PACKET_SIZE) sınırlıdır.
+ */
 void USB_RXCallback(uint8_t *buf, uint32_t *len)
 {
-	/*
-	 * ESKİ HALİ
-	 */
-	/*
-    memcpy(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf, buf, *len);
-    USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen = *len;
-    USB_Comm_Parameters.USB_rx_parameters.usbRxFlag = 1;
-    */
-	uint32_t rxLen 	= *len;
-	static uint16_t msgLen = 0;
+	uint32_t head;
+	uint32_t offset;
+	uint32_t rxLen;
+	uint32_t first;
 
 	if((buf == NULL) || len == NULL)
 		return;
 
+	rxLen 	= *len;
+	head 	= usbRxRingHead;
+	offset 	= head & USB_RX_RING_MASK;
+
 	g_usb_rx_debug.rx_callback_count += 1;
 	g_usb_rx_debug.last_rx_len		  = rxLen;
 
-	memcpy(&g_usb_rx_debug.raw_bytes[g_usb_rx_debug.expected_frame_len], buf, rxLen);
-	g_usb_rx_debug.expected_frame_len += g_usb_rx_debug.last_rx_len;
-
-	if(g_usb_rx_debug.frame_in_progress == 0)
+	/* Endpoint yalnızca yer varken kurulur; bu kontrol yalnızca güvenlik içindir */
+	if (rxLen > (USB_RX_RING_SIZE - (head - usbRxRingTail)))
 	{
-		if(find_header_index(g_usb_rx_debug.raw_bytes, rxLen) != -1)
-		{
-			// Header'lı veri
-			g_usb_rx_debug.frame_in_progress = 1;
-
-			msgLen = (g_usb_rx_debug.raw_bytes[5] << 8) | (g_usb_rx_debug.raw_bytes[6]);
-		}
+		g_usb_rx_debug.overflow_error = 1;
+		return;
 	}
 
-	if((msgLen + 10) == g_usb_rx_debug.expected_frame_len)
+	first = USB_RX_RING_SIZE - offset;
+
+	if (first >= rxLen)
 	{
-		// Verinin tamamı gelmiştir işlenebilir.
-		g_usb_rx_debug.total_received_bytes = g_usb_rx_debug.expected_frame_len;
-		g_usb_rx_debug.frame_in_progress 	= 0;
-		g_usb_rx_debug.frame_completed 	 	= 1;
+		memcpy(&usbRxRing[offset], buf, rxLen);
 	}
-	else if((msgLen + 10) < g_usb_rx_debug.expected_frame_len)
+	else
 	{
-		g_usb_rx_debug.frame_completed 		= 0;
-		g_usb_rx_debug.rx_callback_count 	= 0;
-		g_usb_rx_debug.expected_frame_len 	= 0;
-		g_usb_rx_debug.frame_in_progress    = 0;
-		g_usb_rx_debug.last_rx_len			= 0;
+		memcpy(&usbRxRing[offset], buf, first);
+		memcpy(usbRxRing, &buf[first], rxLen - first);
 	}
 
-	if(g_usb_rx_debug.frame_completed)
-	{
-		memcpy(USB_Comm_Parameters.USB_rx_parameters.usbRxBuf,
-			   g_usb_rx_debug.raw_bytes,
-			   g_usb_rx_debug.total_received_bytes);
-
-	    USB_Comm_Parameters.USB_rx_parameters.usbRxBufLen 	= g_usb_rx_debug.total_received_bytes;
-	    USB_Comm_Parameters.USB_rx_parameters.usbRxFlag 	= 1;
+	/* Veri yazıldıktan sonra head ilerletilir */
+	__DMB();
+	usbRxRingHead = head + rxLen;
 
-		g_usb_rx_debug.frame_completed 		= 0;
-		g_usb_rx_debug.rx_callback_count 	= 0;
-		g_usb_rx_debug.expected_frame_len 	= 0;
-		g_usb_rx_debug.frame_in_progress    = 0;
-	}
+	g_usb_rx_debug.total_received_bytes += rxLen;
 }
 
+/*
+ * Sonraki OUT transferi için boştaki ping-pong buffer'ı. pendingLen, henüz ring'e
+ * aktarılmamış (az önce gelen) byte sayısıdır. Ring'de bunun yanında bir
+ * transferlik daha yer yoksa NULL döner: endpoint kurulmaz, host NAK alır ve veri
+ * kaybolmaz. Ana döngü alan açtıkça USB_Rx_Ring_Resume() ile alım devam eder.
+ */
+uint8_t *USB_Rx_Get_Rx_Buffer(uint32_t pendingLen)
+{
+	if ((USB_RX_RING_SIZE - (usbRxRingHead - usbRxRingTail)) < (pendingLen + USB_RX_EP_PACKET_SIZE))
+	{
+		usbRxRingPaused = 1;
+		g_usb_rx_debug.ring_full_count += 1;
+		return NULL;
+	}
 
+	usbRxDmaIndex ^= 1u;
 
+	return usbRxDmaBuf[usbRxDmaIndex];
+}
 
-
-
+/*
+ * USB yapılandırıldığında ilk transferin kurulacağı buffer
+ */
+uint8_t *USB_Rx_Get_Init_Buffer(void)
+{
+	return usbRxDmaBuf[usbRxDmaIndex];
+}
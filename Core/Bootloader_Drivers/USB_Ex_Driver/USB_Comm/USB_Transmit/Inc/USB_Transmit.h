@@ -15,8 +15,9 @@
 #include "usbd_cdc_if.h"
 
 
-uint8_t USB_Transmit(uint8_t* Buf, uint16_t len);
-USBTxParameters_t* USB_Prepare_Transmit_Buffer(uint8_t packet_type, uint8_t command, uint8_t status_code, uint16_t data_len, uint8_t* data);
+uint8_t USB_Transmit_Message(uint8_t packet_type, uint8_t command, uint8_t status_code, uint16_t data_len, const uint8_t* data);
+void USB_Transmit_Process(void);
+void USB_TxCpltCallback(void);
 
 
 #endif /* LW_USB_TRANSMIT_H_ */
@@ -10,44 +10,130 @@
 extern USBCommParameters_t USB_Comm_Parameters;
 
 uint8_t Calculate_Checksum(const uint8_t* buf, uint16_t len);
+static void USB_Tx_Start_Transfer(void);
 
+/*
+ * Gönderilmeyi bekleyen, çerçevelenmiş mesaj kuyruğu.
+ * Head'i ana döngü (USB_Transmit_Message), tail'i transferi başlatan taraf yazar.
+ * Transfer başlatma yalnızca hat boştayken (usbTxInFlight == 0) ana döngüden,
+ * doluyken yalnızca CDC_TransmitCplt_HS'ten yapıldığı için iki taraf çakışmaz.
+ */
+static USBTxMessage_t usbTxQueue[USB_TX_QUEUE_DEPTH];
+static volatile uint8_t usbTxQueueHead 	= 0;
+static volatile uint8_t usbTxQueueTail 	= 0;
+static volatile uint8_t usbTxInFlight 	= 0;
+
+/* Bekleyen mesajların tek bulk IN transferinde birleştirildiği buffer (DMA: word hizalı) */
+static uint8_t usbTxBulkBuf[USB_TX_QUEUE_DEPTH * USB_TX_MSG_MAX_LEN] __attribute__((aligned(4)));
 
-uint8_t USB_Transmit(uint8_t* Buf, uint16_t len)
-{
-    uint8_t usb_transmit_status = CDC_Transmit_HS(Buf, len);
-    return usb_transmit_status;
-}
 
-USBTxParameters_t* USB_Prepare_Transmit_Buffer(uint8_t packet_type, uint8_t command, uint8_t status_code, uint16_t data_len, uint8_t* data)
+/*
+ * Mesajı çerçeveleyip kuyruğa ekler, hat boşsa gönderimi başlatır.
+ * Bekletmez; kuyruk doluysa USBD_BUSY, veri sığmıyorsa USBD_FAIL döner.
+ */
+uint8_t USB_Transmit_Message(uint8_t packet_type, uint8_t command, uint8_t status_code, uint16_t data_len, const uint8_t* data)
 {
-    static USBTxParameters_t txPacket;
-    uint16_t index = 0;
-    
-
-    txPacket.usbTxBuf[index++] = USB_PACKET_HEADER_1;
-    txPacket.usbTxBuf[index++] = USB_PACKET_HEADER_2;
-    txPacket.usbTxBuf[index++] = packet_type;
-    txPacket.usbTxBuf[index++] = command;
-    txPacket.usbTxBuf[index++] = status_code;       // flash için bir response'dir
-    txPacket.usbTxBuf[index++] = data_len >> 8;
-    txPacket.usbTxBuf[index++] = data_len & 0xFF;
+    uint8_t 		head = usbTxQueueHead;
+    uint8_t 		next = (uint8_t)((head + 1u) % USB_TX_QUEUE_DEPTH);
+    USBTxMessage_t 	*msg;
+    uint16_t 		index = 0;
+
+    if ((data_len + USB_OVERHEAD_BYTES) > USB_TX_MSG_MAX_LEN)
+    {
+        return USBD_FAIL;
+    }
+
+    if (next == usbTxQueueTail)
+    {
+        return USBD_BUSY;
+    }
+
+    msg = &usbTxQueue[head];
+
+    msg->buf[index++] = USB_PACKET_HEADER_1;
+    msg->buf[index++] = USB_PACKET_HEADER_2;
+    msg->buf[index++] = packet_type;
+    msg->buf[index++] = command;
+    msg->buf[index++] = status_code;       // flash için bir response'dir
+    msg->buf[index++] = data_len >> 8;
+    msg->buf[index++] = data_len & 0xFF;
 
     if (data != NULL && data_len > 0)
     {
-        memcpy(&txPacket.usbTxBuf[index], data, data_len);
+        memcpy(&msg->buf[index], data, data_len);
         index += data_len;
-        
     }
-    
-    uint8_t checksum = Calculate_Checksum(&txPacket.usbTxBuf[USB_INDEX_3_PACKET_TYPE], USB_CONSTANT_PACKET_VALUES_FOR_CHECKSUM + data_len);
-    txPacket.usbTxBuf[index++] = checksum;
 
-    txPacket.usbTxBuf[index++] = USB_PACKET_FOOTER_1;
-    txPacket.usbTxBuf[index++] = USB_PACKET_FOOTER_2;
+    uint8_t checksum = Calculate_Checksum(&msg->buf[USB_INDEX_3_PACKET_TYPE], USB_CONSTANT_PACKET_VALUES_FOR_CHECKSUM + data_len);
+    msg->buf[index++] = checksum;
+
+    msg->buf[index++] = USB_PACKET_FOOTER_1;
+    msg->buf[index++] = USB_PACKET_FOOTER_2;
+
+    msg->len = index;
+
+    /* Mesaj yazıldıktan sonra kuyruğa eklenir */
+    __DMB();
+    usbTxQueueHead = next;
+
+    USB_Transmit_Process();
+
+    return USBD_OK;
+}
+
+/*
+ * Hat boşsa bekleyen mesajları gönderir. Ana döngüden çağrılır; önceki bir
+ * denemede USB meşgul olduysa gönderim buradan tekrar denenir.
+ */
+void USB_Transmit_Process(void)
+{
+    if (usbTxInFlight == 0)
+    {
+        USB_Tx_Start_Transfer();
+    }
+}
+
+/*
+ * CDC_TransmitCplt_HS'ten (ISR) çağrılır: sıradaki mesajlar hemen gönderilir
+ */
+void USB_TxCpltCallback(void)
+{
+    usbTxInFlight = 0;
 
-    txPacket.usbTxBufLen = index;
+    USB_Tx_Start_Transfer();
+}
 
-    return &txPacket;
+/*
+ * Bekleyen tüm mesajları tek bir bulk IN transferinde birleştirip gönderir
+ */
+static void USB_Tx_Start_Transfer(void)
+{
+    uint8_t 	firstTail 	= usbTxQueueTail;
+    uint8_t 	tail 		= firstTail;
+    uint16_t 	bulkLen 	= 0;
+
+    while (tail != usbTxQueueHead)
+    {
+        memcpy(&usbTxBulkBuf[bulkLen], usbTxQueue[tail].buf, usbTxQueue[tail].len);
+        bulkLen += usbTxQueue[tail].len;
+        tail 	 = (uint8_t)((tail + 1u) % USB_TX_QUEUE_DEPTH);
+    }
+
+    if (bulkLen == 0)
+    {
+        return;
+    }
+
+    /* Tamamlanma kesmesi transfer başlar başlamaz gelebilir: önce kuyruktan düşülür */
+    usbTxQueueTail 	= tail;
+    usbTxInFlight 	= 1;
+
+    if (CDC_Transmit_HS(usbTxBulkBuf, bulkLen) != USBD_OK)
+    {
+        /* Mesajlar kuyrukta kalır, USB_Transmit_Process tekrar dener */
+        usbTxQueueTail 	= firstTail;
+        usbTxInFlight 	= 0;
+    }
 }
 
 uint8_t Calculate_Checksum(const uint8_t* buf, uint16_t len)
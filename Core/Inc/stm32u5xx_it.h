@@ -57,6 +57,8 @@ void PendSV_Handler(void);
 void SysTick_Handler(void);
 void OTG_HS_IRQHandler(void);
 /* USER CODE BEGIN EFP */
+void FLASH_IRQHandler(void);
+void GPDMA1_Channel0_IRQHandler(void);
 
 /* USER CODE END EFP */
 
@@ -22,7 +22,8 @@
 #include "usbd_cdc_if.h"
 
 /* USER CODE BEGIN INCLUDE */
-//#include "USB_Receive.h"
+#include "USB_Receive.h"
+#include "USB_Transmit.h"
 /* USER CODE END INCLUDE */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -156,7 +157,7 @@ static int8_t CDC_Init_HS(void)
   /* USER CODE BEGIN 8 */
   /* Set Application Buffers */
   USBD_CDC_SetTxBuffer(&hUsbDeviceHS, UserTxBufferHS, 0);
-  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, UserRxBufferHS);
+  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, USB_Rx_Get_Init_Buffer());
   return (USBD_OK);
   /* USER CODE END 8 */
 }
@@ -266,10 +267,23 @@ static int8_t CDC_Control_HS(uint8_t cmd, uint8_t* pbuf, uint16_t length)
 static int8_t CDC_Receive_HS(uint8_t* Buf, uint32_t *Len)
 {
   /* USER CODE BEGIN 11 */
-	USB_RXCallback(Buf, Len);
-
-	USBD_CDC_SetRxBuffer(&hUsbDeviceHS, &Buf[0]);
-	USBD_CDC_ReceivePacket(&hUsbDeviceHS);
+	uint8_t  *next;
+	uint32_t rxLen = *Len;
+
+	/*
+	 * DMA ping-pong: sonraki transfer önce diğer buffer'a kurulur, gelen veri
+	 * host bekletilmeden ring'e aktarılır. Ring doluysa endpoint kurulmaz
+	 * (host NAK alır); ana döngü CDC_Resume_Receive_HS ile devam ettirir.
+	 */
+	next = USB_Rx_Get_Rx_Buffer(rxLen);
+
+	if (next != NULL)
+	{
+		USBD_CDC_SetRxBuffer(&hUsbDeviceHS, next);
+		USBD_CDC_ReceivePacket(&hUsbDeviceHS);
+	}
+
+	USB_RXCallback(Buf, &rxLen);
   return (USBD_OK);
   /* USER CODE END 11 */
 }
@@ -314,12 +328,26 @@ static int8_t CDC_TransmitCplt_HS(uint8_t *Buf, uint32_t *Len, uint8_t epnum)
   UNUSED(Buf);
   UNUSED(Len);
   UNUSED(epnum);
+
+  /* Bekleyen TX mesajları host beklemeden gönderilir */
+  USB_TxCpltCallback();
   /* USER CODE END 14 */
   return result;
 }
 
 /* USER CODE BEGIN PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
+/**
+  * @brief  Re-arms the OUT endpoint after reception was paused (RX ring full)
+  * @param  Buf: Buffer the next transfer is written to
+  * @retval None
+  */
+void CDC_Resume_Receive_HS(uint8_t* Buf)
+{
+  USBD_CDC_SetRxBuffer(&hUsbDeviceHS, Buf);
+  USBD_CDC_ReceivePacket(&hUsbDeviceHS);
+}
+
 /* USER CODE END PRIVATE_FUNCTIONS_IMPLEMENTATION */
 
 /**
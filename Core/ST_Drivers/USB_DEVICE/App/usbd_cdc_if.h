@@ -108,6 +108,7 @@ extern USBD_CDC_ItfTypeDef USBD_Interface_fops_HS;
 uint8_t CDC_Transmit_HS(uint8_t* Buf, uint16_t Len);
 
 /* USER CODE BEGIN EXPORTED_FUNCTIONS */
+void CDC_Resume_Receive_HS(uint8_t* Buf);
 
 /* USER CODE END EXPORTED_FUNCTIONS */
 
@@ -278,7 +278,7 @@ USBD_StatusTypeDef USBD_LL_Init(USBD_HandleTypeDef *pdev)
   hpcd_USB_OTG_HS.Instance 					= USB_OTG_HS;
   hpcd_USB_OTG_HS.Init.dev_endpoints 		= 8;
   hpcd_USB_OTG_HS.Init.speed 				= PCD_SPEED_HIGH;
-  hpcd_USB_OTG_HS.Init.dma_enable 			= DISABLE;
+  hpcd_USB_OTG_HS.Init.dma_enable 			= ENABLE;
   hpcd_USB_OTG_HS.Init.phy_itface 			= USB_OTG_HS_EMBEDDED_PHY;
   hpcd_USB_OTG_HS.Init.Sof_enable 			= DISABLE;
   hpcd_USB_OTG_HS.Init.low_power_enable 	= DISABLE;
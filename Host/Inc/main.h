@@ -0,0 +1,21 @@
+/*
+ * main.h (host)
+ *
+ * Bootloader modüllerini Linux'ta derlemek için main.h yerine geçer: yalnızca
+ * host testlerinin derlediği modüllerin kullandığı tanımlar burada bulunur.
+ */
+
+#ifndef HOST_MAIN_H_
+#define HOST_MAIN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Tek çekirdekli MCU'daki bellek bariyeri, host'ta derleyici + donanım bariyeri */
+#define __DMB()		__sync_synchronize()
+#define __DSB()		__sync_synchronize()
+#define __ISB()		__sync_synchronize()
+
+#endif /* HOST_MAIN_H_ */
@@ -0,0 +1,75 @@
+/*
+ * test_util.h
+ *
+ * Host testleri ve benchmark'ları için ortak yardımcılar: xorshift32 üreteci,
+ * FAIL mesajı basıp çıkış, monoton saat ve dosyayı tampona okuma. Her test
+ * tek bir programdır; fonksiyonlar static inline olarak her birine derlenir.
+ */
+
+#ifndef HOST_TEST_UTIL_H_
+#define HOST_TEST_UTIL_H_
+
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* xorshift32 durumu; 0 olmamalı (Rand_Seed ile testin kendi tohumu verilir) */
+static uint32_t testRngState = 0x9E3779B9u;
+
+static inline void Rand_Seed(uint32_t seed)
+{
+	testRngState = seed;
+}
+
+static inline uint32_t Rand(void)
+{
+	testRngState ^= testRngState << 13;
+	testRngState ^= testRngState >> 17;
+	testRngState ^= testRngState << 5;
+	return testRngState;
+}
+
+/* "FAIL <mesaj>" basar ve testi 1 ile bitirir */
+static inline void Fail(const char *fmt, ...) __attribute__((noreturn, format(printf, 1, 2)));
+
+static inline void Fail(const char *fmt, ...)
+{
+	va_list args;
+
+	va_start(args, fmt);
+	printf("FAIL ");
+	vprintf(fmt, args);
+	printf("\n");
+	va_end(args);
+
+	exit(1);
+}
+
+static inline uint64_t NowNs(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ((uint64_t)ts.tv_sec * 1000000000ull) + (uint64_t)ts.tv_nsec;
+}
+
+/* Dosyanın en fazla cap byte'ını okur; açılamazsa test başarısız olur */
+static inline uint32_t ReadFile(const char *path, uint8_t *buf, uint32_t cap)
+{
+	FILE 	*f = fopen(path, "rb");
+	size_t 	n;
+
+	if (f == NULL)
+	{
+		Fail("cannot open %s", path);
+	}
+
+	n = fread(buf, 1, cap, f);
+	fclose(f);
+
+	return (uint32_t)n;
+}
+
+#endif /* HOST_TEST_UTIL_H_ */
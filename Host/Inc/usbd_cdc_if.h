@@ -0,0 +1,20 @@
+/*
+ * usbd_cdc_if.h (host)
+ *
+ * CDC sınıf arayüzünün host karşılığı: testler bu fonksiyonları kendisi tanımlar
+ * (gönderilen byte'ları toplar, durdurulan alımın devamını kaydeder).
+ */
+
+#ifndef HOST_USBD_CDC_IF_H_
+#define HOST_USBD_CDC_IF_H_
+
+#include <stdint.h>
+
+#define USBD_OK		0U
+#define USBD_BUSY	1U
+#define USBD_FAIL	3U
+
+uint8_t CDC_Transmit_HS(uint8_t *Buf, uint16_t Len);
+void CDC_Resume_Receive_HS(uint8_t *Buf);
+
+#endif /* HOST_USBD_CDC_IF_H_ */
@@ -0,0 +1,40 @@
+/*
+ * main.h (simülatör)
+ *
+ * Core/Inc/main.h'in simülatör karşılığı: HAL yerine Host/Sim/Inc altındaki
+ * stm32u5xx_hal.h kullanılır, pin tanımları kartla aynıdır.
+ */
+
+#ifndef HOST_SIM_MAIN_H_
+#define HOST_SIM_MAIN_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include "stm32u5xx_hal.h"
+
+void Error_Handler(void);
+
+#define EEPROM_A2_Pin GPIO_PIN_3
+#define EEPROM_A2_GPIO_Port GPIOE
+#define USB_CABLE_Pin GPIO_PIN_1
+#define USB_CABLE_GPIO_Port GPIOB
+#define MCU_PUSH_BUTTON_Pin GPIO_PIN_7
+#define MCU_PUSH_BUTTON_GPIO_Port GPIOE
+#define MCU_EEPROM_WP_Pin GPIO_PIN_9
+#define MCU_EEPROM_WP_GPIO_Port GPIOE
+#define IMU_CS_Pin GPIO_PIN_13
+#define IMU_CS_GPIO_Port GPIOB
+#define IMU_VCC_ENABLE_Pin GPIO_PIN_15
+#define IMU_VCC_ENABLE_GPIO_Port GPIOB
+#define MCU_EEPROM_VCC_ENABLE_Pin GPIO_PIN_10
+#define MCU_EEPROM_VCC_ENABLE_GPIO_Port GPIOD
+#define SYSTEM_SHUTDOWN_Pin GPIO_PIN_1
+#define SYSTEM_SHUTDOWN_GPIO_Port GPIOE
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SIM_MAIN_H_ */
@@ -0,0 +1,76 @@
+/*
+ * sim.h
+ *
+ * Bootloader simülatörünün kart modeli: flash (2 bank, SWAP_BANK), I2C EEPROM,
+ * RTC backup register'ları, NVIC ve USB CDC. Kesmeler periyodik SIGALRM ile
+ * üretilir; USB ve FLASH kesmeleri NVIC'te açıksa bu bağlamda çalıştırılır.
+ *
+ * Kartın kalıcı durumu (flash, EEPROM, backup register'ları) dosyalarda tutulur,
+ * böylece simülatör yeniden başlatıldığında (reset / güç kesintisi) korunur.
+ */
+
+#ifndef HOST_SIM_SIM_H_
+#define HOST_SIM_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define SIM_FLASH_FILE			"flash.bin"
+#define SIM_EEPROM_FILE			"eeprom.bin"
+#define SIM_BACKUP_FILE			"backup.bin"
+
+/* Kesme tick periyodu: flash adımları ve USB transferleri bu aralıkla ilerler */
+#define SIM_TICK_US				100U
+
+/* Bir tick'te tamamlanan flash adımı (sayfa silme / programlama) */
+#define SIM_FLASH_STEPS_PER_TICK	4U
+
+typedef enum
+{
+	SIM_CUT_CLEAN = 0,		// Kesilen adım hiç uygulanmaz
+	SIM_CUT_TORN			// Kesilen adım yarım kalır: silinen sayfa rastgele, programlanan bitler kısmen
+}sim_cut_mode_t;
+
+/* Kart olayları: simülatör ya da testler bağlar, varsayılanları süreci sonlandırır */
+typedef struct
+{
+	void (*reset)(void);							// NVIC_SystemReset / option byte yüklemesi
+	void (*powerOff)(void);							// SYSTEM_SHUTDOWN pini düşük
+	void (*powerCut)(void);							// Sim_Flash_SetPowerCut ile kurulan kesinti
+	void (*appStart)(uint32_t vtor);				// Bootloader uygulamaya atladı
+}sim_hooks_t;
+
+extern sim_hooks_t Sim_Hooks;
+
+/* Flash */
+bool Sim_Flash_Open(const char *path);
+void Sim_Flash_Reload(void);
+void Sim_Flash_SetPowerCut(uint32_t steps, sim_cut_mode_t mode, uint32_t seed);
+uint32_t Sim_Flash_StepCount(void);
+uint8_t *Sim_Flash_Physical(void);
+void Sim_Flash_Tick(void);
+bool Sim_Flash_IrqPending(void);
+
+/* Kart */
+bool Sim_Board_Open(const char *eepromPath, const char *backupPath);
+void Sim_Irq_Start(void);
+void Sim_Irq_Stop(void);
+void Sim_Irq_Poll(void);
+
+/* Vektör tablosu: stm32u5xx_it.c'deki gibi simülatörü kullanan program tanımlar */
+void FLASH_IRQHandler(void);
+void OTG_HS_IRQHandler(void);
+
+/* USB CDC (pseudo terminal) */
+void Sim_Usb_Open(int masterFd);
+void Sim_Usb_Tick(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SIM_SIM_H_ */
@@ -0,0 +1,280 @@
+/*
+ * stm32u5xx_hal.h (simülatör)
+ *
+ * Bootloader kaynaklarını Linux'ta değiştirmeden derlemek için HAL'in yerine
+ * geçer. Yalnızca bootloader modüllerinin kullandığı tipler, sabitler ve
+ * fonksiyonlar tanımlıdır; sabitlerin değerleri STM32U5 HAL / CMSIS ile aynıdır.
+ * Fonksiyonlar Host/Sim/Src altında simüle edilir (flash: sim_flash.c,
+ * diğerleri: sim_hal.c).
+ */
+
+#ifndef HOST_SIM_STM32U5XX_HAL_H_
+#define HOST_SIM_STM32U5XX_HAL_H_
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define __IO						volatile
+
+#define READ_BIT(REG, BIT)			((REG) & (BIT))
+#define SET_BIT(REG, BIT)			((REG) |= (BIT))
+#define CLEAR_BIT(REG, BIT)			((REG) &= ~(BIT))
+
+typedef enum
+{
+	HAL_OK 		= 0x00U,
+	HAL_ERROR 	= 0x01U,
+	HAL_BUSY 	= 0x02U,
+	HAL_TIMEOUT = 0x03U
+}HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY				0xFFFFFFFFU
+
+/* =========================================================
+ * Cortex-M33 çekirdek
+ * ========================================================= */
+typedef enum
+{
+	FLASH_IRQn 		= 6,
+	OTG_HS_IRQn 	= 73,
+	SIM_IRQ_COUNT 	= 128
+}IRQn_Type;
+
+typedef struct
+{
+	__IO uint32_t CTRL;
+	__IO uint32_t LOAD;
+	__IO uint32_t VAL;
+	__IO uint32_t CALIB;
+}SysTick_Type;
+
+typedef struct
+{
+	__IO uint32_t VTOR;
+}SCB_Type;
+
+typedef struct
+{
+	__IO uint32_t ICER[16];
+	__IO uint32_t ICPR[16];
+}NVIC_Type;
+
+extern SysTick_Type 	Sim_SysTick;
+extern SCB_Type 		Sim_SCB;
+extern NVIC_Type 		Sim_NVIC;
+
+#define SysTick						(&Sim_SysTick)
+#define SCB							(&Sim_SCB)
+#define NVIC						(&Sim_NVIC)
+
+/* Tek çekirdekli MCU'daki bariyerler: host'ta derleyici + donanım bariyeri */
+#define __DMB()						__sync_synchronize()
+#define __DSB()						__sync_synchronize()
+#define __ISB()						__sync_synchronize()
+
+void __disable_irq(void);
+void __enable_irq(void);
+void __set_MSP(uint32_t topOfMainStack);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_SystemReset(void);
+
+/* =========================================================
+ * Sistem
+ * ========================================================= */
+typedef struct
+{
+	__IO uint32_t CSR;
+}RCC_TypeDef;
+
+extern RCC_TypeDef 			Sim_RCC;
+
+#define RCC							(&Sim_RCC)
+
+uint32_t HAL_GetTick(void);
+void HAL_Delay(uint32_t Delay);
+HAL_StatusTypeDef HAL_DeInit(void);
+
+/* =========================================================
+ * GPIO
+ * ========================================================= */
+typedef struct
+{
+	__IO uint32_t ODR;
+}GPIO_TypeDef;
+
+typedef enum
+{
+	GPIO_PIN_RESET = 0U,
+	GPIO_PIN_SET
+}GPIO_PinState;
+
+extern GPIO_TypeDef 		Sim_GPIOA;
+extern GPIO_TypeDef 		Sim_GPIOB;
+extern GPIO_TypeDef 		Sim_GPIOC;
+extern GPIO_TypeDef 		Sim_GPIOD;
+extern GPIO_TypeDef 		Sim_GPIOE;
+
+#define GPIOA						(&Sim_GPIOA)
+#define GPIOB						(&Sim_GPIOB)
+#define GPIOC						(&Sim_GPIOC)
+#define GPIOD						(&Sim_GPIOD)
+#define GPIOE						(&Sim_GPIOE)
+
+#define GPIO_PIN_0					((uint16_t)0x0001)
+#define GPIO_PIN_1					((uint16_t)0x0002)
+#define GPIO_PIN_2					((uint16_t)0x0004)
+#define GPIO_PIN_3					((uint16_t)0x0008)
+#define GPIO_PIN_4					((uint16_t)0x0010)
+#define GPIO_PIN_5					((uint16_t)0x0020)
+#define GPIO_PIN_6					((uint16_t)0x0040)
+#define GPIO_PIN_7					((uint16_t)0x0080)
+#define GPIO_PIN_8					((uint16_t)0x0100)
+#define GPIO_PIN_9					((uint16_t)0x0200)
+#define GPIO_PIN_10					((uint16_t)0x0400)
+#define GPIO_PIN_11					((uint16_t)0x0800)
+#define GPIO_PIN_12					((uint16_t)0x1000)
+#define GPIO_PIN_13					((uint16_t)0x2000)
+#define GPIO_PIN_14					((uint16_t)0x4000)
+#define GPIO_PIN_15					((uint16_t)0x8000)
+
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin);
+
+/* =========================================================
+ * I2C (AT24C32 EEPROM)
+ * ========================================================= */
+typedef struct
+{
+	uint32_t 	memAddress;		// Sıralı okumada EEPROM'un adres sayacı
+}I2C_HandleTypeDef;
+
+#define I2C_MEMADD_SIZE_8BIT		(0x00000001U)
+#define I2C_MEMADD_SIZE_16BIT		(0x00000002U)
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+									uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+								   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+										  uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+										 uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials,
+										uint32_t Timeout);
+
+/* =========================================================
+ * TIM (RGB LED PWM)
+ * ========================================================= */
+typedef struct
+{
+	__IO uint32_t CCR[4];
+}TIM_HandleTypeDef;
+
+#define TIM_CHANNEL_1				0x00000000U
+#define TIM_CHANNEL_2				0x00000004U
+#define TIM_CHANNEL_3				0x00000008U
+#define TIM_CHANNEL_4				0x0000000CU
+
+#define __HAL_TIM_SET_COMPARE(__HANDLE__, __CHANNEL__, __COMPARE__) \
+	((__HANDLE__)->CCR[(__CHANNEL__) >> 2U] = (__COMPARE__))
+
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel);
+
+/* =========================================================
+ * RTC backup register'ları, IWDG
+ * ========================================================= */
+typedef struct
+{
+	__IO uint32_t BKPR[32];
+}RTC_HandleTypeDef;
+
+#define RTC_BKP_DR10				0x0AU
+
+uint32_t HAL_RTCEx_BKUPRead(RTC_HandleTypeDef *hrtc, uint32_t BackupRegister);
+void HAL_RTCEx_BKUPWrite(RTC_HandleTypeDef *hrtc, uint32_t BackupRegister, uint32_t Data);
+
+typedef struct
+{
+	uint32_t 	refreshCount;
+}IWDG_HandleTypeDef;
+
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef *hiwdg);
+
+/* =========================================================
+ * FLASH (2 bank x 2 MB, 8 KB sayfa)
+ * ========================================================= */
+typedef struct
+{
+	__IO uint32_t OPTR;
+}FLASH_TypeDef;
+
+extern FLASH_TypeDef 		Sim_FLASH;
+
+#define FLASH						(&Sim_FLASH)
+
+#define FLASH_BASE					(0x08000000UL)
+#define FLASH_SIZE					(0x00400000UL)
+#define FLASH_BANK_SIZE				(FLASH_SIZE >> 1U)
+#define FLASH_PAGE_SIZE				0x2000U
+#define FLASH_PAGE_NB				(FLASH_BANK_SIZE / FLASH_PAGE_SIZE)
+#define FLASH_NB_WORDS_IN_BURST		32
+
+#define FLASH_OPTR_SWAP_BANK_Pos	(20UL)
+#define FLASH_OPTR_SWAP_BANK		(0x1UL << FLASH_OPTR_SWAP_BANK_Pos)
+
+#define FLASH_BANK_1				0x00000001U
+#define FLASH_BANK_2				0x00000002U
+
+#define FLASH_TYPEERASE_PAGES		0x00000002U
+#define FLASH_TYPEPROGRAM_QUADWORD	0x00000001U
+#define FLASH_TYPEPROGRAM_BURST		0x00004001U
+
+#define OPTIONBYTE_USER				0x00000004U
+#define OB_USER_SWAP_BANK			0x00000200U
+#define OB_SWAP_BANK_DISABLE		0x00000000U
+#define OB_SWAP_BANK_ENABLE			FLASH_OPTR_SWAP_BANK
+
+typedef struct
+{
+	uint32_t TypeErase;
+	uint32_t Banks;
+	uint32_t Page;
+	uint32_t NbPages;
+}FLASH_EraseInitTypeDef;
+
+typedef struct
+{
+	uint32_t OptionType;
+	uint32_t USERType;
+	uint32_t USERConfig;
+}FLASH_OBProgramInitTypeDef;
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_OB_Unlock(void);
+HAL_StatusTypeDef HAL_FLASH_OB_Lock(void);
+HAL_StatusTypeDef HAL_FLASH_OB_Launch(void);
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint32_t DataAddress);
+HAL_StatusTypeDef HAL_FLASH_Program_IT(uint32_t TypeProgram, uint32_t Address, uint32_t DataAddress);
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError);
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(FLASH_EraseInitTypeDef *pEraseInit);
+HAL_StatusTypeDef HAL_FLASHEx_OBProgram(FLASH_OBProgramInitTypeDef *pOBInit);
+void HAL_FLASH_IRQHandler(void);
+void HAL_FLASH_EndOfOperationCallback(uint32_t ReturnValue);
+void HAL_FLASH_OperationErrorCallback(uint32_t ReturnValue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HOST_SIM_STM32U5XX_HAL_H_ */
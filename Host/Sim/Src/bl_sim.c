@@ -0,0 +1,308 @@
+/*
+ * bl_sim.c
+ *
+ * Bootloader'ı Linux'ta çalıştıran cihaz simülatörü. Core altındaki
+ * Bootloader_Task, USB_Receive.c ve USB_Transmit.c değiştirilmeden derlenir;
+ * flash, EEPROM ve backup register'ları state dizinindeki dosyalardır, USB CDC
+ * ise bir pseudo terminal'dir (host tarafı --pty ile verilen yola bağlanır).
+ *
+ *   bl_sim --pty <link> --state <dir> [--update-request] [--power-cut <n> [--torn] [--seed <s>]]
+ *
+ * Çıkış kodları: 0 uygulamaya atlandı, 3 kart kapandı (SYSTEM_SHUTDOWN),
+ * 4 güç kesildi (--power-cut), 1 hata. Reset (RESET_DEVICE komutu, option byte
+ * yüklemesi) süreci aynı pty ve state ile yeniden başlatır.
+ *
+ * Firmware 32 bit adres alanında çalışmalıdır: bootloader veri pointer'larını
+ * uint32_t olarak taşır (CRC32_Image, Flash_PrepareStep, Meta_Write). Program
+ * -no-pie ile derlenir (.data / .bss düşük adreste), firmware'in stack'i de
+ * MAP_32BIT ile ayrılır.
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <termios.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "sim.h"
+#include "bootloader_driver.h"
+#include "bootloader_sram.h"
+#include "at24c32_driver.h"
+#include "flash_driver.h"
+
+#define SIM_STACK_SIZE			(1024U * 1024U)
+
+/* Core/Src/main.c'deki global handle'lar */
+I2C_HandleTypeDef 			hi2c1;
+IWDG_HandleTypeDef 			hiwdg;
+RTC_HandleTypeDef 			hrtc;
+TIM_HandleTypeDef 			htim3;
+S_AT24C32_t 				at24c32;
+BootloaderCtx_t 			bootloaderCTX;
+
+static ucontext_t 			hostCtx;
+static ucontext_t 			firmwareCtx;
+static int 					ptyMaster = -1;
+static int 					ptySlave  = -1;
+static char 				**simArgv;
+static int 					simArgc;
+
+static void Usage(const char *prog)
+{
+	fprintf(stderr, "usage: %s --pty <link> --state <dir> [--update-request] "
+					"[--power-cut <n> [--torn] [--seed <s>]]\n", prog);
+	exit(1);
+}
+
+/* stm32u5xx_it.c */
+void FLASH_IRQHandler(void)
+{
+	Flash_Async_IRQHandler();
+}
+
+void OTG_HS_IRQHandler(void)
+{
+	Sim_Usb_Tick();
+}
+
+/* Reset: süreç aynı pty ile baştan başlar, tek seferlik seçenekler düşer */
+static void Sim_Reset(void)
+{
+	static char *argv[32];
+	static char fdArg[32];
+	int 		argc = 0;
+
+	Sim_Irq_Stop();
+	fprintf(stderr, "bl_sim: reset\n");
+
+	for (int i = 0; (i < simArgc) && (argc < 28); i++)
+	{
+		if ((strcmp(simArgv[i], "--update-request") == 0) || (strcmp(simArgv[i], "--torn") == 0))
+		{
+			continue;
+		}
+
+		if ((strcmp(simArgv[i], "--power-cut") == 0) || (strcmp(simArgv[i], "--seed") == 0) ||
+			(strcmp(simArgv[i], "--pty-fd") == 0))
+		{
+			i++;
+			continue;
+		}
+
+		argv[argc++] = simArgv[i];
+	}
+
+	snprintf(fdArg, sizeof(fdArg), "%d,%d", ptyMaster, ptySlave);
+	argv[argc++] = "--pty-fd";
+	argv[argc++] = fdArg;
+	argv[argc]   = NULL;
+
+	execv("/proc/self/exe", argv);
+	perror("bl_sim: execv");
+	_exit(1);
+}
+
+static void Sim_PowerOff(void)
+{
+	fprintf(stderr, "bl_sim: power off\n");
+	_exit(3);
+}
+
+static void Sim_PowerCut(void)
+{
+	fprintf(stderr, "bl_sim: power cut at flash step %u\n", Sim_Flash_StepCount());
+	_exit(4);
+}
+
+static void Sim_AppStart(uint32_t vtor)
+{
+	uint32_t reset;
+
+	memcpy(&reset, (const void *)(uintptr_t)(vtor + 4U), sizeof(reset));
+
+	fprintf(stderr, "bl_sim: application started, VTOR 0x%08X reset 0x%08X\n", vtor, reset);
+	_exit(0);
+}
+
+static void Sim_OpenPty(const char *link)
+{
+	struct termios 	tio;
+	const char 		*name;
+
+	ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+
+	if ((ptyMaster < 0) || (grantpt(ptyMaster) != 0) || (unlockpt(ptyMaster) != 0) ||
+		((name = ptsname(ptyMaster)) == NULL))
+	{
+		perror("bl_sim: pty");
+		exit(1);
+	}
+
+	/* Slave açık tutulur: host bağlantıyı kapatıp açtığında master EIO vermez */
+	ptySlave = open(name, O_RDWR | O_NOCTTY);
+
+	if (ptySlave < 0)
+	{
+		perror("bl_sim: pty slave");
+		exit(1);
+	}
+
+	tcgetattr(ptySlave, &tio);
+	cfmakeraw(&tio);
+	tcsetattr(ptySlave, TCSANOW, &tio);
+
+	unlink(link);
+
+	if (symlink(name, link) != 0)
+	{
+		perror("bl_sim: symlink");
+		exit(1);
+	}
+}
+
+/* Core/Src/main.c'deki açılış sırası */
+static void Firmware_Main(void)
+{
+	Sim_Usb_Open(ptyMaster);
+	Sim_Irq_Start();
+
+	AT24C32_Initialization(&at24c32, &hi2c1);
+	Bootloader_Init(&bootloaderCTX);
+
+	while (1)
+	{
+		Bootloader_Task(&bootloaderCTX);
+	}
+}
+
+int main(int argc, char **argv)
+{
+	const char 		*link 	 	= NULL;
+	const char 		*state 	 	= NULL;
+	bool 			request  	= false;
+	uint32_t 		cutAt 	 	= 0U;
+	uint32_t 		seed 	 	= 1U;
+	sim_cut_mode_t 	cutMode  	= SIM_CUT_CLEAN;
+	char 			path[PATH_MAX];
+	void 			*stack;
+
+	simArgc = argc;
+	simArgv = argv;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = (i + 1) < argc;
+
+		if ((strcmp(argv[i], "--pty") == 0) && hasValue)
+		{
+			link = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--state") == 0) && hasValue)
+		{
+			state = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--pty-fd") == 0) && hasValue)
+		{
+			if (sscanf(argv[++i], "%d,%d", &ptyMaster, &ptySlave) != 2)
+			{
+				Usage(argv[0]);
+			}
+		}
+		else if ((strcmp(argv[i], "--power-cut") == 0) && hasValue)
+		{
+			cutAt = (uint32_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if ((strcmp(argv[i], "--seed") == 0) && hasValue)
+		{
+			seed = (uint32_t)strtoul(argv[++i], NULL, 0);
+		}
+		else if (strcmp(argv[i], "--torn") == 0)
+		{
+			cutMode = SIM_CUT_TORN;
+		}
+		else if (strcmp(argv[i], "--update-request") == 0)
+		{
+			request = true;
+		}
+		else
+		{
+			Usage(argv[0]);
+		}
+	}
+
+	if ((link == NULL) || (state == NULL))
+	{
+		Usage(argv[0]);
+	}
+
+	setvbuf(stderr, NULL, _IONBF, 0);
+
+	if (ptyMaster < 0)
+	{
+		Sim_OpenPty(link);
+	}
+
+	Sim_Hooks.reset 	= Sim_Reset;
+	Sim_Hooks.powerOff 	= Sim_PowerOff;
+	Sim_Hooks.powerCut 	= Sim_PowerCut;
+	Sim_Hooks.appStart 	= Sim_AppStart;
+
+	snprintf(path, sizeof(path), "%s/%s", state, SIM_FLASH_FILE);
+
+	if (Sim_Flash_Open(path) != true)
+	{
+		fprintf(stderr, "bl_sim: cannot open %s\n", path);
+		return 1;
+	}
+
+	{
+		char backupPath[PATH_MAX];
+
+		snprintf(path, sizeof(path), "%s/%s", state, SIM_EEPROM_FILE);
+		snprintf(backupPath, sizeof(backupPath), "%s/%s", state, SIM_BACKUP_FILE);
+
+		if (Sim_Board_Open(path, backupPath) != true)
+		{
+			fprintf(stderr, "bl_sim: cannot open board state in %s\n", state);
+			return 1;
+		}
+	}
+
+	/* Uygulamanın update isteği: BL_RTCBackup_RequestUpdate ile aynı register */
+	if (request == true)
+	{
+		HAL_RTCEx_BKUPWrite(&hrtc, RTC_BKP_DR10, BL_UPDATE_MAGIC);
+	}
+
+	if (cutAt != 0U)
+	{
+		Sim_Flash_SetPowerCut(cutAt, cutMode, seed);
+	}
+
+	stack = mmap(NULL, SIM_STACK_SIZE, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT | MAP_STACK, -1, 0);
+
+	if ((stack == MAP_FAILED) || ((uintptr_t)main > 0xFFFFFFFFu))
+	{
+		fprintf(stderr, "bl_sim: firmware needs a 32-bit address space (build with -no-pie)\n");
+		return 1;
+	}
+
+	fprintf(stderr, "bl_sim: boot (flash %s/%s)\n", state, SIM_FLASH_FILE);
+
+	getcontext(&firmwareCtx);
+	firmwareCtx.uc_stack.ss_sp 	 = stack;
+	firmwareCtx.uc_stack.ss_size = SIM_STACK_SIZE;
+	firmwareCtx.uc_link 		 = &hostCtx;
+	makecontext(&firmwareCtx, Firmware_Main, 0);
+	swapcontext(&hostCtx, &firmwareCtx);
+
+	return 1;
+}
@@ -0,0 +1,512 @@
+/*
+ * sim_flash.c
+ *
+ * STM32U5 flash modeli: 2 bank x 2 MB, 8 KB sayfa, quad-word (16 B) ve burst
+ * (128 B) programlama. Flash içeriği bir dosyada tutulur ve 0x08000000'a
+ * salt okunur olarak map'lenir; bootloader flash'ı hedefteki gibi doğrudan
+ * adresinden okur. Yazma yalnızca HAL fonksiyonları üzerinden yapılır.
+ *
+ * Dosya düzeni: [bank 1 (fiziksel)][bank 2 (fiziksel)][option byte sayfası]
+ *
+ * SWAP_BANK set ise adres haritasında banklar yer değiştirir: 0x08000000
+ * fiziksel bank 2'yi gösterir. Programlama adresi haritadaki (mantıksal)
+ * adrestir; silmede FLASH_EraseInitTypeDef.Banks fiziksel bankı seçer
+ * (flash_driver.c Flash_MapRange bu varsayımla çalışır).
+ *
+ * Hedefteki gibi boş olmayan quad-word'e programlama hatadır (ECC).
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "main.h"
+#include "sim.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+#define MAP_FIXED_NOREPLACE		0x100000
+#endif
+
+#define SIM_OPTION_PAGE			(FLASH_SIZE)
+#define SIM_FILE_SIZE			(FLASH_SIZE + FLASH_PAGE_SIZE)
+
+#define SIM_QUADWORD_SIZE		16U
+#define SIM_BURST_SIZE			(FLASH_NB_WORDS_IN_BURST * 4U)
+
+typedef enum
+{
+	SIM_OP_NONE = 0,
+	SIM_OP_ERASE,
+	SIM_OP_PROGRAM
+}sim_flash_op_t;
+
+FLASH_TypeDef 				Sim_FLASH;
+
+static int 					flashFd 	= -1;
+static uint8_t 				*physical;					// Dosyanın yazılabilir görünümü
+static bool 				mapped;
+static bool 				locked 		= true;
+static bool 				obLocked 	= true;
+
+/* Kesmeyle yürütülen iş (HAL_FLASHEx_Erase_IT / HAL_FLASH_Program_IT) */
+static volatile sim_flash_op_t 	itOp;
+static volatile bool 			itStepDone;				// Adım bitti, kesme bekliyor
+static volatile bool 			itError;
+static uint32_t 				itBank;
+static uint32_t 				itPage;
+static uint32_t 				itPagesLeft;
+static uint32_t 				itType;
+static uint32_t 				itAddress;
+static uint8_t 					itData[SIM_BURST_SIZE];
+
+/* Güç kesintisi */
+static uint32_t 			stepCount;
+static uint32_t 			cutAt;						// 0: kapalı, N: N. adımda kesilir
+static sim_cut_mode_t 		cutMode;
+static uint32_t 			cutRng;
+
+sim_hooks_t 				Sim_Hooks;
+
+static uint32_t Sim_Rand(void)
+{
+	cutRng ^= cutRng << 13;
+	cutRng ^= cutRng >> 17;
+	cutRng ^= cutRng << 5;
+	return cutRng;
+}
+
+static void Sim_Flash_Map(void)
+{
+	bool 	 swapped = ((Sim_FLASH.OPTR & FLASH_OPTR_SWAP_BANK) != 0U);
+	int 	 flags 	 = MAP_SHARED | (mapped ? MAP_FIXED : MAP_FIXED_NOREPLACE);
+
+	for (uint32_t bank = 0; bank < 2U; bank++)
+	{
+		void 	*at 	= (void *)(uintptr_t)(FLASH_BASE + (bank * FLASH_BANK_SIZE));
+		off_t 	offset 	= (off_t)((swapped ? (bank ^ 1U) : bank) * FLASH_BANK_SIZE);
+
+		if (mmap(at, FLASH_BANK_SIZE, PROT_READ, flags, flashFd, offset) != at)
+		{
+			perror("sim: flash map");
+			_exit(1);
+		}
+	}
+
+	mapped = true;
+}
+
+/* Mantıksal adresi dosyadaki fiziksel offset'e çevirir */
+static uint32_t Sim_Flash_ToPhysical(uint32_t address)
+{
+	uint32_t offset = address - FLASH_BASE;
+
+	if ((Sim_FLASH.OPTR & FLASH_OPTR_SWAP_BANK) != 0U)
+	{
+		offset ^= FLASH_BANK_SIZE;
+	}
+
+	return offset;
+}
+
+/*
+ * Her sayfa silme / programlama bir adımdır ve uygulanmadan önce buradan geçer.
+ * Kurulan kesinti adımına gelindiyse adım uygulanmaz (ya da yarım uygulanır),
+ * powerCut çağrılır ve fonksiyon dönmez.
+ */
+static void Sim_Flash_Step(uint8_t *dst, const uint8_t *src, uint32_t len)
+{
+	stepCount += 1U;
+
+	if ((cutAt == 0U) || (stepCount != cutAt))
+	{
+		return;
+	}
+
+	if (cutMode == SIM_CUT_TORN)
+	{
+		for (uint32_t i = 0; i < len; i++)
+		{
+			uint8_t rnd = (uint8_t)Sim_Rand();
+
+			/* Silme: sayfa belirsiz; programlama: sıfırlanacak bitlerin bir kısmı sıfırlandı */
+			dst[i] = (src == NULL) ? rnd : (uint8_t)(dst[i] & (src[i] | rnd));
+		}
+	}
+
+	cutAt = 0U;
+
+	if (Sim_Hooks.powerCut != NULL)
+	{
+		Sim_Hooks.powerCut();
+	}
+
+	_exit(4);
+}
+
+static void Sim_Flash_ErasePage(uint32_t bank, uint32_t page)
+{
+	uint8_t *dst = &physical[((bank == FLASH_BANK_2) ? FLASH_BANK_SIZE : 0U) + (page * FLASH_PAGE_SIZE)];
+
+	Sim_Flash_Step(dst, NULL, FLASH_PAGE_SIZE);
+	memset(dst, 0xFF, FLASH_PAGE_SIZE);
+}
+
+static bool Sim_Flash_CheckErase(const FLASH_EraseInitTypeDef *init)
+{
+	return (init != NULL) &&
+		   (init->TypeErase == FLASH_TYPEERASE_PAGES) &&
+		   ((init->Banks == FLASH_BANK_1) || (init->Banks == FLASH_BANK_2)) &&
+		   (init->NbPages != 0U) &&
+		   (init->Page < FLASH_PAGE_NB) &&
+		   (init->NbPages <= (FLASH_PAGE_NB - init->Page));
+}
+
+static uint32_t Sim_Flash_ProgramSize(uint32_t type)
+{
+	if (type == FLASH_TYPEPROGRAM_QUADWORD)
+	{
+		return SIM_QUADWORD_SIZE;
+	}
+
+	if (type == FLASH_TYPEPROGRAM_BURST)
+	{
+		return SIM_BURST_SIZE;
+	}
+
+	return 0U;
+}
+
+static bool Sim_Flash_CheckProgram(uint32_t type, uint32_t address)
+{
+	uint32_t size = Sim_Flash_ProgramSize(type);
+
+	return (size != 0U) &&
+		   (address >= FLASH_BASE) &&
+		   ((address - FLASH_BASE) <= (FLASH_SIZE - size)) &&
+		   ((address % size) == 0U);
+}
+
+/* Boş olmayan quad-word'e programlama hatadır */
+static bool Sim_Flash_ProgramData(uint32_t type, uint32_t address, const uint8_t *src)
+{
+	uint32_t size 	= Sim_Flash_ProgramSize(type);
+	uint8_t  *dst 	= &physical[Sim_Flash_ToPhysical(address)];
+
+	for (uint32_t i = 0; i < size; i++)
+	{
+		if (dst[i] != 0xFFU)
+		{
+			return false;
+		}
+	}
+
+	Sim_Flash_Step(dst, src, size);
+	memcpy(dst, src, size);
+
+	return true;
+}
+
+/* =========================================================
+ * Simülatör arayüzü
+ * ========================================================= */
+bool Sim_Flash_Open(const char *path)
+{
+	uint32_t optr;
+
+	flashFd = open(path, O_RDWR | O_CREAT, 0644);
+
+	if (flashFd < 0)
+	{
+		perror(path);
+		return false;
+	}
+
+	if (lseek(flashFd, 0, SEEK_END) < (off_t)SIM_FILE_SIZE)
+	{
+		/* Yeni flash: tamamı silinmiş, option byte'lar varsayılan (SWAP_BANK = 0) */
+		static uint8_t erased[FLASH_PAGE_SIZE];
+
+		memset(erased, 0xFF, sizeof(erased));
+
+		for (uint32_t off = 0; off < FLASH_SIZE; off += FLASH_PAGE_SIZE)
+		{
+			if (pwrite(flashFd, erased, sizeof(erased), (off_t)off) != (ssize_t)sizeof(erased))
+			{
+				perror(path);
+				return false;
+			}
+		}
+
+		optr = 0U;
+
+		if ((pwrite(flashFd, &optr, sizeof(optr), SIM_OPTION_PAGE) != (ssize_t)sizeof(optr)) ||
+			(ftruncate(flashFd, (off_t)SIM_FILE_SIZE) != 0))
+		{
+			perror(path);
+			return false;
+		}
+	}
+
+	physical = mmap(NULL, SIM_FILE_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, flashFd, 0);
+
+	if (physical == MAP_FAILED)
+	{
+		perror("sim: flash");
+		return false;
+	}
+
+	Sim_Flash_Reload();
+
+	return true;
+}
+
+/* Reset: option byte'lar yüklenir, banklar yeniden map'lenir, süren işler kaybolur */
+void Sim_Flash_Reload(void)
+{
+	memcpy((void *)&Sim_FLASH.OPTR, &physical[SIM_OPTION_PAGE], sizeof(uint32_t));
+
+	itOp 		= SIM_OP_NONE;
+	itStepDone 	= false;
+	itError 	= false;
+	locked 		= true;
+	obLocked 	= true;
+
+	Sim_Flash_Map();
+}
+
+/*
+ * steps: bu kadar adım sonra güç kesilir (0: kapalı). Adım sayacı sıfırlanır.
+ */
+void Sim_Flash_SetPowerCut(uint32_t steps, sim_cut_mode_t mode, uint32_t seed)
+{
+	stepCount 	= 0U;
+	cutAt 		= steps;
+	cutMode 	= mode;
+	cutRng 		= (seed != 0U) ? seed : 0x2545F491U;
+}
+
+uint32_t Sim_Flash_StepCount(void)
+{
+	return stepCount;
+}
+
+uint8_t *Sim_Flash_Physical(void)
+{
+	return physical;
+}
+
+/* Kesmeyle yürütülen işin sıradaki adımı (FLASH kesmesi servis edilene kadar bir adım) */
+void Sim_Flash_Tick(void)
+{
+	if ((itOp == SIM_OP_NONE) || (itStepDone == true))
+	{
+		return;
+	}
+
+	if (itOp == SIM_OP_ERASE)
+	{
+		Sim_Flash_ErasePage(itBank, itPage);
+	}
+	else if (Sim_Flash_ProgramData(itType, itAddress, itData) != true)
+	{
+		itError = true;
+	}
+
+	itStepDone = true;
+}
+
+bool Sim_Flash_IrqPending(void)
+{
+	return itStepDone;
+}
+
+/* =========================================================
+ * HAL
+ * ========================================================= */
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+	locked = false;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+	locked = true;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_OB_Unlock(void)
+{
+	if (locked == true)
+	{
+		return HAL_ERROR;
+	}
+
+	obLocked = false;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_OB_Lock(void)
+{
+	obLocked = true;
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_OBProgram(FLASH_OBProgramInitTypeDef *pOBInit)
+{
+	uint32_t optr;
+
+	if ((locked == true) || (obLocked == true) || (itOp != SIM_OP_NONE) || (pOBInit == NULL))
+	{
+		return HAL_ERROR;
+	}
+
+	memcpy(&optr, &physical[SIM_OPTION_PAGE], sizeof(optr));
+
+	if (((pOBInit->OptionType & OPTIONBYTE_USER) != 0U) && ((pOBInit->USERType & OB_USER_SWAP_BANK) != 0U))
+	{
+		optr = (optr & ~FLASH_OPTR_SWAP_BANK) | (pOBInit->USERConfig & FLASH_OPTR_SWAP_BANK);
+	}
+
+	memcpy(&physical[SIM_OPTION_PAGE], &optr, sizeof(optr));
+	msync(physical, SIM_FILE_SIZE, MS_SYNC);
+
+	return HAL_OK;
+}
+
+/* Option byte yüklemesi cihazı reset'ler */
+HAL_StatusTypeDef HAL_FLASH_OB_Launch(void)
+{
+	if (obLocked == true)
+	{
+		return HAL_ERROR;
+	}
+
+	if (Sim_Hooks.reset != NULL)
+	{
+		Sim_Hooks.reset();
+	}
+
+	return HAL_ERROR;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+	if ((locked == true) || (itOp != SIM_OP_NONE) || (Sim_Flash_CheckErase(pEraseInit) != true))
+	{
+		return HAL_ERROR;
+	}
+
+	for (uint32_t i = 0; i < pEraseInit->NbPages; i++)
+	{
+		Sim_Flash_ErasePage(pEraseInit->Banks, pEraseInit->Page + i);
+	}
+
+	if (PageError != NULL)
+	{
+		*PageError = 0xFFFFFFFFU;
+	}
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASHEx_Erase_IT(FLASH_EraseInitTypeDef *pEraseInit)
+{
+	if ((locked == true) || (itOp != SIM_OP_NONE) || (Sim_Flash_CheckErase(pEraseInit) != true))
+	{
+		return HAL_ERROR;
+	}
+
+	itBank 		= pEraseInit->Banks;
+	itPage 		= pEraseInit->Page;
+	itPagesLeft = pEraseInit->NbPages;
+	itError 	= false;
+	itStepDone 	= false;
+	__sync_synchronize();			// Kesme bağlamı itOp'u görmeden önce parametreler yazılmış olmalı
+	itOp 		= SIM_OP_ERASE;
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint32_t DataAddress)
+{
+	if ((locked == true) || (itOp != SIM_OP_NONE) || (Sim_Flash_CheckProgram(TypeProgram, Address) != true))
+	{
+		return HAL_ERROR;
+	}
+
+	if (Sim_Flash_ProgramData(TypeProgram, Address, (const uint8_t *)(uintptr_t)DataAddress) != true)
+	{
+		return HAL_ERROR;
+	}
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Program_IT(uint32_t TypeProgram, uint32_t Address, uint32_t DataAddress)
+{
+	if ((locked == true) || (itOp != SIM_OP_NONE) || (Sim_Flash_CheckProgram(TypeProgram, Address) != true))
+	{
+		return HAL_ERROR;
+	}
+
+	/* Donanım veriyi yazma sırasında kaynaktan okur; kaynak iş bitene kadar geçerli kalmalı */
+	memcpy(itData, (const uint8_t *)(uintptr_t)DataAddress, Sim_Flash_ProgramSize(TypeProgram));
+
+	itType 		= TypeProgram;
+	itAddress 	= Address;
+	itError 	= false;
+	itStepDone 	= false;
+	__sync_synchronize();			// Kesme bağlamı itOp'u görmeden önce parametreler yazılmış olmalı
+	itOp 		= SIM_OP_PROGRAM;
+
+	return HAL_OK;
+}
+
+/*
+ * Biten adımın kesmesi: silmede her sayfa için EndOfOperation(sayfa), son sayfada
+ * EndOfOperation(0xFFFFFFFF); hata olursa OperationError(adres)
+ */
+void HAL_FLASH_IRQHandler(void)
+{
+	if (itStepDone == false)
+	{
+		return;
+	}
+
+	itStepDone = false;
+
+	if (itOp == SIM_OP_ERASE)
+	{
+		uint32_t page = itPage;
+
+		itPagesLeft -= 1U;
+
+		if (itPagesLeft != 0U)
+		{
+			itPage += 1U;
+			HAL_FLASH_EndOfOperationCallback(page);
+			return;
+		}
+
+		itOp = SIM_OP_NONE;
+		HAL_FLASH_EndOfOperationCallback(0xFFFFFFFFU);
+		return;
+	}
+
+	if (itOp == SIM_OP_PROGRAM)
+	{
+		itOp = SIM_OP_NONE;
+
+		if (itError == true)
+		{
+			HAL_FLASH_OperationErrorCallback(itAddress);
+		}
+		else
+		{
+			HAL_FLASH_EndOfOperationCallback(itAddress);
+		}
+	}
+}
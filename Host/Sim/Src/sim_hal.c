@@ -0,0 +1,429 @@
+/*
+ * sim_hal.c
+ *
+ * HAL'in flash dışındaki kısmı: çekirdek (NVIC, PRIMASK, VTOR), SysTick,
+ * GPIO, I2C üzerindeki AT24C32, RTC backup register'ları ve IWDG.
+ *
+ * Kesmeler SIM_TICK_US periyotlu SIGALRM ile üretilir. Handler, PRIMASK
+ * kapalı değilse flash adımlarını ilerletir ve NVIC'te açık olan USB / FLASH
+ * kesmelerini çağırır; böylece firmware'in ana döngüsü ile kesme bağlamı
+ * gerçek karttaki gibi birbirini keser.
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "sim.h"
+
+#define SIM_EEPROM_SIZE			4096U
+#define SIM_EEPROM_PAGE_SIZE	32U
+#define SIM_BACKUP_COUNT		32U
+
+SysTick_Type 				Sim_SysTick;
+SCB_Type 					Sim_SCB;
+NVIC_Type 					Sim_NVIC;
+RCC_TypeDef 				Sim_RCC;
+GPIO_TypeDef 				Sim_GPIOA;
+GPIO_TypeDef 				Sim_GPIOB;
+GPIO_TypeDef 				Sim_GPIOC;
+GPIO_TypeDef 				Sim_GPIOD;
+GPIO_TypeDef 				Sim_GPIOE;
+
+static volatile bool 		primask;
+static volatile bool 		inIrq;
+static volatile bool 		irqEnabled[SIM_IRQ_COUNT];
+static struct timespec 		bootTime;
+
+static uint8_t 				*eeprom;					// Kalıcı: eeprom.bin
+static uint32_t 			*backup;					// Kalıcı: backup.bin (VBAT domain)
+
+static void *Sim_Board_MapFile(const char *path, size_t size, uint8_t fill)
+{
+	int 	fd = open(path, O_RDWR | O_CREAT, 0644);
+	off_t 	len;
+	void 	*p;
+
+	if (fd < 0)
+	{
+		return NULL;
+	}
+
+	len = lseek(fd, 0, SEEK_END);
+
+	/* Yeni dosya: kartın ilk açılışı (EEPROM silinmiş, backup register'ları sıfır) */
+	if (len < (off_t)size)
+	{
+		uint8_t blank[256];
+
+		memset(blank, fill, sizeof(blank));
+
+		for (off_t pos = len; pos < (off_t)size; pos += (off_t)sizeof(blank))
+		{
+			if (pwrite(fd, blank, sizeof(blank), pos) != (ssize_t)sizeof(blank))
+			{
+				close(fd);
+				return NULL;
+			}
+		}
+	}
+
+	p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+
+	return (p == MAP_FAILED) ? NULL : p;
+}
+
+bool Sim_Board_Open(const char *eepromPath, const char *backupPath)
+{
+	eeprom = Sim_Board_MapFile(eepromPath, SIM_EEPROM_SIZE, 0xFFU);
+	backup = Sim_Board_MapFile(backupPath, SIM_BACKUP_COUNT * sizeof(uint32_t), 0x00U);
+
+	clock_gettime(CLOCK_MONOTONIC, &bootTime);
+
+	/* Reset sonrası: kesmeler açık, VTOR bootloader'ı gösterir */
+	primask 	 = false;
+	Sim_SCB.VTOR = 0U;
+
+	return (eeprom != NULL) && (backup != NULL);
+}
+
+/* =========================================================
+ * Çekirdek
+ * ========================================================= */
+void __disable_irq(void)
+{
+	primask = true;
+	__sync_synchronize();
+}
+
+void __enable_irq(void)
+{
+	__sync_synchronize();
+	primask = false;
+
+	/* BL_Jump: VTOR uygulamaya çevrildikten sonra kesmeler açılır, ardından uygulama başlar */
+	if (Sim_SCB.VTOR != 0U)
+	{
+		if (Sim_Hooks.appStart != NULL)
+		{
+			Sim_Hooks.appStart(Sim_SCB.VTOR);
+		}
+
+		_exit(0);
+	}
+}
+
+void __set_MSP(uint32_t topOfMainStack)
+{
+	(void)topOfMainStack;
+}
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+	(void)IRQn;
+	(void)PreemptPriority;
+	(void)SubPriority;
+}
+
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+	irqEnabled[IRQn] = true;
+}
+
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+	irqEnabled[IRQn] = false;
+	__sync_synchronize();
+}
+
+void HAL_NVIC_SystemReset(void)
+{
+	if (Sim_Hooks.reset != NULL)
+	{
+		Sim_Hooks.reset();
+	}
+
+	_exit(2);
+}
+
+/* =========================================================
+ * Sistem
+ * ========================================================= */
+uint32_t HAL_GetTick(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (uint32_t)(((now.tv_sec - bootTime.tv_sec) * 1000LL) +
+					  ((now.tv_nsec - bootTime.tv_nsec) / 1000000LL));
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+	uint32_t start = HAL_GetTick();
+
+	while ((HAL_GetTick() - start) < Delay)
+	{
+		struct timespec ts = { 0, 1000000L };
+
+		/* Kesme sinyali uykuyu böler, süre HAL_GetTick ile tamamlanır */
+		nanosleep(&ts, NULL);
+	}
+}
+
+HAL_StatusTypeDef HAL_DeInit(void)
+{
+	return HAL_OK;
+}
+
+void Error_Handler(void)
+{
+	fprintf(stderr, "bl_sim: Error_Handler\n");
+	_exit(1);
+}
+
+/* =========================================================
+ * GPIO
+ * ========================================================= */
+void HAL_GPIO_WritePin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+	if (PinState == GPIO_PIN_SET)
+	{
+		GPIOx->ODR |= GPIO_Pin;
+		return;
+	}
+
+	GPIOx->ODR &= ~(uint32_t)GPIO_Pin;
+
+	/* Güç tutma pini bırakıldı: kart kapanır */
+	if ((GPIOx == SYSTEM_SHUTDOWN_GPIO_Port) && (GPIO_Pin == SYSTEM_SHUTDOWN_Pin))
+	{
+		if (Sim_Hooks.powerOff != NULL)
+		{
+			Sim_Hooks.powerOff();
+		}
+
+		_exit(3);
+	}
+}
+
+GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *GPIOx, uint16_t GPIO_Pin)
+{
+	return ((GPIOx->ODR & GPIO_Pin) != 0U) ? GPIO_PIN_SET : GPIO_PIN_RESET;
+}
+
+/* =========================================================
+ * I2C: AT24C32 (4 KB, 32 byte sayfa)
+ * ========================================================= */
+
+/* Sayfa yazımı çipteki gibi sayfa sınırında başa sarar */
+static void Sim_Eeprom_Write(uint32_t address, const uint8_t *data, uint32_t len)
+{
+	uint32_t pageBase = address & ~(SIM_EEPROM_PAGE_SIZE - 1U) & (SIM_EEPROM_SIZE - 1U);
+
+	for (uint32_t i = 0; i < len; i++)
+	{
+		eeprom[pageBase | ((address + i) & (SIM_EEPROM_PAGE_SIZE - 1U))] = data[i];
+	}
+}
+
+static void Sim_Eeprom_Read(uint32_t address, uint8_t *data, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++)
+	{
+		data[i] = eeprom[(address + i) & (SIM_EEPROM_SIZE - 1U)];
+	}
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Write(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+									uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)DevAddress;
+	(void)MemAddSize;
+	(void)Timeout;
+
+	Sim_Eeprom_Write(MemAddress, pData, Size);
+	hi2c->memAddress = (MemAddress + Size) & (SIM_EEPROM_SIZE - 1U);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Mem_Read(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint16_t MemAddress,
+								   uint16_t MemAddSize, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+	(void)DevAddress;
+	(void)MemAddSize;
+	(void)Timeout;
+
+	Sim_Eeprom_Read(MemAddress, pData, Size);
+	hi2c->memAddress = (MemAddress + Size) & (SIM_EEPROM_SIZE - 1U);
+
+	return HAL_OK;
+}
+
+/* İlk iki byte adres sayacını kurar, kalanı sayfaya yazılır */
+HAL_StatusTypeDef HAL_I2C_Master_Transmit(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+										  uint16_t Size, uint32_t Timeout)
+{
+	uint32_t address;
+
+	(void)DevAddress;
+	(void)Timeout;
+
+	if (Size < 2U)
+	{
+		return HAL_ERROR;
+	}
+
+	address = (((uint32_t)pData[0] << 8) | pData[1]) & (SIM_EEPROM_SIZE - 1U);
+
+	Sim_Eeprom_Write(address, &pData[2], Size - 2U);
+	hi2c->memAddress = (address + Size - 2U) & (SIM_EEPROM_SIZE - 1U);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_Master_Receive(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint8_t *pData,
+										 uint16_t Size, uint32_t Timeout)
+{
+	(void)DevAddress;
+	(void)Timeout;
+
+	Sim_Eeprom_Read(hi2c->memAddress, pData, Size);
+	hi2c->memAddress = (hi2c->memAddress + Size) & (SIM_EEPROM_SIZE - 1U);
+
+	return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_I2C_IsDeviceReady(I2C_HandleTypeDef *hi2c, uint16_t DevAddress, uint32_t Trials,
+										uint32_t Timeout)
+{
+	(void)hi2c;
+	(void)DevAddress;
+	(void)Trials;
+	(void)Timeout;
+
+	return HAL_OK;
+}
+
+/* =========================================================
+ * TIM, RTC, IWDG
+ * ========================================================= */
+HAL_StatusTypeDef HAL_TIM_PWM_Start(TIM_HandleTypeDef *htim, uint32_t Channel)
+{
+	(void)htim;
+	(void)Channel;
+
+	return HAL_OK;
+}
+
+uint32_t HAL_RTCEx_BKUPRead(RTC_HandleTypeDef *hrtc, uint32_t BackupRegister)
+{
+	(void)hrtc;
+
+	return backup[BackupRegister % SIM_BACKUP_COUNT];
+}
+
+void HAL_RTCEx_BKUPWrite(RTC_HandleTypeDef *hrtc, uint32_t BackupRegister, uint32_t Data)
+{
+	(void)hrtc;
+
+	backup[BackupRegister % SIM_BACKUP_COUNT] = Data;
+}
+
+HAL_StatusTypeDef HAL_IWDG_Refresh(IWDG_HandleTypeDef *hiwdg)
+{
+	hiwdg->refreshCount++;
+
+	return HAL_OK;
+}
+
+/* =========================================================
+ * Kesmeler
+ * ========================================================= */
+void Sim_Irq_Poll(void)
+{
+	if (primask || inIrq)
+	{
+		return;
+	}
+
+	inIrq = true;
+
+	/* OTG_HS önceliği FLASH'tan yüksektir (0 / 1), önce o çalışır */
+	if (irqEnabled[OTG_HS_IRQn])
+	{
+		OTG_HS_IRQHandler();
+	}
+
+	for (uint32_t i = 0; i < SIM_FLASH_STEPS_PER_TICK; i++)
+	{
+		Sim_Flash_Tick();
+
+		if ((Sim_Flash_IrqPending() == false) || (irqEnabled[FLASH_IRQn] == false))
+		{
+			break;
+		}
+
+		FLASH_IRQHandler();
+	}
+
+	inIrq = false;
+}
+
+static void Sim_Irq_Signal(int sig)
+{
+	int savedErrno = errno;
+
+	(void)sig;
+	Sim_Irq_Poll();
+
+	errno = savedErrno;
+}
+
+void Sim_Irq_Start(void)
+{
+	struct sigaction 	sa;
+	struct itimerval 	tv;
+	sigset_t 			set;
+
+	memset(&sa, 0, sizeof(sa));
+	sa.sa_handler = Sim_Irq_Signal;
+	sa.sa_flags   = SA_RESTART;
+	sigemptyset(&sa.sa_mask);
+	sigaction(SIGALRM, &sa, NULL);
+
+	/* USB çevre birimi CubeMX init'te açılır (MX_USB_Device_Init) */
+	irqEnabled[OTG_HS_IRQn] = true;
+
+	tv.it_interval.tv_sec  = 0;
+	tv.it_interval.tv_usec = SIM_TICK_US;
+	tv.it_value 		   = tv.it_interval;
+	setitimer(ITIMER_REAL, &tv, NULL);
+
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_UNBLOCK, &set, NULL);
+}
+
+void Sim_Irq_Stop(void)
+{
+	struct itimerval 	tv;
+	sigset_t 			set;
+
+	memset(&tv, 0, sizeof(tv));
+	setitimer(ITIMER_REAL, &tv, NULL);
+
+	/* exec sonrası yeni süreç handler kurulmadan sinyal almamalı */
+	sigemptyset(&set);
+	sigaddset(&set, SIGALRM);
+	sigprocmask(SIG_BLOCK, &set, NULL);
+}
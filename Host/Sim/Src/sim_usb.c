@@ -0,0 +1,101 @@
+/*
+ * sim_usb.c
+ *
+ * USB CDC'nin simülatör karşılığı: host tarafı bir pseudo terminal'dir.
+ * OTG_HS kesmesinde (Sim_Usb_Tick) IN yönündeki transfer pty'ye yazılır,
+ * OUT yönünde gelen byte'lar usbd_cdc_if.c'deki sırayla alınır: önce sonraki
+ * tampon istenir ve kurulur, sonra USB_RXCallback çağrılır. Tampon yoksa
+ * alım durur ve ana döngüdeki CDC_Resume_Receive_HS ile devam eder.
+ */
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "sim.h"
+#include "usbd_cdc_if.h"
+#include "USB_General.h"
+#include "USB_Receive.h"
+#include "USB_Transmit.h"
+
+#define SIM_USB_TX_SIZE			2048U
+
+static int 					usbFd = -1;
+static uint8_t 				*volatile armedBuf;			// Kurulu OUT tamponu, NULL: alım durduruldu
+static uint8_t 				txBuf[SIM_USB_TX_SIZE];
+static volatile uint32_t 	txLen;						// 0: IN endpoint boş
+static uint32_t 			txPos;
+
+void Sim_Usb_Open(int masterFd)
+{
+	usbFd = masterFd;
+	fcntl(usbFd, F_SETFL, fcntl(usbFd, F_GETFL) | O_NONBLOCK);
+
+	/* CDC_Init_HS: ilk OUT transferi ring'in ilk slotuna kurulur */
+	armedBuf = USB_Rx_Get_Init_Buffer();
+}
+
+uint8_t CDC_Transmit_HS(uint8_t *Buf, uint16_t Len)
+{
+	if ((txLen != 0U) || (Len > SIM_USB_TX_SIZE))
+	{
+		return USBD_BUSY;
+	}
+
+	memcpy(txBuf, Buf, Len);
+	txPos = 0U;
+	__sync_synchronize();
+	txLen = Len;
+
+	return USBD_OK;
+}
+
+void CDC_Resume_Receive_HS(uint8_t *Buf)
+{
+	armedBuf = Buf;
+}
+
+void Sim_Usb_Tick(void)
+{
+	ssize_t n;
+
+	if (usbFd < 0)
+	{
+		return;
+	}
+
+	/* IN: transfer bitince TxCplt (sıradaki mesajı bu bağlamda başlatabilir) */
+	if (txLen != 0U)
+	{
+		n = write(usbFd, &txBuf[txPos], txLen - txPos);
+
+		if (n > 0)
+		{
+			txPos += (uint32_t)n;
+		}
+
+		if (txPos == txLen)
+		{
+			txLen = 0U;
+			USB_TxCpltCallback();
+		}
+	}
+
+	/* OUT */
+	if (armedBuf != NULL)
+	{
+		uint8_t *buf = armedBuf;
+		uint32_t rxLen;
+
+		n = read(usbFd, buf, USB_RX_EP_PACKET_SIZE);
+
+		if (n <= 0)
+		{
+			return;
+		}
+
+		rxLen 	 = (uint32_t)n;
+		armedBuf = USB_Rx_Get_Rx_Buffer(rxLen);
+		USB_RXCallback(buf, &rxLen);
+	}
+}
@@ -0,0 +1,139 @@
+/*
+ * bench_flash_write.c
+ *
+ * Flash_Write'ın 1 MB'lık imaj için yaptığı programlama işlemi sayısı,
+ * simülatörün flash modeliyle sayılır (her burst / quad-word bir adımdır).
+ * Karşılaştırma için yalnızca quad-word ile gereken işlem sayısı da yazılır.
+ * Hedefteki süre ölçülmez: bir burst'ün süresi ancak kartta ölçülebilir.
+ *
+ *   bench_flash_write <flash.bin>
+ *
+ * test_meta_journal gibi 32 bit adres alanında çalışır (-no-pie, MAP_32BIT stack).
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "sim.h"
+#include "bootloader_driver.h"
+#include "flash_driver.h"
+#include "test_util.h"
+
+#define BENCH_STACK_SIZE		(256U * 1024U)
+#define IMAGE_SIZE				(1024U * 1024U)
+
+static ucontext_t 			hostCtx;
+static ucontext_t 			benchCtx;
+static int 					result = 1;
+static uint8_t 				image[IMAGE_SIZE + 16U];
+
+void FLASH_IRQHandler(void)
+{
+	Flash_Async_IRQHandler();
+}
+
+void OTG_HS_IRQHandler(void)
+{
+}
+
+static void Fill(uint8_t *dst, uint32_t len, uint32_t erasedEvery)
+{
+	Rand_Seed(0x9E3779B9u);
+
+	for (uint32_t i = 0; i < len; i++)
+	{
+		/* erasedEvery != 0: her erasedEvery KB'lık bloktan biri 0xFF */
+		dst[i] = ((erasedEvery != 0U) && (((i / 1024U) % erasedEvery) == 0U)) ? 0xFFU : (uint8_t)(Rand() | 1U);
+	}
+}
+
+static void Run(const char *name, uint32_t dstOffset, uint32_t srcOffset, uint32_t erasedEvery)
+{
+	uint32_t 		address = SLOT_A_BASE_ADDR + dstOffset;
+	const uint8_t 	*src 	= &image[srcOffset];
+	uint32_t 		ops;
+	uint32_t 		quads 	= 0U;
+
+	Fill(&image[srcOffset], IMAGE_SIZE, erasedEvery);
+
+	if (Flash_EraseRange(SLOT_A_BASE_ADDR, IMAGE_SIZE + FLASH_PAGE_SIZE) != true)
+	{
+		Fail("%s: erase", name);
+	}
+
+	Sim_Flash_SetPowerCut(0U, SIM_CUT_CLEAN, 0U);		// Adım sayacını sıfırlar
+
+	if ((Flash_Write(address, src, IMAGE_SIZE) != true) ||
+		(memcmp((const void *)(uintptr_t)address, src, IMAGE_SIZE) != 0))
+	{
+		Fail("%s: write", name);
+	}
+
+	ops = Sim_Flash_StepCount();
+
+	/* Quad-word yolu da tamamı 0xFF olan quad'ları atlar */
+	for (uint32_t i = 0; i < IMAGE_SIZE; i += 16U)
+	{
+		static const uint8_t erased[16] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+											0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+
+		quads += (memcmp(&src[i], erased, sizeof(erased)) != 0) ? 1U : 0U;
+	}
+
+	printf("%-34s %6u program operations  (quad-word only: %u)\n", name, ops, quads);
+}
+
+static void Bench_Main(void)
+{
+	Run("1 MB, 128 B aligned", 0U, 0U, 0U);
+	Run("1 MB, destination +16 B", 16U, 0U, 0U);
+	Run("1 MB, unaligned source (staged)", 0U, 1U, 0U);
+	Run("1 MB, every 4th KB erased", 0U, 0U, 4U);
+
+	result = 0;
+}
+
+int main(int argc, char **argv)
+{
+	void *stack;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s <flash.bin>\n", argv[0]);
+		return 1;
+	}
+
+	unlink(argv[1]);
+
+	if (Sim_Flash_Open(argv[1]) != true)
+	{
+		return 1;
+	}
+
+	stack = mmap(NULL, BENCH_STACK_SIZE, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT | MAP_STACK, -1, 0);
+
+	if ((stack == MAP_FAILED) || ((uintptr_t)main > 0xFFFFFFFFu))
+	{
+		fprintf(stderr, "bench_flash_write: needs a 32-bit address space (build with -no-pie)\n");
+		return 1;
+	}
+
+	getcontext(&benchCtx);
+	benchCtx.uc_stack.ss_sp 	= stack;
+	benchCtx.uc_stack.ss_size 	= BENCH_STACK_SIZE;
+	benchCtx.uc_link 			= &hostCtx;
+	makecontext(&benchCtx, Bench_Main, 0);
+	swapcontext(&hostCtx, &benchCtx);
+
+	unlink(argv[1]);
+
+	return result;
+}
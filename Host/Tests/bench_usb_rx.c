@@ -0,0 +1,240 @@
+/*
+ * bench_usb_rx.c
+ *
+ * USB RX yolunun saniyedeki frame sayısı: 512 byte'lık OUT transferleri
+ * CDC_Receive_HS sırasıyla ring'e aktarılır, ana döngü frame'leri çıkarıp
+ * doğrular ve hemen havuza geri verir. Ölçülen süre yalnızca alım yolunundur
+ * (host CPU'da; hedefteki mutlak değerleri değil, frame boyutuna göre maliyeti gösterir).
+ *
+ * Aynı transferler baseline'daki on durumlu makineye de (usb_rx_legacy.c) verilir
+ * ve iki frame/s değeri yan yana yazılır. Baseline bir transferde birden fazla
+ * frame'i ve 2 KB'tan büyük frame'i alamadığından her frame ayrı transferlerle
+ * gönderilir (host yazılımının yaptığı gibi); son transfer kısadır.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "USB_Receive.h"
+#include "usbd_cdc_if.h"
+#include "test_util.h"
+
+#define STREAM_MAX			(4u * 1024u * 1024u)
+#define BENCH_MIN_NS		300000000ull
+
+static uint8_t 		stream[STREAM_MAX];
+static uint32_t 	streamLen;
+static uint32_t 	frameLen;
+static uint8_t 		*armedBuf;
+
+/* usb_rx_legacy.c: baseline alım yolu */
+uint32_t Legacy_Rx_Frame_Max(void);
+void Legacy_Rx_Feed(uint8_t *buf, uint32_t len);
+uint32_t Legacy_Rx_Drain(void);
+
+uint8_t CDC_Transmit_HS(uint8_t *Buf, uint16_t Len)
+{
+	(void)Buf;
+	(void)Len;
+	return USBD_OK;
+}
+
+void CDC_Resume_Receive_HS(uint8_t *Buf)
+{
+	armedBuf = Buf;
+}
+
+/* Aynı tip frame'lerle dolu akış; frame sayısını döner */
+static uint32_t BuildStream(uint8_t command, uint16_t len)
+{
+	uint32_t count = 0;
+
+	streamLen = 0;
+	frameLen  = len + USB_OVERHEAD_BYTES;
+
+	while ((streamLen + len + USB_OVERHEAD_BYTES) <= STREAM_MAX)
+	{
+		uint8_t  *f 	 = &stream[streamLen];
+		uint8_t  xorSum = 0;
+
+		f[USB_INDEX_1_HEADER_1] 		= USB_PACKET_HEADER_1;
+		f[USB_INDEX_2_HEADER_2] 		= USB_PACKET_HEADER_2;
+		f[USB_INDEX_3_PACKET_TYPE] 		= USB_PACKET_FIRMWARE_UPDATE;
+		f[USB_INDEX_4_COMMAND_ID] 		= command;
+		f[USB_INDEX_5_PROCESS_TYPE] 	= USB_PACKET_PROCESS_TYPE_WRITE;
+		f[USB_INDEX_6_DATA_LEN_MSB] 	= (uint8_t)(len >> 8);
+		f[USB_INDEX_7_DATA_LEN_LSB] 	= (uint8_t)len;
+
+		for (uint16_t i = 0; i < len; i++)
+		{
+			f[USB_INDEX_DATA_START + i] = (uint8_t)(i * 7u + count);
+		}
+
+		for (uint32_t i = USB_INDEX_3_PACKET_TYPE; i < (uint32_t)(USB_INDEX_DATA_START + len); i++)
+		{
+			xorSum ^= f[i];
+		}
+
+		f[USB_INDEX_DATA_START + len] 		= xorSum;
+		f[USB_INDEX_DATA_START + len + 1u] 	= USB_PACKET_FOOTER_1;
+		f[USB_INDEX_DATA_START + len + 2u] 	= USB_PACKET_FOOTER_2;
+
+		streamLen 	+= len + USB_OVERHEAD_BYTES;
+		count 		+= 1u;
+	}
+
+	return count;
+}
+
+static uint32_t DrainFrames(void)
+{
+	USBRxFrameView_t 	view;
+	uint32_t 			n = 0;
+
+	memset(&view, 0, sizeof(view));
+
+	for (;;)
+	{
+		System_USB_Communication_Receive_Function(&view);
+
+		if (view.valid == 0)
+		{
+			break;
+		}
+
+		USB_Rx_Release_Frame(&view);
+		n += 1u;
+	}
+
+	return n;
+}
+
+/* pos'tan başlayan transferin boyu: en fazla bir endpoint paketi, frame sınırını geçmez */
+static uint32_t TransferLen(uint32_t pos)
+{
+	uint32_t left = frameLen - (pos % frameLen);
+
+	return (left > USB_RX_EP_PACKET_SIZE) ? USB_RX_EP_PACKET_SIZE : left;
+}
+
+/* Akışı bir kez alım yolundan geçirir; teslim edilen frame sayısını döner */
+static uint32_t RunStream(void)
+{
+	uint32_t pos 		= 0;
+	uint32_t frames 	= 0;
+
+	while (pos < streamLen)
+	{
+		uint8_t  *buf;
+		uint32_t len = TransferLen(pos);
+
+		if (armedBuf == NULL)
+		{
+			frames += DrainFrames();
+			continue;
+		}
+
+		buf = armedBuf;
+		memcpy(buf, &stream[pos], len);
+		armedBuf = USB_Rx_Get_Rx_Buffer(len);
+		USB_RXCallback(buf, &len);
+		pos += len;
+
+		/* Hedefteki gibi ana döngü her transferden sonra bir tur döner */
+		frames += DrainFrames();
+	}
+
+	return frames + DrainFrames();
+}
+
+/* Aynı akış baseline makinesinden: frame tamamlanınca bütün durumları işlenir */
+static uint32_t RunLegacyStream(void)
+{
+	static uint8_t 	buf[USB_RX_EP_PACKET_SIZE];
+	uint32_t 		pos 	= 0;
+	uint32_t 		frames 	= 0;
+
+	while (pos < streamLen)
+	{
+		uint32_t len = TransferLen(pos);
+
+		memcpy(buf, &stream[pos], len);
+		Legacy_Rx_Feed(buf, len);
+		pos += len;
+
+		frames += Legacy_Rx_Drain();
+	}
+
+	return frames;
+}
+
+/* Süre BENCH_MIN_NS'i geçene kadar akışı tekrarlar; frame/s döner (0: frame kaybı) */
+static double Measure(uint32_t (*run)(void), uint32_t expected, uint64_t *bytes, uint64_t *ns)
+{
+	uint64_t frames = 0;
+	uint64_t start 	= NowNs();
+
+	*bytes = 0;
+
+	do
+	{
+		if (run() != expected)
+		{
+			return 0.0;
+		}
+
+		frames 	+= expected;
+		*bytes 	+= streamLen;
+		*ns 	 = NowNs() - start;
+	}while (*ns < BENCH_MIN_NS);
+
+	return (double)frames * 1e9 / (double)*ns;
+}
+
+static void Bench(const char *name, uint8_t command, uint16_t len)
+{
+	uint32_t 	expected = BuildStream(command, len);
+	uint64_t 	bytes;
+	uint64_t 	elapsed;
+	double 		rate;
+	double 		legacy;
+
+	rate = Measure(RunStream, expected, &bytes, &elapsed);
+
+	if (rate == 0.0)
+	{
+		Fail("%s: frames lost", name);
+	}
+
+	printf("%-28s %6u B/frame  %10.0f frames/s  %8.1f MB/s", name, (unsigned)frameLen,
+		   rate, (double)bytes * 1e3 / (double)elapsed);
+
+	if (frameLen > Legacy_Rx_Frame_Max())
+	{
+		printf("  (baseline: frame > %u B)\n", Legacy_Rx_Frame_Max());
+		return;
+	}
+
+	legacy = Measure(RunLegacyStream, expected, &bytes, &elapsed);
+
+	if (legacy == 0.0)
+	{
+		Fail("%s: baseline lost frames", name);
+	}
+
+	printf("  baseline %10.0f frames/s  x%.1f\n", legacy, rate / legacy);
+}
+
+int main(void)
+{
+	armedBuf = USB_Rx_Get_Init_Buffer();
+
+	Bench("STATUS_REQ (empty)", USB_FIRMWARE_UPDATE_STATUS_REQ, 0u);
+	Bench("PACKET_INFO (64 B)", USB_FIRMWARE_UPDATE_PACKET_INFO, USB_RX_CONTROL_DATA_LEN_MAX);
+	Bench("SEND_PACKET (1 KB, lean)", USB_FIRMWARE_UPDATE_SEND_PACKET, 1024u);
+	Bench("SEND_PACKET (2 KB, lean)", USB_FIRMWARE_UPDATE_SEND_PACKET, 2048u - USB_OVERHEAD_BYTES);
+	Bench("SEND_PACKET (max, lean)", USB_FIRMWARE_UPDATE_SEND_PACKET, USB_RX_DATA_LEN_MAX);
+
+	return 0;
+}
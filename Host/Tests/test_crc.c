@@ -0,0 +1,216 @@
+/*
+ * test_crc.c
+ *
+ * crc.c'nin yazılım CRC32'si bağımsız bir bit bit referansla karşılaştırılır:
+ * bilinen değerler, rastgele uzunluk ve hizalamalar, Start/Update/Final'a
+ * rastgele bölünmüş akışlar, Combine / CombineWith ve Verify. Makefile aynı
+ * dosyayı her CRC32_IMPL değeri (BITWISE, TABLE, SLICE8) için ayrı derler.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "crc.h"
+#include "test_util.h"
+
+#define BUFFER_SIZE			(80U * 1024U)
+#define MAX_LENGTH			70000U
+#define MAX_OFFSET			16U
+
+static uint8_t 		buffer[BUFFER_SIZE];
+
+static const char 	*implName[] = { "bitwise", "table", "slicing-by-8" };
+
+/* Referans: yansıtılmış polinom, bit bit */
+static uint32_t Reference(const uint8_t *data, uint32_t length)
+{
+	uint32_t crc = 0xFFFFFFFFu;
+
+	for (uint32_t i = 0; i < length; i++)
+	{
+		crc ^= data[i];
+
+		for (uint32_t j = 0; j < 8U; j++)
+		{
+			crc = (crc >> 1) ^ (0xEDB88320u & (0U - (crc & 1U)));
+		}
+	}
+
+	return ~crc;
+}
+
+static void KnownValues(void)
+{
+	static const struct
+	{
+		const char 	*text;
+		uint32_t 	crc;
+	} vectors[] =
+	{
+		{ "", 											0x00000000u },
+		{ "a", 											0xE8B7BE43u },
+		{ "abc", 										0x352441C2u },
+		{ "123456789", 									0xCBF43926u },
+		{ "The quick brown fox jumps over the lazy dog", 	0x414FA339u },
+	};
+
+	for (uint32_t i = 0; i < (sizeof(vectors) / sizeof(vectors[0])); i++)
+	{
+		uint32_t length = (uint32_t)strlen(vectors[i].text);
+
+		if ((CRC32_Calculate((const uint8_t *)vectors[i].text, length) != vectors[i].crc) ||
+			(Reference((const uint8_t *)vectors[i].text, length) != vectors[i].crc))
+		{
+			Fail("%s: length %u, offset %u", vectors[i].text, length, 0U);
+		}
+	}
+
+	/* Tamamı 0x00 / 0xFF olan 32 byte (RFC 3720 B.4) */
+	memset(buffer, 0x00, 32U);
+
+	if (CRC32_Calculate(buffer, 32U) != 0x190A55ADu)
+	{
+		Fail("32 zero bytes: length %u, offset %u", 32U, 0U);
+	}
+
+	memset(buffer, 0xFF, 32U);
+
+	if (CRC32_Calculate(buffer, 32U) != 0xFF6CAB0Bu)
+	{
+		Fail("32 0xFF bytes: length %u, offset %u", 32U, 0U);
+	}
+
+	printf("known values ok\n");
+}
+
+/* Rastgele uzunluk; kaynak hizalaması 0..15 (SLICE8'in 8 byte döngüsü ve kuyruğu) */
+static uint32_t RandomLength(void)
+{
+	switch (Rand() % 4U)
+	{
+		case 0:  return Rand() % 64U;
+		case 1:  return Rand() % 1024U;
+		default: return Rand() % (MAX_LENGTH + 1U);
+	}
+}
+
+static void OneShot(uint32_t rounds)
+{
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t length = RandomLength();
+		uint32_t offset = Rand() % MAX_OFFSET;
+		uint32_t crc 	= CRC32_Calculate(&buffer[offset], length);
+
+		if (crc != Reference(&buffer[offset], length))
+		{
+			Fail("one-shot: length %u, offset %u", length, offset);
+		}
+
+		/* Verify: boş veri her zaman reddedilir, tek bit farkı yakalanır */
+		if ((CRC32_Verify(&buffer[offset], length, crc) != ((length != 0U) ? 1U : 0U)) ||
+			(CRC32_Verify(&buffer[offset], length, crc ^ (1U << (Rand() % 32U))) != 0U))
+		{
+			Fail("verify: length %u, offset %u", length, offset);
+		}
+	}
+
+	printf("%u random lengths and offsets ok\n", rounds);
+}
+
+/* Aynı veri Update'e rastgele parçalarla (boş parçalar dahil) verilir */
+static void Streaming(uint32_t rounds)
+{
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t length = RandomLength();
+		uint32_t offset = Rand() % MAX_OFFSET;
+		uint32_t done 	= 0U;
+		uint32_t crc 	= CRC32_Start();
+
+		while (done < length)
+		{
+			uint32_t left  = length - done;
+			uint32_t chunk = ((Rand() % 8U) == 0U) ? 0U : (1U + (Rand() % (((Rand() & 1U) != 0U) ? 17U : left)));
+
+			chunk = (chunk > left) ? left : chunk;
+			crc   = CRC32_Update(crc, &buffer[offset + done], chunk);
+			done += chunk;
+		}
+
+		if (CRC32_Final(crc) != Reference(&buffer[offset], length))
+		{
+			Fail("streaming: length %u, offset %u", length, offset);
+		}
+	}
+
+	printf("%u random Start/Update/Final splits ok\n", rounds);
+}
+
+/* crc(A || B) == Combine(crc(A), crc(B), len(B)) */
+static void Combine(uint32_t rounds)
+{
+	static const uint32_t blocks[] = { 0U, 1U, 7U, 8U, 64U, 1024U, 4096U, 8192U };
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		uint32_t length = RandomLength();
+		uint32_t offset = Rand() % MAX_OFFSET;
+		uint32_t split 	= (length == 0U) ? 0U : (Rand() % (length + 1U));
+		uint32_t whole 	= Reference(&buffer[offset], length);
+		uint32_t crc1 	= CRC32_Calculate(&buffer[offset], split);
+		uint32_t crc2 	= CRC32_Calculate(&buffer[offset + split], length - split);
+
+		if (CRC32_Combine(crc1, crc2, length - split) != whole)
+		{
+			Fail("combine: length %u, offset %u", length, split);
+		}
+	}
+
+	/* Sabit blok boyu: operatör bir kez kurulur, bütün bloklar aynı operatörle eklenir */
+	for (uint32_t b = 0; b < (sizeof(blocks) / sizeof(blocks[0])); b++)
+	{
+		crc32_combine_t comb;
+		uint32_t 		block = blocks[b];
+		uint32_t 		count = (block == 0U) ? 4U : ((MAX_LENGTH / block < 40U) ? (MAX_LENGTH / block) : 40U);
+		uint32_t 		crc   = CRC32_Calculate(buffer, 0U);
+
+		CRC32_CombineInit(&comb, block);
+
+		if (comb.len != block)
+		{
+			Fail("combine init length: length %u, offset %u", block, 0U);
+		}
+
+		for (uint32_t n = 0; n < count; n++)
+		{
+			crc = CRC32_CombineWith(&comb, crc, CRC32_Calculate(&buffer[n * block], block));
+		}
+
+		if (crc != Reference(buffer, count * block))
+		{
+			Fail("combine with: length %u, offset %u", count * block, block);
+		}
+	}
+
+	printf("%u random combines, %u fixed block sizes ok\n", rounds, (uint32_t)(sizeof(blocks) / sizeof(blocks[0])));
+}
+
+int main(void)
+{
+	Rand_Seed(0x7F4A7C15u);
+	KnownValues();
+
+	for (uint32_t i = 0; i < BUFFER_SIZE; i++)
+	{
+		buffer[i] = (uint8_t)Rand();
+	}
+
+	OneShot(2000U);
+	Streaming(2000U);
+	Combine(500U);
+
+	printf("test_crc (%s): OK\n", implName[CRC32_IMPL]);
+	return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * test_delta_stream.c
+ *
+ * delta_gen ile üretilen patch'ler, bootloader'ın yaptığı gibi delta_stream
+ * üzerinden parça parça uygulanır. Simüle flash'ta iki slot vardır: kaynak
+ * (aktif slot, eski imaj) ve hedef (sayfa sayfa yazılan yeni imaj).
+ *
+ *   test_delta_stream <imaj.bin>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "delta_stream.h"
+#include "delta_gen.h"
+#include "test_util.h"
+
+#define SLOT_SIZE			(512u * 1024u)
+
+static delta_stream_t 		stream;
+static uint8_t 				flash[2][SLOT_SIZE];	/* [0]: kaynak slot, [1]: hedef slot */
+static uint8_t 				base[SLOT_SIZE];
+static uint8_t 				image[SLOT_SIZE];
+static uint8_t 				patch[DELTA_GEN_BOUND(SLOT_SIZE)];
+static delta_gen_stats_t 	total;
+
+static void FlushPage(void)
+{
+	memcpy(&flash[1][stream.pageOffset], stream.page, stream.pageFill);
+	Delta_Stream_NextPage(&stream);
+}
+
+/*
+ * Patch'i chunk'lık parçalarla uygular (0: 1..9000 rastgele)
+ * return: 1 hedef imaj tamamlandı, 0 hata / eksik patch
+ */
+static int Apply(const uint8_t *in, uint32_t inLen, uint32_t sourceLen, uint32_t outLen, uint32_t chunk)
+{
+	uint32_t pos = 0;
+
+	memset(flash[1], 0xFF, SLOT_SIZE);
+	Delta_Stream_Init(&stream, flash[0], sourceLen, outLen);
+
+	while (pos < inLen)
+	{
+		uint32_t n 	 = (chunk != 0u) ? chunk : (1u + Rand() % 9000u);
+		uint32_t off = 0;
+
+		if (n > (inLen - pos))
+		{
+			n = inLen - pos;
+		}
+
+		for (;;)
+		{
+			uint32_t 				used 	= 0;
+			delta_stream_status_t 	status 	= Delta_Stream_Decode(&stream, &in[pos + off], n - off, &used);
+
+			off += used;
+
+			if (status == DELTA_STREAM_ERROR)
+			{
+				return 0;
+			}
+
+			if (status == DELTA_STREAM_NEED_INPUT)
+			{
+				break;
+			}
+
+			FlushPage();
+		}
+
+		pos += n;
+	}
+
+	if (Delta_Stream_IsComplete(&stream) == false)
+	{
+		return 0;
+	}
+
+	if (stream.pageFill != 0u)
+	{
+		FlushPage();
+	}
+
+	return 1;
+}
+
+static void ApplyAll(const char *name, const uint8_t *in, uint32_t inLen, uint32_t sourceLen,
+					 const uint8_t *target, uint32_t outLen)
+{
+	static const uint32_t chunks[] = { 1u, 7u, 64u, 1024u, 9000u, 0u, 0u, 0u };
+
+	for (uint32_t i = 0; i < (sizeof(chunks) / sizeof(chunks[0])); i++)
+	{
+		if ((Apply(in, inLen, sourceLen, outLen, chunks[i]) == 0) || (memcmp(flash[1], target, outLen) != 0))
+		{
+			Fail("%s: chunk %u", name, chunks[i]);
+		}
+
+		/* Kaynak slot patch uygulanırken değişmemeli */
+		if (memcmp(flash[0], base, sourceLen) != 0)
+		{
+			Fail("%s: source slot modified", name);
+		}
+	}
+}
+
+static void GenerateAndApply(const char *name, uint32_t baseLen, const uint8_t *target, uint32_t outLen)
+{
+	delta_gen_stats_t 	st;
+	uint32_t 			patchLen;
+
+	patchLen = (uint32_t)Delta_Gen(base, baseLen, target, outLen, patch, sizeof(patch), &st);
+
+	if ((patchLen == 0u) && (outLen != 0u))
+	{
+		Fail("%s: generator", name);
+	}
+
+	memcpy(flash[0], base, baseLen);
+	ApplyAll(name, patch, patchLen, baseLen, target, outLen);
+
+	total.copyCount += st.copyCount;
+	total.diffCount += st.diffCount;
+	total.dataCount += st.dataCount;
+
+	printf("%-24s %7u B image  %7u B patch  COPY %4u  DIFF %4u  DATA %4u  ok\n",
+		   name, outLen, patchLen, st.copyCount, st.diffCount, st.dataCount);
+}
+
+/* Derlenmiş kodun kayması: araya byte eklenir, sonrasını gösteren flash pointer'ları güncellenir */
+static uint32_t Relocate(const uint8_t *src, uint32_t len, uint32_t at, int32_t delta, uint8_t *dst)
+{
+	uint32_t outLen;
+
+	if (delta >= 0)
+	{
+		memcpy(dst, src, at);
+
+		for (int32_t i = 0; i < delta; i++)
+		{
+			dst[at + (uint32_t)i] = (uint8_t)Rand();
+		}
+
+		memcpy(&dst[at + (uint32_t)delta], &src[at], len - at);
+		outLen = len + (uint32_t)delta;
+	}
+	else
+	{
+		memcpy(dst, src, at);
+		memcpy(&dst[at], &src[at + (uint32_t)(-delta)], len - at - (uint32_t)(-delta));
+		outLen = len - (uint32_t)(-delta);
+	}
+
+	for (uint32_t i = 0; (i + 4u) <= outLen; i += 4u)
+	{
+		uint32_t w;
+
+		memcpy(&w, &dst[i], sizeof(w));
+
+		if (((w & 0xFFF00000u) == 0x08000000u) && ((w & 0x000FFFFFu) > at))
+		{
+			w = (uint32_t)((int32_t)w + delta);
+			memcpy(&dst[i], &w, sizeof(w));
+		}
+	}
+
+	return outLen;
+}
+
+static void NegativeCases(uint32_t baseLen)
+{
+	static const uint8_t badOp[] 		= { 0x03u, 0x04u, 0x00u, 0x00u, 0x00u };
+	static const uint8_t dataOnly[] 	= { DELTA_OP_DATA, 0x04u, 0x00u, 0x00u, 0x00u, 1u, 2u, 3u, 4u };
+	uint8_t 			 badSource[9] 	= { DELTA_OP_COPY, 0x10u, 0x00u, 0x00u, 0x00u };
+
+	badSource[5] = (uint8_t)(baseLen - 8u);
+	badSource[6] = (uint8_t)((baseLen - 8u) >> 8);
+	badSource[7] = (uint8_t)((baseLen - 8u) >> 16);
+	badSource[8] = (uint8_t)((baseLen - 8u) >> 24);
+
+	if ((Apply(badOp, sizeof(badOp), baseLen, 4u, 1u) != 0) ||
+		(Apply(badSource, sizeof(badSource), baseLen, 16u, 1u) != 0) ||
+		(Apply(dataOnly, sizeof(dataOnly), baseLen, 3u, 0u) != 0) ||
+		(Apply(dataOnly, sizeof(dataOnly), baseLen, 5u, 0u) != 0) ||
+		(Apply(dataOnly, sizeof(dataOnly) - 1u, baseLen, 4u, 0u) != 0))
+	{
+		Fail("corrupt patch accepted");
+	}
+
+	printf("%-24s ok\n", "corrupt patches rejected");
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t 	baseLen;
+	uint32_t 	len;
+
+	Rand_Seed(0x9E3779B9u);
+
+	if (argc < 2)
+	{
+		printf("usage: %s <image.bin>\n", argv[0]);
+		return 2;
+	}
+
+	baseLen = ReadFile(argv[1], base, SLOT_SIZE / 2u);
+
+	GenerateAndApply("identical", baseLen, base, baseLen);
+
+	memcpy(image, base, baseLen);
+	for (uint32_t i = 0; i < 100u; i++)
+	{
+		image[Rand() % baseLen] ^= (uint8_t)(1u + Rand() % 255u);
+	}
+	GenerateAndApply("sparse byte changes", baseLen, image, baseLen);
+
+	len = Relocate(base, baseLen, baseLen / 3u, 1500, image);
+	GenerateAndApply("insert + relocate", baseLen, image, len);
+
+	len = Relocate(base, baseLen, baseLen / 2u, -3000, image);
+	GenerateAndApply("delete + relocate", baseLen, image, len);
+
+	memcpy(image, base, baseLen);
+	memset(&image[baseLen], 0xA5, 20000u);
+	GenerateAndApply("grown image", baseLen, image, baseLen + 20000u);
+
+	GenerateAndApply("truncated image", baseLen, base, baseLen / 2u);
+
+	for (uint32_t i = 0; i < 50000u; i++)
+	{
+		image[i] = (uint8_t)Rand();
+	}
+	GenerateAndApply("unrelated image", baseLen, image, 50000u);
+
+	GenerateAndApply("empty image", baseLen, image, 0u);
+
+	if ((total.copyCount == 0u) || (total.diffCount == 0u) || (total.dataCount == 0u))
+	{
+		Fail("not every record type was exercised");
+	}
+
+	NegativeCases(baseLen);
+
+	printf("test_delta_stream: OK\n");
+
+	return 0;
+}
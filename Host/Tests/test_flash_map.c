@@ -0,0 +1,174 @@
+/*
+ * test_flash_map.c
+ *
+ * Flash_MapRange'in bank / sayfa geometrisi: bank sınırını geçen aralıklar,
+ * flash dışı aralıklar ve SWAP_BANK set iken fiziksel bank seçimi. Sabit
+ * durumların yanında rastgele aralıklar bağımsız bir modelle karşılaştırılır.
+ * Option byte simülatörün flash modelindeki OPTR'den okunur (flash dosyası açılmaz).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "main.h"
+#include "sim.h"
+#include "flash_driver.h"
+#include "test_util.h"
+
+#define PAGES_TOTAL			(2U * FLASH_PAGE_NB)
+
+typedef struct
+{
+	uint32_t 			address;
+	uint32_t 			length;
+	uint8_t 			count;
+	flash_page_span_t 	spans[FLASH_MAX_PAGE_SPANS];		// SWAP_BANK = 0 iken
+}map_case_t;
+
+static const map_case_t cases[] =
+{
+	/* Bank 1 */
+	{ 0x08000000U, 1U, 				1U, { { FLASH_BANK_1, 0U, 1U } } },
+	{ 0x08001FFFU, 2U, 				1U, { { FLASH_BANK_1, 0U, 2U } } },
+	{ 0x08040000U, 0x1C0000U, 		1U, { { FLASH_BANK_1, 32U, 224U } } },
+	{ 0x081FFFFFU, 1U, 				1U, { { FLASH_BANK_1, 255U, 1U } } },
+
+	/* Bank 2 */
+	{ 0x08200000U, 0x1C0000U, 		1U, { { FLASH_BANK_2, 0U, 224U } } },
+	{ 0x083C0000U, 0x40000U, 		1U, { { FLASH_BANK_2, 224U, 32U } } },
+	{ 0x083FFFFFU, 1U, 				1U, { { FLASH_BANK_2, 255U, 1U } } },
+
+	/* Bank sınırını geçen */
+	{ 0x081FFFFFU, 2U, 				2U, { { FLASH_BANK_1, 255U, 1U }, { FLASH_BANK_2, 0U, 1U } } },
+	{ 0x081FE000U, 0x4000U, 		2U, { { FLASH_BANK_1, 255U, 1U }, { FLASH_BANK_2, 0U, 1U } } },
+	{ 0x08100000U, 0x200000U, 		2U, { { FLASH_BANK_1, 128U, 128U }, { FLASH_BANK_2, 0U, 128U } } },
+	{ 0x08000000U, FLASH_SIZE, 		2U, { { FLASH_BANK_1, 0U, 256U }, { FLASH_BANK_2, 0U, 256U } } },
+
+	/* Flash dışı / geçersiz */
+	{ 0x08000000U, 0U, 				0U, { { 0U } } },
+	{ 0x07FFFFFFU, 2U, 				0U, { { 0U } } },
+	{ 0x08400000U, 1U, 				0U, { { 0U } } },
+	{ 0x083FF000U, 0x2000U, 		0U, { { 0U } } },
+	{ 0x08000000U, FLASH_SIZE + 1U, 0U, { { 0U } } },
+	{ 0x08000010U, 0xFFFFFFF0U, 	0U, { { 0U } } },
+	{ 0xFFFFE000U, 0x2000U, 		0U, { { 0U } } },
+};
+
+/* Test sim_hal.c'nin kesme bağlamını kullanmaz */
+void FLASH_IRQHandler(void)
+{
+}
+
+void OTG_HS_IRQHandler(void)
+{
+}
+
+static void SetSwap(bool swapped)
+{
+	Sim_FLASH.OPTR = swapped ? FLASH_OPTR_SWAP_BANK : 0U;
+}
+
+static uint32_t Physical(uint32_t bank, bool swapped)
+{
+	return (swapped == false) ? bank : ((bank == FLASH_BANK_1) ? FLASH_BANK_2 : FLASH_BANK_1);
+}
+
+static void Fixed(bool swapped)
+{
+	SetSwap(swapped);
+
+	for (uint32_t i = 0; i < (sizeof(cases) / sizeof(cases[0])); i++)
+	{
+		const map_case_t 	*c = &cases[i];
+		flash_page_span_t 	spans[FLASH_MAX_PAGE_SPANS];
+		uint8_t 			count;
+
+		memset(spans, 0xA5, sizeof(spans));
+		count = Flash_MapRange(c->address, c->length, spans);
+
+		if (count != c->count)
+		{
+			Fail("span count: 0x%08X + 0x%X%s", c->address, c->length, swapped ? " (swapped)" : "");
+		}
+
+		for (uint8_t s = 0; s < count; s++)
+		{
+			if ((spans[s].bank != Physical(c->spans[s].bank, swapped)) ||
+				(spans[s].page != c->spans[s].page) || (spans[s].nbPages != c->spans[s].nbPages))
+			{
+				Fail("span: 0x%08X + 0x%X%s", c->address, c->length, swapped ? " (swapped)" : "");
+			}
+		}
+	}
+}
+
+/* Rastgele aralık: parçalar [ilk, son] sayfalarını sırayla, bank başına bir parçayla kapsamalı */
+static void Random(bool swapped, uint32_t rounds)
+{
+	SetSwap(swapped);
+
+	for (uint32_t i = 0; i < rounds; i++)
+	{
+		flash_page_span_t 	spans[FLASH_MAX_PAGE_SPANS];
+		uint32_t 			offset 	= Rand() % FLASH_SIZE;
+		uint32_t 			length 	= 1U + ((Rand() & 1U) ? (Rand() % (FLASH_SIZE - offset)) : (Rand() % 0x6000U));
+		uint32_t 			address = FLASH_BASE + offset;
+		uint32_t 			page 	= offset / FLASH_PAGE_SIZE;
+		uint32_t 			last 	= (offset + length - 1U) / FLASH_PAGE_SIZE;
+		uint8_t 			count;
+
+		count = Flash_MapRange(address, length, spans);
+
+		if (last >= PAGES_TOTAL)
+		{
+			if (count != 0U)
+			{
+				Fail("range past the end accepted: 0x%08X + 0x%X%s", address, length, swapped ? " (swapped)" : "");
+			}
+
+			continue;
+		}
+
+		if ((count == 0U) || (count > FLASH_MAX_PAGE_SPANS))
+		{
+			Fail("span count: 0x%08X + 0x%X%s", address, length, swapped ? " (swapped)" : "");
+		}
+
+		for (uint8_t s = 0; s < count; s++)
+		{
+			uint32_t logicalBank = (page < FLASH_PAGE_NB) ? FLASH_BANK_1 : FLASH_BANK_2;
+
+			if ((spans[s].bank != Physical(logicalBank, swapped)) ||
+				(spans[s].page != (page % FLASH_PAGE_NB)) ||
+				(spans[s].nbPages == 0U) ||
+				((spans[s].page + spans[s].nbPages) > FLASH_PAGE_NB))
+			{
+				Fail("random span: 0x%08X + 0x%X%s", address, length, swapped ? " (swapped)" : "");
+			}
+
+			page += spans[s].nbPages;
+		}
+
+		if (page != (last + 1U))
+		{
+			Fail("pages not covered: 0x%08X + 0x%X%s", address, length, swapped ? " (swapped)" : "");
+		}
+	}
+}
+
+int main(void)
+{
+	Fixed(false);
+	Fixed(true);
+	printf("%u fixed ranges ok (unswapped, swapped)\n", (unsigned)(sizeof(cases) / sizeof(cases[0])));
+
+	Rand_Seed(0x2545F491u);
+
+	Random(false, 200000U);
+	Random(true, 200000U);
+	printf("400000 random ranges ok\n");
+
+	printf("test_flash_map: OK\n");
+	return 0;
+}
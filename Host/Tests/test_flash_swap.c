@@ -0,0 +1,213 @@
+/*
+ * test_flash_swap.c
+ *
+ * SWAP_BANK adres takası simülatörün flash modeliyle sınanır: option byte
+ * yazılıp yüklendikten (reset) sonra mantıksal adresler diğer fiziksel banka
+ * düşer. Okuma, programlama, tek sayfa ve bank sınırını geçen silme fiziksel
+ * dosya düzeniyle karşılaştırılır; bank swap boot'taki metadata devri
+ * (META_MIRROR_FLASH_ADDR'e yazılan kayıt swap sonrası META_FLASH_ADDR'de)
+ * uçtan uca denenir.
+ *
+ *   test_flash_swap <flash.bin>
+ *
+ * Flash_Write'a verilen tamponlar statiktir (-no-pie: düşük adres).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "sim.h"
+#include "bootloader_driver.h"
+#include "bootloader_metadata.h"
+#include "flash_driver.h"
+#include "test_util.h"
+
+#define BLOCK_SIZE				FLASH_PAGE_SIZE
+
+static uint8_t 				block[4][BLOCK_SIZE];
+static meta_record_t 		record;
+static uint32_t 			resets;
+
+/* Test sim_hal.c'nin kesme bağlamını kullanmaz */
+void FLASH_IRQHandler(void)
+{
+	Flash_Async_IRQHandler();
+}
+
+void OTG_HS_IRQHandler(void)
+{
+}
+
+/* Option byte yüklemesi: reset'in flash'a etkisi (option byte'lar okunur, banklar yeniden map'lenir) */
+static void Reset(void)
+{
+	Sim_Flash_Reload();
+	resets += 1U;
+}
+
+static void Check(bool ok, const char *what)
+{
+	if (ok == false)
+	{
+		Fail("%s", what);
+	}
+}
+
+static bool IsErased(const uint8_t *p, uint32_t len)
+{
+	for (uint32_t i = 0; i < len; i++)
+	{
+		if (p[i] != 0xFFU)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Mantıksal adres (SWAP_BANK = 0 haritası) -> fiziksel dosya byte'ları */
+static const uint8_t *Physical(uint32_t bank, uint32_t offset)
+{
+	return &Sim_Flash_Physical()[(bank * FLASH_BANK_SIZE) + offset];
+}
+
+static void Program(uint32_t address, const uint8_t *data)
+{
+	Check(Flash_EraseRange(address, BLOCK_SIZE) == true, "erase");
+	Check(Flash_Write(address, data, BLOCK_SIZE) == true, "program");
+}
+
+static void Swap(bool swapped)
+{
+	uint32_t before = resets;
+
+	(void)Flash_SetBankSwap(swapped);
+
+	Check(resets == (before + 1U), "option byte launch did not reset");
+	Check(Flash_IsBankSwapped() == swapped, "SWAP_BANK after reset");
+}
+
+static void Aliasing(void)
+{
+	uint32_t slotOffset = SLOT_A_BASE_ADDR - FLASH_BASE;
+
+	/* SWAP_BANK = 0: mantıksal = fiziksel */
+	Program(FLASH_BASE + slotOffset, block[0]);
+	Program(FLASH_BASE + FLASH_BANK_SIZE + slotOffset, block[1]);
+
+	Check(memcmp(Physical(0U, slotOffset), block[0], BLOCK_SIZE) == 0, "bank 1 physical");
+	Check(memcmp(Physical(1U, slotOffset), block[1], BLOCK_SIZE) == 0, "bank 2 physical");
+
+	/* SWAP_BANK = 1: aynı mantıksal adres diğer banktan okur */
+	Swap(true);
+
+	Check(memcmp((const void *)(uintptr_t)(FLASH_BASE + slotOffset), block[1], BLOCK_SIZE) == 0,
+		  "swapped read of bank 1 address");
+	Check(memcmp((const void *)(uintptr_t)(FLASH_BASE + FLASH_BANK_SIZE + slotOffset), block[0], BLOCK_SIZE) == 0,
+		  "swapped read of bank 2 address");
+
+	/* Silme ve programlama mantıksal adresin o anki fiziksel bankına gider */
+	Check(Flash_Erase(FLASH_BASE + slotOffset) == true, "swapped erase");
+	Check(IsErased(Physical(1U, slotOffset), BLOCK_SIZE), "swapped erase hit the wrong bank");
+	Check(memcmp(Physical(0U, slotOffset), block[0], BLOCK_SIZE) == 0, "swapped erase touched the other bank");
+
+	Check(Flash_Write(FLASH_BASE + slotOffset, block[2], BLOCK_SIZE) == true, "swapped program");
+	Check(memcmp(Physical(1U, slotOffset), block[2], BLOCK_SIZE) == 0, "swapped program hit the wrong bank");
+
+	/* Bank sınırını geçen silme: mantıksal bank 1'in son sayfası + bank 2'nin ilk sayfası */
+	Check(Flash_Write(FLASH_BASE + FLASH_BANK_SIZE - BLOCK_SIZE, block[3], BLOCK_SIZE) == true, "program bank 1 end");
+	Check(Flash_Write(FLASH_BASE + FLASH_BANK_SIZE, block[3], BLOCK_SIZE) == true, "program bank 2 start");
+	Check(memcmp(Physical(1U, FLASH_BANK_SIZE - BLOCK_SIZE), block[3], BLOCK_SIZE) == 0, "bank 1 end physical");
+	Check(memcmp(Physical(0U, 0U), block[3], BLOCK_SIZE) == 0, "bank 2 start physical");
+
+	Check(Flash_EraseRange(FLASH_BASE + FLASH_BANK_SIZE - BLOCK_SIZE, 2U * BLOCK_SIZE) == true, "spanning erase");
+	Check(IsErased(Physical(1U, FLASH_BANK_SIZE - BLOCK_SIZE), BLOCK_SIZE) &&
+		  IsErased(Physical(0U, 0U), BLOCK_SIZE), "spanning erase missed a page");
+	Check(memcmp(Physical(0U, slotOffset), block[0], BLOCK_SIZE) == 0 &&
+		  memcmp(Physical(1U, slotOffset), block[2], BLOCK_SIZE) == 0, "spanning erase touched other pages");
+
+	/* Option byte kalıcıdır: güç kesilip açılınca takas sürer, geri alınınca eski harita döner */
+	Sim_Flash_Reload();
+	Check(Flash_IsBankSwapped() == true, "SWAP_BANK lost on power cycle");
+
+	Swap(false);
+
+	Check(memcmp((const void *)(uintptr_t)(FLASH_BASE + slotOffset), block[0], BLOCK_SIZE) == 0 &&
+		  memcmp((const void *)(uintptr_t)(FLASH_BASE + FLASH_BANK_SIZE + slotOffset), block[2], BLOCK_SIZE) == 0,
+		  "unswapped map after toggling back");
+
+	printf("aliasing: read, program, page and bank-spanning erase ok\n");
+}
+
+/* BL_BankSwap_Prepare: swap sonrası geçerli kayıt diğer bankın metadata alanına yazılır */
+static void MetadataHandoff(bool swapped)
+{
+	meta_record_t m;
+
+	Check(Flash_EraseRange(META_FLASH_ADDR, BL_META_SIZE_BYTES) == true, "erase metadata");
+	Check(Flash_EraseRange(META_MIRROR_FLASH_ADDR, BL_META_SIZE_BYTES) == true, "erase mirror");
+
+	memset(&record, 0, sizeof(record));
+	record.magic 		= META_MAGIC;
+	record.seq 			= 10U;
+	record.active_slot 	= META_SLOT_B;
+	record.target_slot 	= META_SLOT_A;
+	record.update_state = META_UPDATE_IDLE;
+	Check(Meta_Write(&record) == true, "metadata write");
+
+	record.seq 				  += 1U;
+	record.active_slot 		   = META_SLOT_A;
+	record.target_slot 		   = META_SLOT_B;
+	record.slotA.valid 		   = 1U;
+	record.slotA.fw.size_bytes = 0x12345U;
+	Check(Meta_WriteAt(META_MIRROR_FLASH_ADDR, &record) == true, "mirror write");
+
+	/* Swap öncesi: geçerli kayıt değişmedi */
+	Check((Meta_Read(&m) == true) && (m.seq == 10U) && (m.active_slot == META_SLOT_B), "record before the swap");
+
+	Swap(!swapped);
+
+	Check((Meta_Read(&m) == true) && (m.seq == 11U) && (m.active_slot == META_SLOT_A) &&
+		  (m.slotA.fw.size_bytes == 0x12345U), "mirror record after the swap");
+
+	printf("metadata handoff %s ok\n", swapped ? "back to unswapped" : "to swapped");
+}
+
+int main(int argc, char **argv)
+{
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s <flash.bin>\n", argv[0]);
+		return 1;
+	}
+
+	unlink(argv[1]);
+
+	if (Sim_Flash_Open(argv[1]) != true)
+	{
+		return 1;
+	}
+
+	Sim_Hooks.reset = Reset;
+
+	for (uint32_t i = 0; i < 4U; i++)
+	{
+		for (uint32_t j = 0; j < BLOCK_SIZE; j++)
+		{
+			block[i][j] = (uint8_t)((j * 31U) + (i * 7U) + 1U);
+		}
+	}
+
+	Aliasing();
+	MetadataHandoff(false);
+	MetadataHandoff(true);
+
+	unlink(argv[1]);
+
+	printf("test_flash_swap: OK\n");
+	return 0;
+}
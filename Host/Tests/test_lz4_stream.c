@@ -0,0 +1,237 @@
+/*
+ * test_lz4_stream.c
+ *
+ * lz4_stream round-trip testi: imaj ham LZ4 block olarak sıkıştırılır ve
+ * bootloader'ın yaptığı gibi parça parça açılıp simüle flash'a sayfa sayfa
+ * yazılır. Geri referanslar simüle flash'tan (history) okunur.
+ *
+ *   test_lz4_stream <imaj.bin> [imaj.bin.lz4]
+ *
+ * İkinci argüman lz4 aracının ürettiği frame'dir (-B7 --no-frame-crc); içindeki
+ * tek block çıkarılıp referans sıkıştırıcının çıktısı da aynı şekilde açılır.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "lz4_stream.h"
+#include "lz4_block.h"
+#include "test_util.h"
+
+#define IMAGE_MAX			(1024u * 1024u)
+
+static lz4_stream_t 	stream;
+static uint8_t 			flash[IMAGE_MAX];
+static uint8_t 			image[IMAGE_MAX];
+static uint8_t 			packed[LZ4_BLOCK_BOUND(IMAGE_MAX)];
+
+/* Sayfa tamponunu flash'a yazar (bootloader'da BL_Target_WriteAsync) */
+static void FlushPage(void)
+{
+	memcpy(&flash[stream.pageOffset], stream.page, stream.pageFill);
+	LZ4_Stream_NextPage(&stream);
+}
+
+/*
+ * chunk > 0: sabit parça boyutu, chunk == 0: 1..9000 arası rastgele parçalar
+ * return: 1 imaj birebir elde edildi, 0 hata / eksik akış
+ */
+static int Decode(const uint8_t *in, uint32_t inLen, uint32_t outLen, uint32_t chunk)
+{
+	uint32_t pos = 0;
+
+	memset(flash, 0xFF, outLen);
+	LZ4_Stream_Init(&stream, flash, outLen);
+
+	while (pos < inLen)
+	{
+		uint32_t n = (chunk != 0u) ? chunk : (1u + Rand() % 9000u);
+		uint32_t off = 0;
+
+		if (n > (inLen - pos))
+		{
+			n = inLen - pos;
+		}
+
+		/* Bir parça birden fazla sayfa doldurabilir */
+		for (;;)
+		{
+			uint32_t 			used 	= 0;
+			lz4_stream_status_t status 	= LZ4_Stream_Decode(&stream, &in[pos + off], n - off, &used);
+
+			off += used;
+
+			if (status == LZ4_STREAM_ERROR)
+			{
+				return 0;
+			}
+
+			if (status == LZ4_STREAM_NEED_INPUT)
+			{
+				break;
+			}
+
+			FlushPage();
+		}
+
+		pos += n;
+	}
+
+	if (LZ4_Stream_IsComplete(&stream) == false)
+	{
+		return 0;
+	}
+
+	if (stream.pageFill != 0u)
+	{
+		FlushPage();
+	}
+
+	return 1;
+}
+
+static void RoundTrip(const char *name, const uint8_t *in, uint32_t inLen, const uint8_t *ref, uint32_t outLen)
+{
+	static const uint32_t chunks[] = { 1u, 7u, 64u, 1024u, 9000u, 0u, 0u, 0u };
+
+	for (uint32_t i = 0; i < (sizeof(chunks) / sizeof(chunks[0])); i++)
+	{
+		if ((Decode(in, inLen, outLen, chunks[i]) == 0) || (memcmp(flash, ref, outLen) != 0))
+		{
+			Fail("%s: chunk %u", name, chunks[i]);
+		}
+	}
+
+	printf("%-26s %7u -> %7u bytes  ok\n", name, outLen, inLen);
+}
+
+static void CompressAndCheck(const char *name, const uint8_t *src, uint32_t len)
+{
+	uint32_t packedLen = (uint32_t)LZ4_Block_Compress(src, len, packed, sizeof(packed));
+
+	if ((packedLen == 0u) && (len != 0u))
+	{
+		Fail("%s: compressor", name);
+	}
+
+	RoundTrip(name, packed, packedLen, src, len);
+}
+
+/* Bozuk / eksik akışlar tamamlanmış sayılmamalı */
+static void NegativeCases(const uint8_t *src, uint32_t len)
+{
+	uint32_t packedLen = (uint32_t)LZ4_Block_Compress(src, len, packed, sizeof(packed));
+
+	if (Decode(packed, packedLen - 1u, len, 0u) != 0)
+	{
+		Fail("truncated stream accepted");
+	}
+
+	if (Decode(packed, packedLen, len - 1u, 0u) != 0)
+	{
+		Fail("stream longer than the expected size accepted");
+	}
+
+	/* İlk eşleşmeden önce offset: üretilmemiş veriye referans */
+	{
+		static const uint8_t badOffset[] = { 0x10u, 0x41u, 0x05u, 0x00u };
+
+		if (Decode(badOffset, sizeof(badOffset), 64u, 1u) != 0)
+		{
+			Fail("offset before the start accepted");
+		}
+	}
+
+	printf("%-26s ok\n", "corrupt streams rejected");
+}
+
+/* lz4 frame'inden tek block'u çıkarır: magic, FLG, BD, [içerik boyutu], HC, block */
+static uint32_t ExtractFrameBlock(uint8_t *frame, uint32_t frameLen, uint8_t **block)
+{
+	uint32_t 	pos;
+	uint32_t 	blockSize;
+	uint8_t 	flg;
+
+	if ((frameLen < 11u) || (frame[0] != 0x04u) || (frame[1] != 0x22u) || (frame[2] != 0x4Du) || (frame[3] != 0x18u))
+	{
+		Fail("not an LZ4 frame");
+	}
+
+	flg = frame[4];
+	pos = 6u + (((flg & 0x08u) != 0u) ? 8u : 0u) + (((flg & 0x01u) != 0u) ? 4u : 0u) + 1u;
+
+	blockSize = (uint32_t)frame[pos] | ((uint32_t)frame[pos + 1u] << 8) |
+				((uint32_t)frame[pos + 2u] << 16) | ((uint32_t)frame[pos + 3u] << 24);
+
+	if ((blockSize & 0x80000000u) != 0u)
+	{
+		Fail("reference block stored uncompressed");
+	}
+
+	*block = &frame[pos + 4u];
+
+	return blockSize;
+}
+
+int main(int argc, char **argv)
+{
+	static uint8_t 	big[IMAGE_MAX];
+	static uint8_t 	frame[LZ4_BLOCK_BOUND(IMAGE_MAX) + 64u];
+	uint32_t 		len;
+	uint32_t 		bigLen = 0;
+
+	Rand_Seed(0x1234567u);
+
+	if (argc < 2)
+	{
+		printf("usage: %s <image.bin> [image.bin.lz4]\n", argv[0]);
+		return 2;
+	}
+
+	len = ReadFile(argv[1], image, sizeof(image));
+
+	CompressAndCheck("firmware image", image, len);
+
+	/* 64 KB penceresinden büyük imaj: değiştirilmiş kopyalar arka arkaya */
+	while ((bigLen + len) <= (256u * 1024u))
+	{
+		memcpy(&big[bigLen], image, len);
+
+		for (uint32_t i = 0; i < 64u; i++)
+		{
+			big[bigLen + (Rand() % len)] = (uint8_t)Rand();
+		}
+
+		bigLen += len;
+	}
+
+	CompressAndCheck("firmware x4, patched", big, bigLen);
+
+	memset(big, 0, 100000u);
+	CompressAndCheck("zeros (overlapping match)", big, 100000u);
+
+	for (uint32_t i = 0; i < 20000u; i++)
+	{
+		big[i] = (uint8_t)Rand();
+	}
+
+	CompressAndCheck("random (long literals)", big, 20000u);
+	CompressAndCheck("empty", big, 0u);
+	CompressAndCheck("short", image, 11u);
+
+	NegativeCases(image, len);
+
+	if (argc > 2)
+	{
+		uint8_t  *block;
+		uint32_t frameLen 	= ReadFile(argv[2], frame, sizeof(frame));
+		uint32_t blockLen 	= ExtractFrameBlock(frame, frameLen, &block);
+
+		RoundTrip("reference lz4 block", block, blockLen, image, len);
+	}
+
+	printf("test_lz4_stream: OK\n");
+
+	return 0;
+}
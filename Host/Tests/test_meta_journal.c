@@ -0,0 +1,307 @@
+/*
+ * test_meta_journal.c
+ *
+ * Metadata journal'ı simülatörün flash modeliyle sınanır: eski sürüm (1, 2)
+ * kayıtların taşınması, sayfa geçişleri ve alanın başa dönmesi, her flash
+ * adımında kesilen güç (temiz ve yarım). Kesinti bir çocuk süreçte yapılır;
+ * sonrasında okunan kayıt ya bir önceki ya da yeni yazılan kayıt olmalıdır.
+ *
+ *   test_meta_journal <flash.bin>
+ *
+ * bl_sim gibi 32 bit adres alanında çalışır (Flash_Write veri pointer'ını
+ * uint32_t olarak taşır): -no-pie ile derlenir, test gövdesi MAP_32BIT
+ * stack'te çalışır.
+ */
+
+#define _GNU_SOURCE
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <ucontext.h>
+#include <unistd.h>
+
+#include "main.h"
+#include "sim.h"
+#include "bootloader_driver.h"
+#include "bootloader_metadata.h"
+#include "flash_driver.h"
+#include "test_util.h"
+
+#define TEST_STACK_SIZE			(1024U * 1024U)
+#define JOURNAL_RECORDS			(META_JOURNAL_PAGES * META_RECORDS_PER_PAGE)
+
+/* Sürüm 2 kaydı (bootloader_metadata.c'deki meta_record_v2_t ile aynı düzen) */
+typedef struct
+{
+	uint32_t 			magic;
+	uint32_t 			seq;
+	uint32_t 			crc;
+	meta_slot_t 		active_slot;
+	meta_slot_t 		target_slot;
+	meta_update_state_t update_state;
+	uint32_t 			progress_bytes;
+	uint32_t 			progress_crc32;
+	meta_slot_info_t 	slotA;
+	meta_slot_info_t 	slotB;
+}legacy_record_t;
+
+static ucontext_t 			hostCtx;
+static ucontext_t 			testCtx;
+static const char 			*flashPath;
+static int 					result = 1;
+static uint32_t 			marker;				// Son başarılı yazmanın progress_bytes değeri
+static uint32_t 			cuts;
+
+/* Test sim_hal.c'nin kesme bağlamını kullanmaz */
+void FLASH_IRQHandler(void)
+{
+	Flash_Async_IRQHandler();
+}
+
+void OTG_HS_IRQHandler(void)
+{
+}
+
+static void EraseJournal(void)
+{
+	if (Flash_EraseRange(META_FLASH_ADDR, BL_META_SIZE_BYTES) != true)
+	{
+		Fail("erase metadata");
+	}
+
+	marker = 0U;
+}
+
+static void Record(meta_record_t *m, uint32_t progress)
+{
+	memset(m, 0, sizeof(*m));
+
+	m->magic 			= META_MAGIC;
+	m->seq 				= 1U;
+	m->active_slot 		= META_SLOT_A;
+	m->target_slot 		= META_SLOT_B;
+	m->update_state 	= META_UPDATE_IN_PROGRESS;
+	m->progress_bytes 	= progress;
+	m->progress_crc32 	= ~progress;
+}
+
+static void Expect(uint32_t progress, const char *what)
+{
+	meta_record_t m;
+
+	if ((Meta_Read(&m) != true) || (m.progress_bytes != progress) || (m.progress_crc32 != ~progress) ||
+		(m.version != META_RECORD_VERSION))
+	{
+		Fail("%s (%u)", what, progress);
+	}
+}
+
+static void Append(uint32_t count)
+{
+	meta_record_t m;
+
+	for (uint32_t i = 0; i < count; i++)
+	{
+		Record(&m, marker + 1U);
+
+		if (Meta_Write(&m) != true)
+		{
+			Fail("write (%u)", marker + 1U);
+		}
+
+		marker += 1U;
+		Expect(marker, "read back");
+	}
+}
+
+/* Eski sürüm kayıt alanın başında: Meta_Init okur, journal'a taşır */
+static void Migration(uint32_t size)
+{
+	legacy_record_t old;
+	meta_record_t 	m;
+	uint8_t 		raw[sizeof(old)];
+
+	EraseJournal();
+
+	memset(&old, 0, sizeof(old));
+	old.magic 			= META_MAGIC;
+	old.seq 			= 7U;
+	old.active_slot 	= META_SLOT_A;
+	old.target_slot 	= META_SLOT_B;
+	old.update_state 	= META_UPDATE_IN_PROGRESS;
+	old.progress_bytes 	= 0x10000U;
+	old.progress_crc32 	= 0x12345678U;
+	old.slotB.fw.size_bytes = 0x20000U;
+
+	/* Sürüm 1'de progress_crc32 yok: slotA / slotB dört byte önde */
+	memcpy(raw, &old, sizeof(old));
+
+	if (size != sizeof(old))
+	{
+		memmove(&raw[offsetof(legacy_record_t, progress_crc32)], &raw[offsetof(legacy_record_t, slotA)],
+				sizeof(old) - offsetof(legacy_record_t, slotA));
+	}
+
+	old.crc = CRC32_Calculate(&raw[sizeof(uint32_t)], size - sizeof(uint32_t));
+	memcpy(&raw[offsetof(legacy_record_t, crc)], &old.crc, sizeof(old.crc));
+	memset(&raw[size], 0xFF, sizeof(raw) - size);
+
+	if (Flash_Write(META_FLASH_ADDR, raw, sizeof(raw)) != true)
+	{
+		Fail("legacy write (%u)", size);
+	}
+
+	Meta_Init(&m);
+
+	if ((m.version != META_RECORD_VERSION) || (m.seq != 7U) || (m.active_slot != META_SLOT_A) ||
+		(m.update_state != META_UPDATE_IN_PROGRESS) || (m.slotB.fw.size_bytes != 0x20000U))
+	{
+		Fail("legacy fields (%u)", size);
+	}
+
+	/* Sürüm 1: CRC'siz ilerleme kullanılmaz */
+	if ((size == sizeof(old)) ? ((m.progress_bytes != 0x10000U) || (m.progress_crc32 != 0x12345678U))
+							  : (m.progress_bytes != 0U))
+	{
+		Fail("legacy progress (%u)", size);
+	}
+
+	/* Taşınan kayıt journal'ın ikinci yerinde, eski kayıt yerinde kalır */
+	Flash_Read(META_FLASH_ADDR + META_RECORD_SLOT_SIZE, &m, sizeof(m));
+
+	if ((m.version != META_RECORD_VERSION) || (m.seq != 7U) || (Meta_Read(&m) != true) || (m.seq != 7U))
+	{
+		Fail("migrated record (%u)", size);
+	}
+
+	printf("version %u record (%u B) migrated ok\n", (size == sizeof(old)) ? 2U : 1U, size);
+}
+
+/*
+ * count yazma boyunca her flash adımında güç keser. Her kesintiden sonra
+ * geçerli kayıt önceki ya da yeni kayıttır; kesilmeyen yazma yeni kaydı bırakır.
+ */
+static void PowerCutSweep(uint32_t count, sim_cut_mode_t mode)
+{
+	for (uint32_t w = 0; w < count; w++)
+	{
+		for (uint32_t step = 1U; ; step++)
+		{
+			meta_record_t 	m;
+			pid_t 			pid;
+			int 			status;
+
+			fflush(stdout);
+			pid = fork();
+
+			if (pid == 0)
+			{
+				Sim_Flash_SetPowerCut(step, mode, step * 7919U + w);
+				Record(&m, marker + 1U);
+				_exit((Meta_Write(&m) == true) ? 0 : 1);
+			}
+
+			if ((pid < 0) || (waitpid(pid, &status, 0) != pid) || (WIFEXITED(status) == 0))
+			{
+				Fail("child (%u)", step);
+			}
+
+			if ((Meta_Read(&m) != true) || ((m.progress_bytes != marker) && (m.progress_bytes != (marker + 1U))))
+			{
+				Fail("%s (%u)", (mode == SIM_CUT_TORN) ? "torn cut: record lost" : "clean cut: record lost", step);
+			}
+
+			if (WEXITSTATUS(status) == 0)
+			{
+				marker += 1U;
+				Expect(marker, "completed write");
+				break;
+			}
+
+			if (WEXITSTATUS(status) != 4)
+			{
+				Fail("write failed (%u)", step);
+			}
+
+			/* Kesilen yazma yeni kaydı bırakmışsa sıradaki yazma onun üstüne */
+			marker = m.progress_bytes;
+			cuts += 1U;
+		}
+	}
+}
+
+static void Test_Main(void)
+{
+	/* Slot A'da geçerli vektör tablosu: Meta_Init kaydı slotlara göre değiştirmesin */
+	static const uint32_t vectors[4] = { 0x20010000U, SLOT_A_BASE_ADDR + 0x201U, 0xFFFFFFFFU, 0xFFFFFFFFU };
+
+	if (Flash_Write(SLOT_A_BASE_ADDR, (const uint8_t *)vectors, sizeof(vectors)) != true)
+	{
+		Fail("slot A");
+	}
+
+	Migration(sizeof(legacy_record_t));
+	Migration(sizeof(legacy_record_t) - sizeof(uint32_t));
+
+	/* Bütün sayfalar dolar, alan başa döner ve ilk sayfa silinir */
+	EraseJournal();
+	Append(JOURNAL_RECORDS + (META_RECORDS_PER_PAGE / 2U));
+	printf("%u records, %u pages wrapped ok\n", marker, (uint32_t)META_JOURNAL_PAGES);
+
+	/* Son sayfanın son iki yeri, dolu ilk sayfanın silinmesi, sonrası */
+	EraseJournal();
+	Append(JOURNAL_RECORDS - 2U);
+	PowerCutSweep(4U, SIM_CUT_CLEAN);
+
+	EraseJournal();
+	Append(JOURNAL_RECORDS - 2U);
+	PowerCutSweep(4U, SIM_CUT_TORN);
+
+	printf("%u power cuts around a page wrap ok\n", cuts);
+	printf("test_meta_journal: OK\n");
+
+	result = 0;
+}
+
+int main(int argc, char **argv)
+{
+	void *stack;
+
+	if (argc != 2)
+	{
+		fprintf(stderr, "usage: %s <flash.bin>\n", argv[0]);
+		return 1;
+	}
+
+	flashPath = argv[1];
+	unlink(flashPath);
+
+	if (Sim_Flash_Open(flashPath) != true)
+	{
+		return 1;
+	}
+
+	stack = mmap(NULL, TEST_STACK_SIZE, PROT_READ | PROT_WRITE,
+				 MAP_PRIVATE | MAP_ANONYMOUS | MAP_32BIT | MAP_STACK, -1, 0);
+
+	if ((stack == MAP_FAILED) || ((uintptr_t)main > 0xFFFFFFFFu))
+	{
+		fprintf(stderr, "test_meta_journal: needs a 32-bit address space (build with -no-pie)\n");
+		return 1;
+	}
+
+	getcontext(&testCtx);
+	testCtx.uc_stack.ss_sp 	 = stack;
+	testCtx.uc_stack.ss_size = TEST_STACK_SIZE;
+	testCtx.uc_link 		 = &hostCtx;
+	makecontext(&testCtx, Test_Main, 0);
+	swapcontext(&hostCtx, &testCtx);
+
+	unlink(flashPath);
+
+	return result;
+}
@@ -0,0 +1,142 @@
+#!/bin/sh
+#
+# Simülatör üzerinde uçtan uca güncelleme testi: bl_sim (Core altındaki
+# bootloader, simüle flash) ile bl_upload pty üzerinden konuşur.
+#
+#   sh Tests/test_sim_e2e.sh [build dizini]
+#
+# Sıra: boş flash'a BIN (push + sparse), normal açılış, DELTA, LZ4, kopya
+# aralıklı BIN, yazma sırasında güç kesintisi (yırtık ve temiz) ve devam.
+# Her adımda uygulamanın doğru slottan başlatıldığı ve slot içeriği kontrol edilir.
+
+set -u
+
+BUILD=${1:-build}
+WORK=$(mktemp -d)
+STATE=$WORK/state
+PTY=$WORK/tty
+SIM=
+
+cleanup()
+{
+	[ -n "$SIM" ] && kill "$SIM" 2>/dev/null
+	rm -rf "$WORK"
+}
+trap cleanup EXIT
+
+fail()
+{
+	echo "FAIL: $*"
+	echo "--- bl_sim"; cat "$WORK/sim.log"
+	echo "--- bl_upload"; cat "$WORK/up.log"
+	exit 1
+}
+
+# sim_start [bl_sim seçenekleri]: simülatör arka planda, pty hazır olana kadar beklenir
+sim_start()
+{
+	rm -f "$PTY"
+	: >"$WORK/up.log"
+	"$BUILD/bl_sim" --pty "$PTY" --state "$STATE" "$@" 2>"$WORK/sim.log" &
+	SIM=$!
+
+	i=0
+	while [ ! -e "$PTY" ] && [ $i -lt 50 ]; do
+		sleep 0.1
+		i=$((i + 1))
+	done
+}
+
+# sim_wait <beklenen çıkış kodu>
+sim_wait()
+{
+	wait "$SIM"
+	code=$?
+	SIM=
+	[ "$code" -eq "$1" ] || fail "bl_sim exit $code, expected $1"
+}
+
+upload()
+{
+	"$BUILD/bl_upload" --port "$PTY" "$@" >"$WORK/up.log" 2>&1
+}
+
+# expect_app <VTOR> <imaj>: uygulama o slottan başladı ve slot imajın aynısı
+expect_app()
+{
+	grep -q "application started, VTOR $1" "$WORK/sim.log" || fail "application not started from $1"
+
+	base=$(($1 - 0x08000000))
+	size=$(wc -c <"$2")
+	cmp -s -n "$size" -i "$base:0" "$STATE/flash.bin" "$2" || fail "slot $1 does not hold $2"
+}
+
+image()
+{
+	out=$1
+	shift
+	python3 Tools/app_image.py "$BUILD/fw.bin" "$WORK/$out" --size 300000 "$@" >/dev/null ||
+		fail "app_image $out"
+}
+
+mkdir -p "$STATE"
+
+image v1a.bin --slot A
+image v2b.bin --slot B --seed 2 --mutate 40
+image v3a.bin --slot A --seed 3 --mutate 40
+image v4b.bin --slot B --seed 4 --mutate 3
+image v5a.bin --slot A --seed 5 --mutate 100
+
+echo "BIN push + sparse, empty flash -> A"
+sim_start
+upload --push --sparse --version 1.0.0 "$WORK/v1a.bin" || fail "upload"
+sim_wait 0
+expect_app 0x08040000 "$WORK/v1a.bin"
+grep -q "bytes committed    300000" "$WORK/up.log" || fail "stats not read"
+
+echo "plain boot"
+sim_start
+sim_wait 0
+expect_app 0x08040000 "$WORK/v1a.bin"
+
+echo "DELTA -> B"
+sim_start --update-request
+upload --format delta --base "$WORK/v1a.bin" --version 2.0.0 "$WORK/v2b.bin" || fail "upload"
+sim_wait 0
+expect_app 0x08200000 "$WORK/v2b.bin"
+
+echo "LZ4 -> A"
+sim_start --update-request
+upload --format lz4 --window 8 --version 3.0.0 "$WORK/v3a.bin" || fail "upload"
+sim_wait 0
+expect_app 0x08040000 "$WORK/v3a.bin"
+
+echo "BIN with copy runs -> B"
+sim_start --update-request
+upload --copy --sparse --version 4.0.0 "$WORK/v4b.bin" || fail "upload"
+sim_wait 0
+grep -q "pages unchanged" "$WORK/up.log" || fail "no page manifest"
+expect_app 0x08200000 "$WORK/v4b.bin"
+
+echo "BIN -> A, torn power cut, then clean power cut, then resume"
+sim_start --update-request --power-cut 800 --torn --seed 7
+upload --version 5.0.0 "$WORK/v5a.bin" && fail "upload survived the power cut"
+sim_wait 4
+
+sim_start --power-cut 1000
+upload --push --version 5.0.0 "$WORK/v5a.bin" && fail "upload survived the power cut"
+grep -q "resuming at" "$WORK/up.log" || fail "first restart did not resume"
+sim_wait 4
+
+sim_start
+upload --version 5.0.0 "$WORK/v5a.bin" || fail "upload"
+grep -q "resuming at" "$WORK/up.log" || fail "second restart did not resume"
+sim_wait 0
+expect_app 0x08040000 "$WORK/v5a.bin"
+
+echo "plain boot"
+sim_start
+sim_wait 0
+expect_app 0x08040000 "$WORK/v5a.bin"
+
+echo "sim e2e: OK"
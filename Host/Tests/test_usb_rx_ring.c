@@ -0,0 +1,364 @@
+/*
+ * test_usb_rx_ring.c
+ *
+ * USB RX yolu (ISR -> SPSC byte ring -> frame havuzu -> tek çağrıda çözüm) için
+ * rastgele parçalama testi. CDC_Receive_HS'in yaptığı gibi her OUT transferinde
+ * önce sonraki buffer istenir, sonra veri USB_RXCallback ile ring'e aktarılır;
+ * ana döngü adımları transferlerin arasına rastgele serpiştirilir.
+ *
+ * Akışta: geçerli kontrol frame'leri, lean SEND_PACKET frame'leri (8 KB'a kadar),
+ * checksum'ı bozuk ve yönlendirilmeyen frame'ler, sahte 0xAA 0x55 header'lı çöp.
+ * Beklenen: geçerli ve yönlendirilen frame'lerin tamamı, sırasıyla ve bozulmadan.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "USB_Receive.h"
+#include "usbd_cdc_if.h"
+#include "test_util.h"
+
+#define STREAM_MAX			(8u * 1024u * 1024u)
+#define EXPECT_MAX			8192u
+#define HOLD_MAX			USB_RX_FRAME_POOL_COUNT	/* Havuzun tamamı bekletilebilir */
+
+typedef struct
+{
+	uint8_t 	command;
+	uint16_t 	len;
+	uint32_t 	streamPos;		/* Payload'ın akıştaki yeri */
+}expected_frame_t;
+
+static uint8_t 				stream[STREAM_MAX];
+static uint32_t 			streamLen;
+static expected_frame_t 	expected[EXPECT_MAX];
+static uint32_t 			expectedCount;
+static uint32_t 			deliveredCount;
+
+static uint8_t 				*armedBuf;		/* Kurulu OUT endpoint buffer'ı, NULL: host NAK alıyor */
+static uint32_t 			resumeCount;
+
+static USBRxFrameView_t 	held[HOLD_MAX];
+static uint32_t 			heldIndex[HOLD_MAX];
+static uint32_t 			heldCount;
+
+static uint32_t RandRange(uint32_t lo, uint32_t hi)
+{
+	return lo + (Rand() % (hi - lo + 1u));
+}
+
+/* Tohum ve teslim edilen frame sayısı mesaja eklenir */
+static void FailSeed(const char *what, uint32_t seed)
+{
+	Fail("seed=%u: %s (delivered %u / %u)", seed, what, deliveredCount, expectedCount);
+}
+
+uint8_t CDC_Transmit_HS(uint8_t *Buf, uint16_t Len)
+{
+	(void)Buf;
+	(void)Len;
+	return USBD_OK;
+}
+
+void CDC_Resume_Receive_HS(uint8_t *Buf)
+{
+	armedBuf 	 = Buf;
+	resumeCount += 1u;
+}
+
+/* ---------------------------------------------------------------------- */
+
+static void Put(uint8_t b)
+{
+	stream[streamLen++] = b;
+}
+
+static void PutFrame(uint8_t type, uint8_t command, uint16_t len, int badChecksum, int expect)
+{
+	uint8_t  xorSum = 0;
+	uint32_t start;
+
+	Put(USB_PACKET_HEADER_1);
+	Put(USB_PACKET_HEADER_2);
+	start = streamLen;
+	Put(type);
+	Put(command);
+	Put((Rand() & 1u) ? USB_PACKET_PROCESS_TYPE_READ : USB_PACKET_PROCESS_TYPE_WRITE);
+	Put((uint8_t)(len >> 8));
+	Put((uint8_t)len);
+
+	if (expect)
+	{
+		expected[expectedCount].command 	= command;
+		expected[expectedCount].len 		= len;
+		expected[expectedCount].streamPos 	= streamLen;
+		expectedCount += 1u;
+	}
+
+	for (uint16_t i = 0; i < len; i++)
+	{
+		/* Payload da header / footer byte'ları içerebilir */
+		Put((Rand() % 8u == 0u) ? ((Rand() & 1u) ? 0xAAu : 0x55u) : (uint8_t)Rand());
+	}
+
+	for (uint32_t i = start; i < streamLen; i++)
+	{
+		xorSum ^= stream[i];
+	}
+
+	Put(badChecksum ? (uint8_t)(xorSum ^ 0x5Au) : xorSum);
+	Put(USB_PACKET_FOOTER_1);
+	Put(USB_PACKET_FOOTER_2);
+}
+
+/* Sahte header içeren çöp: ya geçersiz uzunluk ya da tutmayan footer */
+static void PutGarbage(void)
+{
+	uint32_t n = RandRange(1u, 40u);
+
+	for (uint32_t i = 0; i < n; i++)
+	{
+		uint8_t b = (uint8_t)Rand();
+		Put((b == 0xAAu) ? 0x00u : b);
+	}
+
+	if (Rand() & 1u)
+	{
+		Put(USB_PACKET_HEADER_1);
+		Put(USB_PACKET_HEADER_2);
+		Put(USB_PACKET_FIRMWARE_UPDATE);
+		Put(USB_FIRMWARE_UPDATE_STATUS_REQ);
+		Put(USB_PACKET_PROCESS_TYPE_READ);
+		Put(0xFFu);
+		Put(0xF0u);
+	}
+	else
+	{
+		uint16_t len = (uint16_t)RandRange(0u, 16u);
+
+		Put(USB_PACKET_HEADER_1);
+		Put(USB_PACKET_HEADER_2);
+		Put(USB_PACKET_FIRMWARE_UPDATE);
+		Put(USB_FIRMWARE_UPDATE_STATUS_REQ);
+		Put(USB_PACKET_PROCESS_TYPE_READ);
+		Put(0u);
+		Put((uint8_t)len);
+
+		for (uint16_t i = 0; i < (uint16_t)(len + 1u); i++)
+		{
+			Put(0x11u);
+		}
+
+		Put(0x12u);
+		Put(0x34u);
+	}
+}
+
+static void BuildStream(void)
+{
+	static const uint8_t controlCommands[] =
+	{
+		USB_FIRMWARE_UPDATE_STATUS_REQ,
+		USB_FIRMWARE_FLASH_ERASE,
+		USB_FIRMWARE_CMD_RESET_DEVICE,
+	};
+
+	streamLen 		= 0;
+	expectedCount 	= 0;
+
+	while ((streamLen < (STREAM_MAX - 3u * USB_MAX_BUFFER_LEN)) && (expectedCount < (EXPECT_MAX - 1u)))
+	{
+		switch (Rand() % 8u)
+		{
+			case 0:
+			case 1:
+				PutFrame(USB_PACKET_FIRMWARE_UPDATE, controlCommands[Rand() % sizeof(controlCommands)],
+						 (uint16_t)RandRange(0u, USB_RX_CONTROL_DATA_LEN_MAX), 0, 1);
+				break;
+			case 2:
+			case 3:
+				PutFrame(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_SEND_PACKET,
+						 (uint16_t)RandRange(12u, USB_RX_DATA_LEN_MAX), 0, 1);
+				break;
+			case 4:
+				PutFrame(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_STATUS_REQ,
+						 (uint16_t)RandRange(0u, 32u), 1, 0);
+				break;
+			case 5:
+				/* Bootloader'a yönlendirilmeyen komut: doğrulanır ve düşürülür */
+				PutFrame(USB_PACKET_PACKET_TYPE_TEST, USB_TEST_COMMAND_ID_LED,
+						 (uint16_t)RandRange(0u, 64u), 0, 0);
+				break;
+			case 6:
+				PutGarbage();
+				break;
+			default:
+				/* Arka arkaya küçük frame'ler: aynı transferde birden fazla frame */
+				for (uint32_t i = RandRange(2u, 6u); i > 0u; i--)
+				{
+					PutFrame(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_STATUS_REQ,
+							 (uint16_t)RandRange(0u, 8u), 0, 1);
+				}
+				break;
+		}
+	}
+
+	/* Son frame'i ring'den çıkarabilmek için kapanışta bir geçerli frame daha */
+	PutFrame(USB_PACKET_FIRMWARE_UPDATE, USB_FIRMWARE_UPDATE_STATUS_REQ, 0u, 0, 1);
+}
+
+/* ---------------------------------------------------------------------- */
+
+static int ViewMatches(const USBRxFrameView_t *view, uint32_t index)
+{
+	const expected_frame_t *e = &expected[index];
+
+	return (view->packet_type == USB_PACKET_FIRMWARE_UPDATE) &&
+		   (view->command_id == e->command) &&
+		   (view->data_len == e->len) &&
+		   (memcmp(view->data, &stream[e->streamPos], e->len) == 0);
+}
+
+static void ReleaseHeld(uint32_t which, uint32_t seed)
+{
+	if (ViewMatches(&held[which], heldIndex[which]) == 0)
+	{
+		FailSeed("held frame changed before release", seed);
+	}
+
+	USB_Rx_Release_Frame(&held[which]);
+
+	held[which] 		= held[heldCount - 1u];
+	heldIndex[which] 	= heldIndex[heldCount - 1u];
+	heldCount 		   -= 1u;
+}
+
+/* Ana döngü turu: frame çıkar / çöz, update engine gibi bir kısmını bekletir */
+static void MainLoopStep(uint32_t seed)
+{
+	USBRxFrameView_t view;
+
+	memset(&view, 0, sizeof(view));
+
+	System_USB_Communication_Receive_Function(&view);
+
+	if (view.valid)
+	{
+		if (deliveredCount >= expectedCount)
+		{
+			FailSeed("unexpected frame delivered", seed);
+		}
+
+		if (ViewMatches(&view, deliveredCount) == 0)
+		{
+			FailSeed("delivered frame does not match", seed);
+		}
+
+		if (heldCount == HOLD_MAX)
+		{
+			ReleaseHeld(Rand() % heldCount, seed);
+		}
+
+		held[heldCount] 		= view;
+		heldIndex[heldCount] 	= deliveredCount;
+		heldCount 			   += 1u;
+		deliveredCount 		   += 1u;
+	}
+
+	if ((heldCount != 0u) && ((Rand() % 3u) != 0u))
+	{
+		ReleaseHeld(Rand() % heldCount, seed);
+	}
+}
+
+/* Bir OUT transferi: CDC_Receive_HS'in sırası (önce sonraki buffer, sonra ring) */
+static uint32_t OutTransfer(uint32_t pos)
+{
+	uint8_t 	*buf = armedBuf;
+	uint32_t 	len;
+
+	/* Kısa paketler ve tam 512'lik transferler karışık */
+	len = (Rand() & 1u) ? USB_RX_EP_PACKET_SIZE : RandRange(1u, USB_RX_EP_PACKET_SIZE);
+
+	if (len > (streamLen - pos))
+	{
+		len = streamLen - pos;
+	}
+
+	memcpy(buf, &stream[pos], len);
+
+	armedBuf = USB_Rx_Get_Rx_Buffer(len);
+
+	USB_RXCallback(buf, &len);
+
+	return pos + len;
+}
+
+static void RunSeed(uint32_t seed)
+{
+	extern USBCommParameters_t USB_Comm_Parameters;
+	extern volatile USB_RxDebug_t g_usb_rx_debug;
+	uint32_t pos 		= 0;
+	uint32_t idleTurns 	= 0;
+
+	Rand_Seed(seed);
+	memset((void *)&g_usb_rx_debug, 0, sizeof(g_usb_rx_debug));
+	resumeCount = 0;
+
+	BuildStream();
+
+	if (armedBuf == NULL)
+	{
+		armedBuf = USB_Rx_Get_Init_Buffer();
+	}
+
+	while ((pos < streamLen) || (deliveredCount < expectedCount))
+	{
+		/* Transfer ve ana döngü turları rastgele sırayla */
+		if ((pos < streamLen) && (armedBuf != NULL) && ((Rand() % 4u) != 0u))
+		{
+			pos = OutTransfer(pos);
+			idleTurns = 0;
+			continue;
+		}
+
+		MainLoopStep(seed);
+
+		if (++idleTurns > 100000u)
+		{
+			FailSeed("receive path stalled", seed);
+		}
+	}
+
+	while (heldCount != 0u)
+	{
+		ReleaseHeld(0, seed);
+	}
+
+	/* Bozuk checksum'lı frame'ler teslim edilmeden reddedilmiş olmalı */
+	if ((USB_Comm_Parameters.USB_rx_parameters.USB_packet_error & USB_PACKET_ERROR_CHECKSUM) == 0u)
+	{
+		FailSeed("bad checksum frames were not rejected", seed);
+	}
+
+	printf("seed %-10u %7u bytes  %5u frames  resync %u  ring full %u  pool full %u  resumes %u  errors 0x%03x\n",
+		   seed, streamLen, deliveredCount, g_usb_rx_debug.resync_count, g_usb_rx_debug.ring_full_count,
+		   g_usb_rx_debug.pool_exhausted_count, resumeCount, USB_Comm_Parameters.USB_rx_parameters.USB_packet_error);
+
+	deliveredCount = 0;
+}
+
+int main(int argc, char **argv)
+{
+	uint32_t seeds = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 8u;
+
+	for (uint32_t seed = 1; seed <= seeds; seed++)
+	{
+		RunSeed(seed * 2654435761u);
+	}
+
+	printf("test_usb_rx_ring: OK\n");
+
+	return 0;
+}
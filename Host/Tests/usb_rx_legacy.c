@@ -0,0 +1,47 @@
+/*
+ * usb_rx_legacy.c
+ *
+ * bench_usb_rx için karşılaştırma: baseline'daki (9348478) on durumlu USB_Receive
+ * makinesi. Makefile baseline USB_General / USB_Receive kaynaklarını git'ten
+ * build/legacy altına çıkarır; bu dosya onları tek birim olarak derler ve
+ * yalnızca Legacy_Rx_* fonksiyonlarını global bırakır (objcopy -G), böylece
+ * yeni alım yoluyla aynı programa bağlanır.
+ */
+
+#include "USB_General.c"
+#include "USB_Receive.c"
+
+/* Baseline'da frame başına en fazla bu kadar byte toplanır (debug tamponu) */
+uint32_t Legacy_Rx_Frame_Max(void)
+{
+	return USB_RX_DEBUG_BUF_SIZE;
+}
+
+/* Bir OUT transferi: baseline'daki CDC_Receive_HS yalnızca USB_RXCallback'i çağırır */
+void Legacy_Rx_Feed(uint8_t *buf, uint32_t len)
+{
+	USB_RXCallback(buf, &len);
+}
+
+/*
+ * Bekleyen frame'i ana döngünün yaptığı gibi durum durum işler (her tur bir
+ * durum); operasyon durumuna ulaşan, yani uygulamaya verilen frame sayısını döner.
+ */
+uint32_t Legacy_Rx_Drain(void)
+{
+	static USBCommParameters_t 	local;
+	uint32_t 					frames = 0;
+
+	while ((USB_Comm_Parameters.USB_rx_parameters.usbRxFlag != 0U) ||
+		   (USB_Comm_Parameters.USB_rx_parameters.device_rx_state != USB_RX_WAIT_PACKET_STATE))
+	{
+		if (USB_Comm_Parameters.USB_rx_parameters.device_rx_state == USB_RX_OPERATION_STATE)
+		{
+			frames += 1U;
+		}
+
+		System_USB_Communication_Receive_Function(&local);
+	}
+
+	return frames;
+}
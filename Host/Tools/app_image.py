@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+"""
+Simülatör testleri için uygulama imajı üretir.
+
+Örnek firmware (fw.bin) bootloader'ın kendisidir; reset vektörü verilen
+slotun içine taşınır ki BL_IsVectorTableSane imajı kabul etsin. İmaj
+istenen boyuta sözde rastgele veriyle (arada 0xFF blokları) uzatılır,
+--mutate ile aynı imajın değişmiş bir sürümü (v2) üretilir.
+
+    app_image.py <fw.bin> <out.bin> --slot A|B [--size N] [--seed S] [--mutate K]
+"""
+
+import argparse
+import random
+import struct
+
+FLASH_BASE = 0x08000000
+SLOT_BASE = {"A": 0x08040000, "B": 0x08200000}
+HEADER = 0x200          # Vektör tablosu değiştirilmez
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("fw")
+    ap.add_argument("out")
+    ap.add_argument("--slot", choices=SLOT_BASE.keys(), required=True)
+    ap.add_argument("--size", type=lambda s: int(s, 0), default=0)
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--mutate", type=int, default=0)
+    args = ap.parse_args()
+
+    with open(args.fw, "rb") as f:
+        img = bytearray(f.read())
+
+    # Dolgu: 0xFF ve rastgele 4 KB bloklar (SPARSE aralıkları ve sıkıştırma için)
+    rng = random.Random(1)
+    while len(img) < args.size:
+        n = min(4096, args.size - len(img))
+        if rng.random() < 0.25:
+            img += b"\xff" * n
+        else:
+            img += bytes(rng.getrandbits(8) for _ in range(n))
+
+    rng = random.Random(args.seed)
+    for _ in range(args.mutate):
+        img[rng.randrange(HEADER, len(img))] ^= rng.randrange(1, 256)
+
+    rst, = struct.unpack_from("<I", img, 4)
+    struct.pack_into("<I", img, 4, SLOT_BASE[args.slot] + (rst - FLASH_BASE))
+
+    with open(args.out, "wb") as f:
+        f.write(img)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,926 @@
+/*
+ * bl_upload.cpp
+ *
+ * Bootloader'a USB CDC (seri port) üzerinden firmware yükleyen host aracı.
+ * Gerçek kartta /dev/ttyACMx, simülatörde bl_sim'in --pty ile verdiği yol
+ * kullanılır.
+ *
+ *   bl_upload --port <tty> [seçenekler] <image.bin>
+ *   bl_upload --port <tty> --stats
+ *
+ *   --format bin|lz4|delta	  transfer formatı (varsayılan bin)
+ *   --base <old.bin>		  delta: cihazın aktif slotundaki imaj
+ *   --version <maj.min.patch>
+ *   --chunk <n>				  blok boyutu (256..8192, 16'nın katı)
+ *   --window <n>			  bekleyen talep sayısı (1..8)
+ *   --push					  host blokları talep beklemeden gönderir (PROGRESS ile akış kontrolü)
+ *   --sparse				  0xFF bloklar veri yerine SPARSE aralık olarak gönderilir (bin)
+ *   --copy					  aktif slotta aynı kalan sayfalar COPY aralık olarak gönderilir (bin)
+ *   --stats					  son transferin ölçümlerini okur (UPDATE_STATS)
+ *
+ * Transfer bitince (JUMPING_APPLICATION) host'ta ölçülen faz süreleri, byte/s ve
+ * tur sayısı yazdırılır; bootloader'ın ölçümleri de okunur (atlamadan önce 1 s
+ * komut kabul eder).
+ *
+ * Çıkış kodu: 0 başarılı, 1 hata, 2 kullanım hatası.
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+extern "C" {
+#include "crc.h"
+#include "lz4_block.h"
+#include "delta_gen.h"
+}
+
+namespace
+{
+
+/* USB_General.h / bootloader_driver.h ile aynı değerler */
+constexpr uint8_t  kPacketType			= 0x60;
+constexpr uint8_t  kProcessWrite		= 0x02;
+constexpr uint8_t  kCmdStatusReq		= 0x10;
+constexpr uint8_t  kCmdReady			= 0x11;
+constexpr uint8_t  kCmdPacketInfo		= 0x12;
+constexpr uint8_t  kCmdGetPacket		= 0x13;
+constexpr uint8_t  kCmdSendPacket		= 0x14;
+constexpr uint8_t  kCmdVerifyPacket		= 0x15;
+constexpr uint8_t  kCmdJumping			= 0x21;
+constexpr uint8_t  kCmdPageManifest		= 0x22;
+constexpr uint8_t  kCmdProgress			= 0x23;
+constexpr uint8_t  kCmdStats			= 0x24;
+
+constexpr uint8_t  kFormatBin			= 0;
+constexpr uint8_t  kFormatLz4			= 2;
+constexpr uint8_t  kFormatDelta			= 3;
+
+constexpr uint32_t kSparseFlag			= 0x80000000u;
+constexpr uint32_t kCopyFlag			= 0x40000000u;
+constexpr uint8_t  kPushFlag			= 0x80u;
+constexpr uint32_t kPageSize			= 8192u;
+constexpr uint32_t kRunAlign			= 16u;
+constexpr uint8_t  kManifestPages		= 8u;
+
+constexpr int	   kIdleTimeoutMs		= 10000;
+
+struct Frame
+{
+	uint8_t 			 type;
+	uint8_t 			 cmd;
+	uint8_t 			 status;
+	std::vector<uint8_t> data;
+};
+
+struct Options
+{
+	std::string port;
+	std::string image;
+	std::string base;
+	uint8_t 	format 	= kFormatBin;
+	uint8_t 	version[3] = { 1, 0, 0 };		// major, minor, patch
+	uint32_t 	chunk 	= 4096;
+	uint32_t 	window 	= 4;
+	bool 		push 	= false;
+	bool 		sparse 	= false;
+	bool 		copy 	= false;
+	bool 		stats 	= false;
+};
+
+uint32_t NowMs()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return static_cast<uint32_t>((ts.tv_sec * 1000LL) + (ts.tv_nsec / 1000000LL));
+}
+
+uint32_t ReadBE32(const uint8_t *p)
+{
+	return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+		   (static_cast<uint32_t>(p[2]) << 8)  |  static_cast<uint32_t>(p[3]);
+}
+
+uint32_t ReadLE32(const uint8_t *p)
+{
+	return (static_cast<uint32_t>(p[3]) << 24) | (static_cast<uint32_t>(p[2]) << 16) |
+		   (static_cast<uint32_t>(p[1]) << 8)  |  static_cast<uint32_t>(p[0]);
+}
+
+void PutBE32(std::vector<uint8_t> &v, uint32_t x)
+{
+	v.push_back(static_cast<uint8_t>(x >> 24));
+	v.push_back(static_cast<uint8_t>(x >> 16));
+	v.push_back(static_cast<uint8_t>(x >> 8));
+	v.push_back(static_cast<uint8_t>(x));
+}
+
+void PutLE32(std::vector<uint8_t> &v, uint32_t x)
+{
+	v.push_back(static_cast<uint8_t>(x));
+	v.push_back(static_cast<uint8_t>(x >> 8));
+	v.push_back(static_cast<uint8_t>(x >> 16));
+	v.push_back(static_cast<uint8_t>(x >> 24));
+}
+
+bool ReadFile(const std::string &path, std::vector<uint8_t> &out)
+{
+	FILE *f = std::fopen(path.c_str(), "rb");
+
+	if (f == nullptr)
+	{
+		return false;
+	}
+
+	uint8_t buf[65536];
+	size_t 	n;
+
+	out.clear();
+
+	while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0)
+	{
+		out.insert(out.end(), buf, buf + n);
+	}
+
+	std::fclose(f);
+
+	return true;
+}
+
+/* Seri port üzerinde frame alma / gönderme (USB_General.h paket yapısı) */
+class Link
+{
+public:
+	~Link()
+	{
+		if (fd_ >= 0)
+		{
+			close(fd_);
+		}
+	}
+
+	bool Open(const std::string &path)
+	{
+		struct termios tio;
+
+		fd_ = open(path.c_str(), O_RDWR | O_NOCTTY);
+
+		if ((fd_ < 0) || (tcgetattr(fd_, &tio) != 0))
+		{
+			return false;
+		}
+
+		cfmakeraw(&tio);
+		tio.c_cc[VMIN]  = 0;
+		tio.c_cc[VTIME] = 0;
+		tcsetattr(fd_, TCSANOW, &tio);
+
+		/* Önceki oturumdan kalan byte'lar atılır */
+		tcflush(fd_, TCIOFLUSH);
+
+		return true;
+	}
+
+	bool Send(uint8_t cmd, const std::vector<uint8_t> &data)
+	{
+		std::vector<uint8_t> buf;
+		uint8_t 			 sum = 0;
+
+		buf.reserve(data.size() + 10u);
+		buf.push_back(0xAA);
+		buf.push_back(0x55);
+		buf.push_back(kPacketType);
+		buf.push_back(cmd);
+		buf.push_back(kProcessWrite);
+		buf.push_back(static_cast<uint8_t>(data.size() >> 8));
+		buf.push_back(static_cast<uint8_t>(data.size()));
+		buf.insert(buf.end(), data.begin(), data.end());
+
+		for (size_t i = 2; i < buf.size(); i++)
+		{
+			sum ^= buf[i];
+		}
+
+		buf.push_back(sum);
+		buf.push_back(0x55);
+		buf.push_back(0xAA);
+
+		for (size_t pos = 0; pos < buf.size();)
+		{
+			ssize_t n = write(fd_, &buf[pos], buf.size() - pos);
+
+			if (n < 0)
+			{
+				if (errno == EINTR)
+				{
+					continue;
+				}
+
+				return false;
+			}
+
+			pos += static_cast<size_t>(n);
+		}
+
+		sent_ += buf.size();
+
+		return true;
+	}
+
+	size_t BytesSent() const
+	{
+		return sent_;
+	}
+
+	/* timeoutMs içinde tam bir frame gelmezse false */
+	bool Receive(Frame &frame, int timeoutMs)
+	{
+		uint32_t start = NowMs();
+
+		for (;;)
+		{
+			if (Parse(frame) == true)
+			{
+				return true;
+			}
+
+			int left = timeoutMs - static_cast<int>(NowMs() - start);
+
+			if (left <= 0)
+			{
+				return false;
+			}
+
+			struct pollfd pfd = { fd_, POLLIN, 0 };
+
+			if (poll(&pfd, 1, left) <= 0)
+			{
+				continue;
+			}
+
+			uint8_t buf[4096];
+			ssize_t n = read(fd_, buf, sizeof(buf));
+
+			if (n > 0)
+			{
+				rx_.insert(rx_.end(), buf, buf + n);
+			}
+			else if ((n == 0) || ((errno != EINTR) && (errno != EAGAIN)))
+			{
+				/* Cihaz kapandı (simülatörde pty'nin karşı ucu gitti) */
+				closed_ = true;
+				return false;
+			}
+		}
+	}
+
+	bool Closed() const
+	{
+		return closed_;
+	}
+
+private:
+	bool Parse(Frame &frame)
+	{
+		while (rx_.size() >= 10u)
+		{
+			if ((rx_[0] != 0xAA) || (rx_[1] != 0x55))
+			{
+				rx_.erase(rx_.begin());
+				continue;
+			}
+
+			size_t len 	 = (static_cast<size_t>(rx_[5]) << 8) | rx_[6];
+			size_t total = len + 10u;
+
+			if (rx_.size() < total)
+			{
+				return false;
+			}
+
+			uint8_t sum = 0;
+
+			for (size_t i = 2; i < (7u + len); i++)
+			{
+				sum ^= rx_[i];
+			}
+
+			if ((sum != rx_[7u + len]) || (rx_[8u + len] != 0x55) || (rx_[9u + len] != 0xAA))
+			{
+				rx_.erase(rx_.begin());
+				continue;
+			}
+
+			frame.type 	 = rx_[2];
+			frame.cmd 	 = rx_[3];
+			frame.status = rx_[4];
+			frame.data.assign(rx_.begin() + 7, rx_.begin() + 7 + static_cast<long>(len));
+			rx_.erase(rx_.begin(), rx_.begin() + static_cast<long>(total));
+
+			if (frame.type == kPacketType)
+			{
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	int 				 fd_ 	 = -1;
+	bool 				 closed_ = false;
+	size_t 				 sent_ 	 = 0;
+	std::vector<uint8_t> rx_;
+};
+
+class Uploader
+{
+public:
+	Uploader(Link &link, const Options &opt) : link_(link), opt_(opt) {}
+
+	bool Run(const std::vector<uint8_t> &image, const std::vector<uint8_t> &base)
+	{
+		if (PrepareStream(image, base) != true)
+		{
+			return false;
+		}
+
+		uint32_t start = NowMs();
+
+		if (Handshake() != true)
+		{
+			return false;
+		}
+
+		handshakeMs_ = NowMs() - start;
+		start 		 = NowMs();
+
+		if ((opt_.copy == true) && (FetchManifest(image) != true))
+		{
+			return false;
+		}
+
+		manifestMs_ = NowMs() - start;
+		infoTick_ 	= NowMs();
+
+		SendPacketInfo(image);
+
+		if (Transfer() != true)
+		{
+			return false;
+		}
+
+		PrintTiming(image.size());
+
+		return true;
+	}
+
+	/* UPDATE_STATS cevabı (9 x uint32, LE) */
+	bool ReadStats(int timeoutMs)
+	{
+		static const char *const names[] = {
+			"requests sent", "retransmits", "packets received", "crc errors",
+			"bytes committed", "flash write ms", "final crc ms", "transfer ms", "first packet ms"
+		};
+		uint32_t start = NowMs();
+		Frame 	 f;
+
+		link_.Send(kCmdStats, {});
+
+		while (static_cast<int>(NowMs() - start) < timeoutMs)
+		{
+			if ((link_.Receive(f, 100) == true) && (f.cmd == kCmdStats) && (f.data.size() >= 36u))
+			{
+				for (size_t i = 0; i < 9u; i++)
+				{
+					std::printf("  %-18s %u\n", names[i], ReadLE32(&f.data[i * 4u]));
+				}
+
+				return true;
+			}
+		}
+
+		std::fprintf(stderr, "bl_upload: no UPDATE_STATS reply\n");
+
+		return false;
+	}
+
+private:
+	/* Host tarafında ölçülen süreler; transfer, PACKET_INFO'dan JUMPING_APPLICATION'a kadardır */
+	void PrintTiming(size_t imageSize) const
+	{
+		const double seconds = (transferMs_ != 0u) ? (transferMs_ / 1000.0) : 0.001;
+
+		std::printf("phases: handshake %u ms, manifest %u ms, first reply %u ms, transfer %u ms\n",
+					handshakeMs_, manifestMs_, firstReplyMs_, transferMs_);
+		std::printf("throughput: %.0f B/s image, %.0f B/s on the wire, %u round trips\n",
+					imageSize / seconds, link_.BytesSent() / seconds, requests_ + naks_);
+	}
+
+	bool PrepareStream(const std::vector<uint8_t> &image, const std::vector<uint8_t> &base)
+	{
+		imageCrc_ = CRC32_Calculate(image.data(), static_cast<uint32_t>(image.size()));
+
+		if (opt_.format == kFormatLz4)
+		{
+			stream_.resize(LZ4_BLOCK_BOUND(image.size()));
+			stream_.resize(LZ4_Block_Compress(image.data(), image.size(), stream_.data(), stream_.size()));
+		}
+		else if (opt_.format == kFormatDelta)
+		{
+			delta_gen_stats_t st;
+
+			stream_.resize(DELTA_GEN_BOUND(image.size()));
+			stream_.resize(Delta_Gen(base.data(), base.size(), image.data(), image.size(),
+									 stream_.data(), stream_.size(), &st));
+			baseCrc_ = CRC32_Calculate(base.data(), static_cast<uint32_t>(base.size()));
+		}
+		else
+		{
+			stream_ = image;
+		}
+
+		if (stream_.empty() == true)
+		{
+			std::fprintf(stderr, "bl_upload: cannot encode image\n");
+			return false;
+		}
+
+		std::printf("image %zu B, crc 0x%08X, transfer %zu B\n", image.size(), imageCrc_, stream_.size());
+
+		return true;
+	}
+
+	/* STATUS_REQ -> READY: bootloader update moduna girene kadar tekrarlanır */
+	bool Handshake()
+	{
+		uint32_t start 	  = NowMs();
+		uint32_t lastSent = 0;
+		Frame 	 f;
+
+		for (;;)
+		{
+			if (static_cast<int>(NowMs() - start) > 40000)
+			{
+				std::fprintf(stderr, "bl_upload: bootloader did not answer STATUS_REQ\n");
+				return false;
+			}
+
+			if ((lastSent == 0u) || ((NowMs() - lastSent) >= 500u))
+			{
+				link_.Send(kCmdStatusReq, {});
+				lastSent = NowMs();
+			}
+
+			if ((link_.Receive(f, 100) == true) && (f.cmd == kCmdReady) && (f.data.size() >= 15u))
+			{
+				break;
+			}
+		}
+
+		uint32_t chunkMax 	= ReadLE32(&f.data[2]);
+		uint32_t windowMax 	= f.data[6];
+		uint32_t resumeOff 	= ReadLE32(&f.data[7]);
+		uint32_t resumeCrc 	= ReadLE32(&f.data[11]);
+
+		std::printf("READY: active %u target %u chunk <= %u window <= %u resume %u (crc 0x%08X)\n",
+					f.data[0], f.data[1], chunkMax, windowMax, resumeOff, resumeCrc);
+
+		if (opt_.chunk > chunkMax)
+		{
+			opt_.chunk = chunkMax;
+		}
+
+		if (opt_.window > windowMax)
+		{
+			opt_.window = windowMax;
+		}
+
+		/* BL_Resume_Begin ile aynı koşul: aynı BIN imajı, checkpoint'ten devam eder */
+		if ((opt_.format == kFormatBin) && (resumeOff != 0u) && (resumeOff < stream_.size()) &&
+			(resumeCrc == imageCrc_))
+		{
+			resumeOffset_ = resumeOff;
+			std::printf("resuming at %u\n", resumeOffset_);
+		}
+
+		return true;
+	}
+
+	/* Aktif slotun sayfa CRC'leri: eşleşen sayfalar COPY ile gönderilir */
+	bool FetchManifest(const std::vector<uint8_t> &image)
+	{
+		uint32_t pages = static_cast<uint32_t>((image.size() + kPageSize - 1u) / kPageSize);
+		uint32_t same  = 0;
+
+		pageSame_.assign(pages, false);
+
+		for (uint32_t page = 0; page < pages; page += kManifestPages)
+		{
+			std::vector<uint8_t> req = { static_cast<uint8_t>(page >> 8), static_cast<uint8_t>(page), kManifestPages };
+			uint32_t 			 start = NowMs();
+			Frame 				 f;
+			bool 				 done = false;
+
+			link_.Send(kCmdPageManifest, req);
+
+			while ((done == false) && ((NowMs() - start) < 2000u))
+			{
+				if ((link_.Receive(f, 100) != true) || (f.cmd != kCmdPageManifest) || (f.data.size() < 3u) ||
+					((((uint32_t)f.data[0] << 8) | f.data[1]) != page))
+				{
+					continue;
+				}
+
+				for (uint32_t i = 0; (i < f.data[2]) && ((page + i) < pages) && ((3u + (i * 4u) + 4u) <= f.data.size()); i++)
+				{
+					std::vector<uint8_t> padded(kPageSize, 0xFF);
+					size_t 				 off = static_cast<size_t>(page + i) * kPageSize;
+					size_t 				 n 	 = std::min<size_t>(kPageSize, image.size() - off);
+
+					std::memcpy(padded.data(), &image[off], n);
+
+					if (CRC32_Calculate(padded.data(), kPageSize) == ReadBE32(&f.data[3u + (i * 4u)]))
+					{
+						pageSame_[page + i] = true;
+						same++;
+					}
+				}
+
+				done = true;
+			}
+
+			if (done == false)
+			{
+				std::fprintf(stderr, "bl_upload: no PAGE_MANIFEST reply\n");
+				return false;
+			}
+		}
+
+		std::printf("manifest: %u of %u pages unchanged\n", same, pages);
+
+		return true;
+	}
+
+	void SendPacketInfo(const std::vector<uint8_t> &image)
+	{
+		std::vector<uint8_t> info;
+
+		PutLE32(info, static_cast<uint32_t>(stream_.size()));
+		PutLE32(info, imageCrc_);
+		info.push_back(opt_.format);
+		info.push_back(opt_.version[2]);
+		info.push_back(opt_.version[1]);
+		info.push_back(opt_.version[0]);
+		info.push_back(static_cast<uint8_t>(opt_.window | (opt_.push ? kPushFlag : 0u)));
+		PutLE32(info, opt_.chunk);
+		PutLE32(info, static_cast<uint32_t>(image.size()));
+		PutLE32(info, baseCrc_);
+
+		link_.Send(kCmdPacketInfo, info);
+	}
+
+	bool AllFF(uint32_t off, uint32_t len) const
+	{
+		for (uint32_t i = 0; i < len; i++)
+		{
+			if (stream_[off + i] != 0xFF)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool PagesSame(uint32_t off, uint32_t end) const
+	{
+		for (uint32_t page = off / kPageSize; page < ((end + kPageSize - 1u) / kPageSize); page++)
+		{
+			if ((page >= pageSame_.size()) || (pageSame_[page] == false))
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	/* Talep edilen blok: veri, 0xFF aralığı ya da kopya aralığı. Dönüş: kapsanan byte sayısı */
+	uint32_t SendBlock(uint32_t off, uint32_t len)
+	{
+		const uint32_t 		 size = static_cast<uint32_t>(stream_.size());
+		std::vector<uint8_t> pkt;
+		uint32_t 			 runEnd = off;
+		uint32_t 			 flag 	= 0;
+
+		if ((opt_.copy == true) && (PagesSame(off, off + len) == true))
+		{
+			while ((runEnd < size) && (PagesSame(runEnd, runEnd + 1u) == true))
+			{
+				runEnd = std::min(size, (runEnd / kPageSize + 1u) * kPageSize);
+			}
+
+			flag = kCopyFlag;
+		}
+		else if ((opt_.sparse == true) && (AllFF(off, len) == true))
+		{
+			runEnd = off + len;
+
+			while ((runEnd < size) && (stream_[runEnd] == 0xFF))
+			{
+				runEnd++;
+			}
+
+			flag = kSparseFlag;
+		}
+
+		if (flag != 0u)
+		{
+			uint32_t runLen = runEnd - off;
+
+			/* Sonraki blok quad-word hizasında başlamalı (imaj sonu hariç) */
+			if (runEnd != size)
+			{
+				runLen -= runLen % kRunAlign;
+			}
+
+			PutBE32(pkt, off);
+			PutBE32(pkt, runLen | flag);
+			PutBE32(pkt, CRC32_Calculate(pkt.data(), 8u));
+			link_.Send(kCmdSendPacket, pkt);
+
+			runs_++;
+
+			return runLen;
+		}
+
+		PutBE32(pkt, off);
+		PutBE32(pkt, len);
+		pkt.insert(pkt.end(), stream_.begin() + off, stream_.begin() + off + len);
+		PutBE32(pkt, CRC32_Calculate(&stream_[off], len));
+		link_.Send(kCmdSendPacket, pkt);
+
+		return len;
+	}
+
+	bool Transfer()
+	{
+		const uint32_t size 	  = static_cast<uint32_t>(stream_.size());
+		uint32_t 	   sendPos 	  = resumeOffset_;
+		uint32_t 	   acked 	  = resumeOffset_;
+		uint32_t 	   lastReport = 0;
+		bool 		   replied 	  = false;
+		Frame 		   f;
+
+		for (;;)
+		{
+			/* Push: son bildirilen offset'ten en fazla bir pencere ileride */
+			while ((opt_.push == true) && (sendPos < size) &&
+				   (sendPos < (acked + (opt_.window * opt_.chunk))))
+			{
+				sendPos += SendBlock(sendPos, std::min(opt_.chunk, size - sendPos));
+			}
+
+			if (link_.Receive(f, kIdleTimeoutMs) != true)
+			{
+				if (link_.Closed() == true)
+				{
+					std::fprintf(stderr, "bl_upload: device disconnected\n");
+				}
+				else
+				{
+					std::fprintf(stderr, "bl_upload: bootloader silent for %d ms\n", kIdleTimeoutMs);
+				}
+
+				return false;
+			}
+
+			if (replied == false)
+			{
+				firstReplyMs_ = NowMs() - infoTick_;
+				replied 	  = true;
+			}
+
+			switch (f.cmd)
+			{
+			case kCmdGetPacket:
+				if (f.data.size() >= 8u)
+				{
+					uint32_t off = ReadBE32(&f.data[0]);
+					uint32_t len = ReadBE32(&f.data[4]);
+
+					if ((off >= size) || (len > (size - off)))
+					{
+						std::fprintf(stderr, "bl_upload: bad request %u+%u\n", off, len);
+						return false;
+					}
+
+					requests_++;
+					SendBlock(off, len);
+
+					if ((off * 10ull / size) != lastReport)
+					{
+						lastReport = static_cast<uint32_t>(off * 10ull / size);
+						std::printf("  %3u%%\n", lastReport * 10u);
+					}
+				}
+				break;
+
+			case kCmdVerifyPacket:
+				if ((f.data.size() >= 1u) && (f.data[0] != 0u))
+				{
+					naks_++;
+
+					/* Push: NAK tekrar gönderim talebidir */
+					if ((opt_.push == true) && (f.data.size() >= 5u))
+					{
+						uint32_t off = ReadBE32(&f.data[1]);
+
+						SendBlock(off, std::min(opt_.chunk, size - off));
+					}
+				}
+				break;
+
+			case kCmdProgress:
+				if (f.data.size() >= 4u)
+				{
+					acked = ReadBE32(&f.data[0]);
+				}
+				break;
+
+			case kCmdJumping:
+				transferMs_ = NowMs() - infoTick_;
+				std::printf("done: %u requests, %u runs, %u NAK\n", requests_, runs_, naks_);
+				return true;
+
+			default:
+				break;
+			}
+		}
+	}
+
+	Link 				 &link_;
+	Options 			 opt_;
+	std::vector<uint8_t> stream_;
+	std::vector<bool> 	 pageSame_;
+	uint32_t 			 imageCrc_ 	   = 0;
+	uint32_t 			 baseCrc_ 	   = 0;
+	uint32_t 			 resumeOffset_ = 0;
+	uint32_t 			 requests_ 	   = 0;
+	uint32_t 			 infoTick_ 	   = 0;
+	uint32_t 			 handshakeMs_  = 0;
+	uint32_t 			 manifestMs_   = 0;
+	uint32_t 			 firstReplyMs_ = 0;
+	uint32_t 			 transferMs_   = 0;
+	uint32_t 			 runs_ 		   = 0;
+	uint32_t 			 naks_ 		   = 0;
+};
+
+[[noreturn]] void Usage(const char *prog)
+{
+	std::fprintf(stderr,
+				 "usage: %s --port <tty> [--format bin|lz4|delta] [--base <old.bin>] [--version M.m.p]\n"
+				 "          [--chunk <n>] [--window <n>] [--push] [--sparse] [--copy] <image.bin>\n"
+				 "       %s --port <tty> --stats\n", prog, prog);
+	std::exit(2);
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+	Options opt;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string arg 	 = argv[i];
+		bool 		hasValue = (i + 1) < argc;
+
+		if ((arg == "--port") && hasValue)
+		{
+			opt.port = argv[++i];
+		}
+		else if ((arg == "--format") && hasValue)
+		{
+			std::string v = argv[++i];
+
+			if (v == "bin")
+			{
+				opt.format = kFormatBin;
+			}
+			else if (v == "lz4")
+			{
+				opt.format = kFormatLz4;
+			}
+			else if (v == "delta")
+			{
+				opt.format = kFormatDelta;
+			}
+			else
+			{
+				Usage(argv[0]);
+			}
+		}
+		else if ((arg == "--base") && hasValue)
+		{
+			opt.base = argv[++i];
+		}
+		else if ((arg == "--version") && hasValue)
+		{
+			unsigned maj = 0, min = 0, pat = 0;
+
+			if (std::sscanf(argv[++i], "%u.%u.%u", &maj, &min, &pat) != 3)
+			{
+				Usage(argv[0]);
+			}
+
+			opt.version[0] = static_cast<uint8_t>(maj);
+			opt.version[1] = static_cast<uint8_t>(min);
+			opt.version[2] = static_cast<uint8_t>(pat);
+		}
+		else if ((arg == "--chunk") && hasValue)
+		{
+			opt.chunk = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+		}
+		else if ((arg == "--window") && hasValue)
+		{
+			opt.window = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 0));
+		}
+		else if (arg == "--push")
+		{
+			opt.push = true;
+		}
+		else if (arg == "--sparse")
+		{
+			opt.sparse = true;
+		}
+		else if (arg == "--copy")
+		{
+			opt.copy = true;
+		}
+		else if (arg == "--stats")
+		{
+			opt.stats = true;
+		}
+		else if ((arg[0] != '-') && opt.image.empty())
+		{
+			opt.image = arg;
+		}
+		else
+		{
+			Usage(argv[0]);
+		}
+	}
+
+	if (opt.port.empty() || (opt.image.empty() && (opt.stats == false)) ||
+		((opt.format == kFormatDelta) && opt.base.empty()) ||
+		((opt.format != kFormatBin) && (opt.sparse || opt.copy)) ||
+		(opt.window < 1u) || (opt.chunk < 256u) || ((opt.chunk % kRunAlign) != 0u))
+	{
+		Usage(argv[0]);
+	}
+
+	Link link;
+
+	if (link.Open(opt.port) != true)
+	{
+		std::fprintf(stderr, "bl_upload: cannot open %s\n", opt.port.c_str());
+		return 1;
+	}
+
+	Uploader uploader(link, opt);
+
+	if (opt.image.empty())
+	{
+		return (uploader.ReadStats(1000) == true) ? 0 : 1;
+	}
+
+	std::vector<uint8_t> image;
+	std::vector<uint8_t> base;
+
+	if ((ReadFile(opt.image, image) != true) || (!opt.base.empty() && (ReadFile(opt.base, base) != true)))
+	{
+		std::fprintf(stderr, "bl_upload: cannot read input\n");
+		return 1;
+	}
+
+	if (uploader.Run(image, base) != true)
+	{
+		return 1;
+	}
+
+	(void)uploader.ReadStats(900);
+
+	return 0;
+}
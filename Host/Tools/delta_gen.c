@@ -0,0 +1,210 @@
+/*
+ * delta_gen.c
+ *
+ * Yeni imaj soldan sağa taranır; eski imajda en az DELTA_GEN_MIN_COPY byte
+ * birebir tutan en uzun eşleşme COPY olur. Eşleşmeler arasında kalan boşluk,
+ * son COPY'nin kaydırmasıyla hizalanan eski byte'ların en az yarısı aynıysa
+ * DIFF (bsdiff'teki gibi, taşınan byte'lar çoğunlukla sıfır), değilse DATA olur.
+ * Derlenen kodda adresler kayınca değişen pointer'lar bu DIFF bölgelerine düşer.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "delta_gen.h"
+#include "delta_stream.h"
+
+#define DELTA_GEN_MIN_COPY		24u
+#define DELTA_GEN_HASH_LEN		8u
+#define DELTA_GEN_HASH_BITS		20u
+#define DELTA_GEN_MAX_CHAIN		64u
+
+typedef struct
+{
+	uint8_t 	*out;
+	size_t 		cap;
+	size_t 		len;
+	int 		overflow;
+}delta_gen_out_t;
+
+static uint32_t Delta_Gen_Hash(const uint8_t *p)
+{
+	uint64_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return (uint32_t)((v * 0x9E3779B97F4A7C15ull) >> (64u - DELTA_GEN_HASH_BITS));
+}
+
+static void Delta_Gen_Put(delta_gen_out_t *o, const uint8_t *p, size_t n)
+{
+	if ((o->overflow != 0) || ((o->len + n) > o->cap))
+	{
+		o->overflow = 1;
+		return;
+	}
+
+	memcpy(&o->out[o->len], p, n);
+	o->len += n;
+}
+
+static void Delta_Gen_PutHeader(delta_gen_out_t *o, uint8_t op, uint32_t len, uint32_t srcOffset)
+{
+	uint8_t h[9];
+
+	h[0] = op;
+	h[1] = (uint8_t)len;
+	h[2] = (uint8_t)(len >> 8);
+	h[3] = (uint8_t)(len >> 16);
+	h[4] = (uint8_t)(len >> 24);
+	h[5] = (uint8_t)srcOffset;
+	h[6] = (uint8_t)(srcOffset >> 8);
+	h[7] = (uint8_t)(srcOffset >> 16);
+	h[8] = (uint8_t)(srcOffset >> 24);
+
+	Delta_Gen_Put(o, h, (op == DELTA_OP_DATA) ? 5u : 9u);
+}
+
+/* new[a..b) boşluğu: hizalı eski byte'lar çoğunlukla aynıysa DIFF, değilse DATA */
+static void Delta_Gen_Gap(delta_gen_out_t *o, const uint8_t *oldImg, size_t oldLen,
+						  const uint8_t *newImg, size_t a, size_t b, long shift, delta_gen_stats_t *st)
+{
+	size_t 	len 	= b - a;
+	size_t 	same 	= 0;
+	long 	src 	= (long)a + shift;
+
+	if (len == 0u)
+	{
+		return;
+	}
+
+	if ((src >= 0) && ((size_t)src + len <= oldLen))
+	{
+		for (size_t i = 0; i < len; i++)
+		{
+			same += (oldImg[(size_t)src + i] == newImg[a + i]) ? 1u : 0u;
+		}
+	}
+
+	if ((len >= 4u) && ((same * 2u) >= len))
+	{
+		Delta_Gen_PutHeader(o, DELTA_OP_DIFF, (uint32_t)len, (uint32_t)src);
+
+		for (size_t i = 0; i < len; i++)
+		{
+			uint8_t d = (uint8_t)(newImg[a + i] - oldImg[(size_t)src + i]);
+			Delta_Gen_Put(o, &d, 1u);
+		}
+
+		st->diffCount += 1u;
+		st->diffBytes += (uint32_t)len;
+	}
+	else
+	{
+		Delta_Gen_PutHeader(o, DELTA_OP_DATA, (uint32_t)len, 0u);
+		Delta_Gen_Put(o, &newImg[a], len);
+
+		st->dataCount += 1u;
+		st->dataBytes += (uint32_t)len;
+	}
+}
+
+static size_t Delta_Gen_MatchLen(const uint8_t *oldImg, size_t oldLen, size_t src,
+								 const uint8_t *newImg, size_t newLen, size_t dst)
+{
+	size_t n = 0;
+
+	while (((src + n) < oldLen) && ((dst + n) < newLen) && (oldImg[src + n] == newImg[dst + n]))
+	{
+		n += 1u;
+	}
+
+	return n;
+}
+
+size_t Delta_Gen(const uint8_t *oldImg, size_t oldLen,
+				 const uint8_t *newImg, size_t newLen,
+				 uint8_t *out, size_t cap, delta_gen_stats_t *stats)
+{
+	delta_gen_stats_t 	localStats;
+	delta_gen_out_t 	o 		= { out, cap, 0u, 0 };
+	uint32_t 			*head 	= calloc((size_t)1u << DELTA_GEN_HASH_BITS, sizeof(uint32_t));
+	uint32_t 			*chain 	= calloc((oldLen != 0u) ? oldLen : 1u, sizeof(uint32_t));
+	size_t 				pos 	= 0;
+	size_t 				gap 	= 0;
+	long 				shift 	= 0;
+
+	if (stats == NULL)
+	{
+		stats = &localStats;
+	}
+
+	memset(stats, 0, sizeof(*stats));
+
+	if ((head == NULL) || (chain == NULL))
+	{
+		free(head);
+		free(chain);
+		return 0;
+	}
+
+	/* Eski imajın her konumu 8 byte'lık hash zincirine (pozisyon + 1, 0: boş) */
+	for (size_t i = 0; (i + DELTA_GEN_HASH_LEN) <= oldLen; i++)
+	{
+		uint32_t h = Delta_Gen_Hash(&oldImg[i]);
+
+		chain[i] = head[h];
+		head[h]  = (uint32_t)(i + 1u);
+	}
+
+	while ((pos + DELTA_GEN_HASH_LEN) <= newLen)
+	{
+		size_t 	 bestLen 	= 0;
+		size_t 	 bestSrc 	= 0;
+		long 	 predicted 	= (long)pos + shift;
+		uint32_t cand 		= head[Delta_Gen_Hash(&newImg[pos])];
+
+		/* Önce son kaydırmayla hizalı konum: kod bloklarında en olası devam */
+		if ((predicted >= 0) && ((size_t)predicted < oldLen))
+		{
+			bestLen = Delta_Gen_MatchLen(oldImg, oldLen, (size_t)predicted, newImg, newLen, pos);
+			bestSrc = (size_t)predicted;
+		}
+
+		for (uint32_t steps = 0; (cand != 0u) && (steps < DELTA_GEN_MAX_CHAIN); steps++)
+		{
+			size_t n = Delta_Gen_MatchLen(oldImg, oldLen, cand - 1u, newImg, newLen, pos);
+
+			if (n > bestLen)
+			{
+				bestLen = n;
+				bestSrc = cand - 1u;
+			}
+
+			cand = chain[cand - 1u];
+		}
+
+		if (bestLen < DELTA_GEN_MIN_COPY)
+		{
+			pos += 1u;
+			continue;
+		}
+
+		Delta_Gen_Gap(&o, oldImg, oldLen, newImg, gap, pos, shift, stats);
+
+		Delta_Gen_PutHeader(&o, DELTA_OP_COPY, (uint32_t)bestLen, (uint32_t)bestSrc);
+
+		stats->copyCount += 1u;
+		stats->copyBytes += (uint32_t)bestLen;
+
+		shift 	= (long)bestSrc - (long)pos;
+		pos 	+= bestLen;
+		gap 	 = pos;
+	}
+
+	Delta_Gen_Gap(&o, oldImg, oldLen, newImg, gap, newLen, shift, stats);
+
+	free(head);
+	free(chain);
+
+	return (o.overflow != 0) ? 0u : o.len;
+}
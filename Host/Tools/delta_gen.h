@@ -0,0 +1,36 @@
+/*
+ * delta_gen.h
+ *
+ * Host tarafı patch üretici: eski imajdan (cihazın aktif slotu) yeni imaja
+ * geçişi bootloader'daki delta_stream formatında (fw_format = DELTA) yazar.
+ * Kayıt formatı için Core/Bootloader_Drivers/Delta_Driver/Inc/delta_stream.h.
+ */
+
+#ifndef HOST_DELTA_GEN_H_
+#define HOST_DELTA_GEN_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+typedef struct
+{
+	uint32_t copyCount;
+	uint32_t copyBytes;
+	uint32_t diffCount;
+	uint32_t diffBytes;
+	uint32_t dataCount;
+	uint32_t dataBytes;
+}delta_gen_stats_t;
+
+/* Patch için yeterli çıktı boyutu (en kötü durum tamamı DATA, + kayıt başlıkları) */
+#define DELTA_GEN_BOUND(newLen)		((newLen) + ((newLen) / 4u) + 16u)
+
+/*
+ * oldImg -> newImg patch'ini out'a yazar.
+ * return: patch boyutu, out yetmezse 0
+ */
+size_t Delta_Gen(const uint8_t *oldImg, size_t oldLen,
+				 const uint8_t *newImg, size_t newLen,
+				 uint8_t *out, size_t cap, delta_gen_stats_t *stats);
+
+#endif /* HOST_DELTA_GEN_H_ */
@@ -0,0 +1,101 @@
+/*
+ * delta_gen_main.c
+ *
+ * Patch üretici komut satırı aracı:
+ *
+ *   delta_gen <eski.bin> <yeni.bin> <patch.bin>
+ *
+ * PACKET_INFO için gereken alanları da yazdırır: patch boyutu (fw_size), yazılacak
+ * yeni imajın CRC32'si (fw_crc32) ve boyutu (image_size), cihazdaki aktif imajın
+ * CRC32'si (base_crc32).
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "delta_gen.h"
+#include "crc.h"
+
+static uint8_t *Delta_Gen_ReadFile(const char *path, size_t *len)
+{
+	FILE 	*f = fopen(path, "rb");
+	uint8_t *buf;
+	long 	n;
+
+	if (f == NULL)
+	{
+		return NULL;
+	}
+
+	fseek(f, 0, SEEK_END);
+	n = ftell(f);
+	fseek(f, 0, SEEK_SET);
+
+	buf = malloc((n > 0) ? (size_t)n : 1u);
+
+	if ((buf != NULL) && (fread(buf, 1, (size_t)n, f) != (size_t)n))
+	{
+		free(buf);
+		buf = NULL;
+	}
+
+	fclose(f);
+	*len = (size_t)n;
+
+	return buf;
+}
+
+int main(int argc, char **argv)
+{
+	delta_gen_stats_t 	st;
+	size_t 				oldLen;
+	size_t 				newLen;
+	size_t 				patchLen;
+	uint8_t 			*oldImg;
+	uint8_t 			*newImg;
+	uint8_t 			*patch;
+	FILE 				*f;
+
+	if (argc != 4)
+	{
+		fprintf(stderr, "usage: %s <old.bin> <new.bin> <patch.bin>\n", argv[0]);
+		return 2;
+	}
+
+	oldImg = Delta_Gen_ReadFile(argv[1], &oldLen);
+	newImg = Delta_Gen_ReadFile(argv[2], &newLen);
+
+	if ((oldImg == NULL) || (newImg == NULL))
+	{
+		fprintf(stderr, "cannot read input images\n");
+		return 1;
+	}
+
+	patch 	 = malloc(DELTA_GEN_BOUND(newLen));
+	patchLen = (patch != NULL) ? Delta_Gen(oldImg, oldLen, newImg, newLen, patch, DELTA_GEN_BOUND(newLen), &st) : 0u;
+
+	if ((patchLen == 0u) && (newLen != 0u))
+	{
+		fprintf(stderr, "patch generation failed\n");
+		return 1;
+	}
+
+	f = fopen(argv[3], "wb");
+
+	if ((f == NULL) || (fwrite(patch, 1, patchLen, f) != patchLen))
+	{
+		fprintf(stderr, "cannot write %s\n", argv[3]);
+		return 1;
+	}
+
+	fclose(f);
+
+	printf("fw_size    %zu\n", patchLen);
+	printf("fw_crc32   0x%08X\n", CRC32_Calculate(newImg, (uint32_t)newLen));
+	printf("image_size %zu\n", newLen);
+	printf("base_crc32 0x%08X\n", CRC32_Calculate(oldImg, (uint32_t)oldLen));
+	printf("records    COPY %u (%u B)  DIFF %u (%u B)  DATA %u (%u B)\n",
+		   st.copyCount, st.copyBytes, st.diffCount, st.diffBytes, st.dataCount, st.dataBytes);
+
+	return 0;
+}
@@ -0,0 +1,50 @@
+#!/usr/bin/env python3
+"""
+ELF32 imajın yüklenen segmentlerini 'objcopy -O binary' gibi düz .bin'e çevirir.
+
+Host'taki binutils ARM ELF tanımadığı için testler örnek firmware'i
+(Debug/*.elf) bu araçla .bin'e çevirir. Segmentler en düşük fiziksel
+adresten başlayarak yerleştirilir, aradaki boşluklar 0xFF ile doldurulur.
+
+    elf2bin.py <girdi.elf> <çıktı.bin>
+"""
+
+import struct
+import sys
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit("usage: elf2bin.py <in.elf> <out.bin>")
+
+    with open(sys.argv[1], "rb") as f:
+        elf = f.read()
+
+    if elf[:4] != b"\x7fELF" or elf[4] != 1 or elf[5] != 1:
+        sys.exit("not a little-endian ELF32 file")
+
+    phoff, = struct.unpack_from("<I", elf, 0x1C)
+    phentsize, phnum = struct.unpack_from("<HH", elf, 0x2A)
+
+    segments = []
+    for i in range(phnum):
+        p_type, p_offset, _, p_paddr, p_filesz = struct.unpack_from("<IIIII", elf, phoff + i * phentsize)
+        if p_type == 1 and p_filesz > 0:
+            segments.append((p_paddr, elf[p_offset:p_offset + p_filesz]))
+
+    if not segments:
+        sys.exit("no loadable segments")
+
+    base = min(addr for addr, _ in segments)
+    end = max(addr + len(data) for addr, data in segments)
+    image = bytearray(b"\xff" * (end - base))
+
+    for addr, data in segments:
+        image[addr - base:addr - base + len(data)] = data
+
+    with open(sys.argv[2], "wb") as f:
+        f.write(image)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,141 @@
+/*
+ * lz4_block.c
+ *
+ * Hash tablolu, açgözlü LZ4 block sıkıştırıcı. Block formatının kuralları
+ * uygulanır: son 5 byte her zaman literal, son eşleşme block sonundan en az
+ * 12 byte önce başlar, offset 1..65535.
+ */
+
+#include <string.h>
+
+#include "lz4_block.h"
+
+#define LZ4_HASH_BITS		16u
+#define LZ4_MIN_MATCH		4u
+#define LZ4_LAST_LITERALS	5u
+#define LZ4_MF_LIMIT		12u
+#define LZ4_MAX_OFFSET		65535u
+
+static uint32_t LZ4_Block_Read32(const uint8_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static uint32_t LZ4_Block_Hash(uint32_t v)
+{
+	return (v * 2654435761u) >> (32u - LZ4_HASH_BITS);
+}
+
+/* 15 ve üzeri uzunlukların 255'li uzatma byte'ları */
+static uint8_t *LZ4_Block_PutLength(uint8_t *op, size_t n)
+{
+	while (n >= 255u)
+	{
+		*op++ 	= 255u;
+		n 	   -= 255u;
+	}
+
+	*op++ = (uint8_t)n;
+	return op;
+}
+
+/* Literal'ler ve (varsa) eşleşme: bir LZ4 dizisi */
+static uint8_t *LZ4_Block_PutSequence(uint8_t *op, const uint8_t *lit, size_t litLen, size_t offset, size_t matchLen)
+{
+	uint8_t *token = op++;
+	size_t 	 ml 	= (matchLen != 0u) ? (matchLen - LZ4_MIN_MATCH) : 0u;
+
+	*token = (uint8_t)(((litLen >= 15u) ? 15u : litLen) << 4);
+
+	if (litLen >= 15u)
+	{
+		op = LZ4_Block_PutLength(op, litLen - 15u);
+	}
+
+	memcpy(op, lit, litLen);
+	op += litLen;
+
+	if (matchLen == 0u)
+	{
+		return op;
+	}
+
+	*op++ = (uint8_t)offset;
+	*op++ = (uint8_t)(offset >> 8);
+
+	*token |= (uint8_t)((ml >= 15u) ? 15u : ml);
+
+	if (ml >= 15u)
+	{
+		op = LZ4_Block_PutLength(op, ml - 15u);
+	}
+
+	return op;
+}
+
+size_t LZ4_Block_Compress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap)
+{
+	static uint32_t table[1u << LZ4_HASH_BITS];
+	uint8_t 		*op 		= dst;
+	size_t 			anchor 		= 0;
+	size_t 			ip 			= 0;
+	size_t 			matchLimit 	= (len > LZ4_LAST_LITERALS) ? (len - LZ4_LAST_LITERALS) : 0u;
+	size_t 			mfLimit 	= (len > LZ4_MF_LIMIT) ? (len - LZ4_MF_LIMIT) : 0u;
+
+	if (cap < LZ4_BLOCK_BOUND(len))
+	{
+		return 0;
+	}
+
+	/* Tablo pozisyon + 1 tutar, 0: boş */
+	memset(table, 0, sizeof(table));
+
+	while (ip < mfLimit)
+	{
+		uint32_t h 		= LZ4_Block_Hash(LZ4_Block_Read32(&src[ip]));
+		size_t 	 ref 	= table[h];
+		size_t 	 matchLen;
+
+		table[h] = (uint32_t)(ip + 1u);
+
+		if ((ref == 0u) || ((ip - (ref - 1u)) > LZ4_MAX_OFFSET) ||
+			(LZ4_Block_Read32(&src[ref - 1u]) != LZ4_Block_Read32(&src[ip])))
+		{
+			ip += 1u;
+			continue;
+		}
+
+		ref 	-= 1u;
+		matchLen = LZ4_MIN_MATCH;
+
+		while (((ip + matchLen) < matchLimit) && (src[ref + matchLen] == src[ip + matchLen]))
+		{
+			matchLen += 1u;
+		}
+
+		/* Geriye doğru uzat (literal'lerin sonundaki eşleşen byte'lar) */
+		while ((ip > anchor) && (ref > 0u) && (src[ip - 1u] == src[ref - 1u]))
+		{
+			ip 		 -= 1u;
+			ref 	 -= 1u;
+			matchLen += 1u;
+		}
+
+		op = LZ4_Block_PutSequence(op, &src[anchor], ip - anchor, ip - ref, matchLen);
+
+		ip 	  += matchLen;
+		anchor = ip;
+
+		if (ip >= 2u)
+		{
+			table[LZ4_Block_Hash(LZ4_Block_Read32(&src[ip - 2u]))] = (uint32_t)(ip - 1u);
+		}
+	}
+
+	op = LZ4_Block_PutSequence(op, &src[anchor], len - anchor, 0u, 0u);
+
+	return (size_t)(op - dst);
+}
@@ -0,0 +1,24 @@
+/*
+ * lz4_block.h
+ *
+ * Host tarafı LZ4 block sıkıştırıcı. Çıktı ham LZ4 block'tur (frame header,
+ * block boyutu ve checksum alanları yoktur); bootloader'daki lz4_stream bu
+ * formatı bekler (fw_format = LZ4).
+ */
+
+#ifndef HOST_LZ4_BLOCK_H_
+#define HOST_LZ4_BLOCK_H_
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* En kötü durumda (sıkıştırılamayan veri) gereken çıktı boyutu */
+#define LZ4_BLOCK_BOUND(n)		((n) + ((n) / 255u) + 16u)
+
+/*
+ * src[0..len) verisini tek bir LZ4 block olarak dst'ye sıkıştırır.
+ * return: üretilen byte sayısı, dst yetmezse 0
+ */
+size_t LZ4_Block_Compress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+
+#endif /* HOST_LZ4_BLOCK_H_ */